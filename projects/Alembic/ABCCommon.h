@@ -14,7 +14,7 @@ extern void traverseABC(
     bool read_done
 );
 
-extern Alembic::AbcGeom::IArchive readABC(std::string const &path);
+extern Alembic::AbcGeom::IArchive readABC(std::string const &path, int numStreams = 1, bool *concurrent = nullptr);
 
 extern std::shared_ptr<zeno::ListObject> get_xformed_prims(std::shared_ptr<zeno::ABCTree> abctree);
 
@@ -13,10 +13,14 @@
 #include <Alembic/AbcCoreOgawa/All.h>
 #include <Alembic/AbcCoreHDF5/All.h>
 #include <Alembic/Abc/ErrorHandler.h>
+#include <zeno/para/parallel_for.h>
 #include "ABCTree.h"
 #include <cstring>
 #include <cstdio>
 #include <filesystem>
+#include <future>
+#include <limits>
+#include <thread>
 
 using namespace Alembic::AbcGeom;
 
@@ -47,7 +51,8 @@ static void read_velocity(std::shared_ptr<PrimitiveObject> prim, V3fArraySampleP
     }
 }
 
-static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProperty arbattrs, const ISampleSelector &iSS, bool read_done) {
+// skipConstant leaves out the params that never change, for prims copied from an earlier sample
+static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProperty arbattrs, const ISampleSelector &iSS, bool read_done, bool skipConstant = false) {
     if (!arbattrs) {
         return;
     }
@@ -56,6 +61,9 @@ static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProp
         PropertyHeader p = arbattrs.getPropertyHeader(i);
         if (IFloatGeomParam::matches(p)) {
             IFloatGeomParam param(arbattrs, p.getName());
+            if (skipConstant && param.isConstant()) {
+                continue;
+            }
 
             IFloatGeomParam::Sample samp = param.getIndexedValue(iSS);
             std::vector<float> data;
@@ -87,6 +95,9 @@ static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProp
         }
         else if (IInt32GeomParam::matches(p)) {
             IInt32GeomParam param(arbattrs, p.getName());
+            if (skipConstant && param.isConstant()) {
+                continue;
+            }
 
             IInt32GeomParam::Sample samp = param.getIndexedValue(iSS);
             std::vector<int> data;
@@ -112,6 +123,9 @@ static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProp
         }
         else if (IV3fGeomParam::matches(p)) {
             IV3fGeomParam param(arbattrs, p.getName());
+            if (skipConstant && param.isConstant()) {
+                continue;
+            }
             if (!read_done) {
                 log_info("[alembic] vec3f attr {}.", p.getName());
             }
@@ -129,6 +143,9 @@ static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProp
                 log_info("[alembic] IN3fGeomParam attr {}.", p.getName());
             }
             IN3fGeomParam param(arbattrs, p.getName());
+            if (skipConstant && param.isConstant()) {
+                continue;
+            }
             IN3fGeomParam::Sample samp = param.getIndexedValue(iSS);
             if (prim->verts.size() == samp.getVals()->size()) {
                 auto &attr = prim->add_attr<zeno::vec3f>(p.getName());
@@ -143,6 +160,9 @@ static void read_attributes(std::shared_ptr<PrimitiveObject> prim, ICompoundProp
                 log_info("[alembic] IC3fGeomParam attr {}.", p.getName());
             }
             IC3fGeomParam param(arbattrs, p.getName());
+            if (skipConstant && param.isConstant()) {
+                continue;
+            }
             IC3fGeomParam::Sample samp = param.getIndexedValue(iSS);
             if (prim->verts.size() == samp.getVals()->size()) {
                 auto &attr = prim->add_attr<zeno::vec3f>(p.getName());
@@ -217,7 +237,88 @@ static void read_user_data(std::shared_ptr<PrimitiveObject> prim, ICompoundPrope
     }
 }
 
-static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMeshSchema &mesh, int frameid, bool read_done) {
+static void read_normals(std::shared_ptr<PrimitiveObject> prim, IN3fGeomParam nrm, const ISampleSelector &iSS) {
+    auto nrmsamp = nrm.getIndexedValue(iSS);
+    int value_size = (int)nrmsamp.getVals()->size();
+    if (value_size == prim->verts.size()) {
+        auto &nrms = prim->verts.add_attr<vec3f>("nrm");
+        auto marr = nrmsamp.getVals();
+        for (size_t i = 0; i < marr->size(); i++) {
+            auto const &n = (*marr)[i];
+            nrms[i] = {n[0], n[1], n[2]};
+        }
+    }
+}
+
+// the last sample decoded for one object, kept by the cached mode of ReadAlembic
+struct ABCObjectCache {
+    std::shared_ptr<PrimitiveObject> prim;
+    int sampleIndex = -1;
+};
+
+// the same sample again reuses the whole prim; meshes whose topology and uvs
+// do not change keep faces, uvs and constant attrs from the last sample, and
+// only read back the properties that are animated. callers only ever get
+// copies of the cached prim (see storeABCSample), so it is updated in place
+// unless a prefetch still shares it
+template <class Schema>
+static std::shared_ptr<PrimitiveObject> reuseABCSample(Schema &schema, int sample_index, ABCObjectCache *cache, bool read_done) {
+    if (!cache || !cache->prim) {
+        return nullptr;
+    }
+    if (cache->sampleIndex == sample_index) {
+        return cache->prim;
+    }
+    if constexpr (std::is_same_v<Schema, IPolyMeshSchema> || std::is_same_v<Schema, ISubDSchema>) {
+        if (schema.getTopologyVariance() == kHeterogenousTopology) {
+            return nullptr;
+        }
+        if (auto uv = schema.getUVsParam(); uv && !uv.isConstant()) {
+            return nullptr;
+        }
+        ISampleSelector iSS((Alembic::AbcCoreAbstract::index_t)sample_index);
+        auto prim = cache->prim.use_count() > 1 ? std::make_shared<PrimitiveObject>(*cache->prim) : cache->prim;
+        // no longer the old sample, should reading fail half way
+        cache->sampleIndex = -1;
+        if (auto pos = schema.getPositionsProperty(); !pos.isConstant()) {
+            auto marr = pos.getValue(iSS);
+            if (!marr || marr->size() != prim->verts.size()) {
+                return nullptr;
+            }
+            for (size_t i = 0; i < marr->size(); i++) {
+                auto const &val = (*marr)[i];
+                prim->verts[i] = {val[0], val[1], val[2]};
+            }
+        }
+        if (auto vel = schema.getVelocitiesProperty(); vel.valid() && !vel.isConstant()) {
+            read_velocity(prim, vel.getValue(iSS), read_done);
+        }
+        if constexpr (std::is_same_v<Schema, IPolyMeshSchema>) {
+            if (auto nrm = schema.getNormalsParam(); nrm && !nrm.isConstant()) {
+                read_normals(prim, nrm, iSS);
+            }
+        }
+        read_attributes(prim, schema.getArbGeomParams(), iSS, read_done, true);
+        read_user_data(prim, schema.getUserProperties(), iSS, read_done);
+        return prim;
+    }
+    return nullptr;
+}
+
+// the cache keeps the prim, the caller gets a copy sharing its attribute arrays
+static std::shared_ptr<PrimitiveObject> storeABCSample(std::shared_ptr<PrimitiveObject> prim, int sample_index, ABCObjectCache *cache) {
+    if (!cache) {
+        return prim;
+    }
+    // the arrays were just written, sealed ones are shared with the copy
+    // instead of duplicated, and unshared again once either side writes
+    prim->seal();
+    cache->prim = prim;
+    cache->sampleIndex = sample_index;
+    return std::make_shared<PrimitiveObject>(*prim);
+}
+
+static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMeshSchema &mesh, int frameid, bool read_done, ABCObjectCache *cache = nullptr) {
     auto prim = std::make_shared<PrimitiveObject>();
 
     std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = mesh.getTimeSampling();
@@ -226,6 +327,9 @@ static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMesh
     int start_frame = (int)std::round(start / time_per_cycle );
 
     int sample_index = clamp(frameid - start_frame, 0, (int)mesh.getNumSamples() - 1);
+    if (auto reused = reuseABCSample(mesh, sample_index, cache, read_done)) {
+        return storeABCSample(reused, sample_index, cache);
+    }
     ISampleSelector iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
     Alembic::AbcGeom::IPolyMeshSchema::Sample mesamp = mesh.getValue(iSS);
 
@@ -242,17 +346,7 @@ static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMesh
 
     read_velocity(prim, mesamp.getVelocities(), read_done);
     if (auto nrm = mesh.getNormalsParam()) {
-        auto nrmsamp =
-                nrm.getIndexedValue(Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index));
-        int value_size = (int)nrmsamp.getVals()->size();
-        if (value_size == prim->verts.size()) {
-            auto &nrms = prim->verts.add_attr<vec3f>("nrm");
-            auto marr = nrmsamp.getVals();
-            for (size_t i = 0; i < marr->size(); i++) {
-                auto const &n = (*marr)[i];
-                nrms[i] = {n[0], n[1], n[2]};
-            }
-        }
+        read_normals(prim, nrm, iSS);
     }
 
     if (auto marr = mesamp.getFaceIndices()) {
@@ -332,10 +426,10 @@ static std::shared_ptr<PrimitiveObject> foundABCMesh(Alembic::AbcGeom::IPolyMesh
     ICompoundProperty usrData = mesh.getUserProperties();
     read_user_data(prim, usrData, iSS, read_done);
 
-    return prim;
+    return storeABCSample(prim, sample_index, cache);
 }
 
-static std::shared_ptr<PrimitiveObject> foundABCSubd(Alembic::AbcGeom::ISubDSchema &subd, int frameid, bool read_done) {
+static std::shared_ptr<PrimitiveObject> foundABCSubd(Alembic::AbcGeom::ISubDSchema &subd, int frameid, bool read_done, ABCObjectCache *cache = nullptr) {
     auto prim = std::make_shared<PrimitiveObject>();
 
     std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = subd.getTimeSampling();
@@ -344,6 +438,9 @@ static std::shared_ptr<PrimitiveObject> foundABCSubd(Alembic::AbcGeom::ISubDSche
     int start_frame = (int)std::round(start / time_per_cycle );
 
     int sample_index = clamp(frameid - start_frame, 0, (int)subd.getNumSamples() - 1);
+    if (auto reused = reuseABCSample(subd, sample_index, cache, read_done)) {
+        return storeABCSample(reused, sample_index, cache);
+    }
     ISampleSelector iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
     Alembic::AbcGeom::ISubDSchema::Sample mesamp = subd.getValue(iSS);
 
@@ -437,7 +534,7 @@ static std::shared_ptr<PrimitiveObject> foundABCSubd(Alembic::AbcGeom::ISubDSche
     ICompoundProperty usrData = subd.getUserProperties();
     read_user_data(prim, usrData, iSS, read_done);
 
-    return prim;
+    return storeABCSample(prim, sample_index, cache);
 }
 
 static std::shared_ptr<CameraInfo> foundABCCamera(Alembic::AbcGeom::ICameraSchema &cam, int frameid) {
@@ -474,7 +571,7 @@ static Alembic::Abc::v12::M44d foundABCXform(Alembic::AbcGeom::IXformSchema &xfm
     return samp.getMatrix();
 }
 
-static std::shared_ptr<PrimitiveObject> foundABCPoints(Alembic::AbcGeom::IPointsSchema &mesh, int frameid, bool read_done) {
+static std::shared_ptr<PrimitiveObject> foundABCPoints(Alembic::AbcGeom::IPointsSchema &mesh, int frameid, bool read_done, ABCObjectCache *cache = nullptr) {
     auto prim = std::make_shared<PrimitiveObject>();
 
     std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = mesh.getTimeSampling();
@@ -483,6 +580,9 @@ static std::shared_ptr<PrimitiveObject> foundABCPoints(Alembic::AbcGeom::IPoints
     int start_frame = (int)std::round(start / time_per_cycle );
 
     int sample_index = clamp(frameid - start_frame, 0, (int)mesh.getNumSamples() - 1);
+    if (auto reused = reuseABCSample(mesh, sample_index, cache, read_done)) {
+        return storeABCSample(reused, sample_index, cache);
+    }
     auto iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
     Alembic::AbcGeom::IPointsSchema::Sample mesamp = mesh.getValue(iSS);
     if (auto marr = mesamp.getPositions()) {
@@ -500,10 +600,10 @@ static std::shared_ptr<PrimitiveObject> foundABCPoints(Alembic::AbcGeom::IPoints
     read_attributes(prim, arbattrs, iSS, read_done);
     ICompoundProperty usrData = mesh.getUserProperties();
     read_user_data(prim, usrData, iSS, read_done);
-    return prim;
+    return storeABCSample(prim, sample_index, cache);
 }
 
-static std::shared_ptr<PrimitiveObject> foundABCCurves(Alembic::AbcGeom::ICurvesSchema &mesh, int frameid, bool read_done) {
+static std::shared_ptr<PrimitiveObject> foundABCCurves(Alembic::AbcGeom::ICurvesSchema &mesh, int frameid, bool read_done, ABCObjectCache *cache = nullptr) {
     auto prim = std::make_shared<PrimitiveObject>();
 
     std::shared_ptr<Alembic::AbcCoreAbstract::v12::TimeSampling> time = mesh.getTimeSampling();
@@ -512,6 +612,9 @@ static std::shared_ptr<PrimitiveObject> foundABCCurves(Alembic::AbcGeom::ICurves
     int start_frame = (int)std::round(start / time_per_cycle );
 
     int sample_index = clamp(frameid - start_frame, 0, (int)mesh.getNumSamples() - 1);
+    if (auto reused = reuseABCSample(mesh, sample_index, cache, read_done)) {
+        return storeABCSample(reused, sample_index, cache);
+    }
     auto iSS = Alembic::Abc::v12::ISampleSelector((Alembic::AbcCoreAbstract::index_t)sample_index);
     Alembic::AbcGeom::ICurvesSchema::Sample mesamp = mesh.getValue(iSS);
     if (auto marr = mesamp.getPositions()) {
@@ -541,14 +644,16 @@ static std::shared_ptr<PrimitiveObject> foundABCCurves(Alembic::AbcGeom::ICurves
     read_attributes(prim, arbattrs, iSS, read_done);
     ICompoundProperty usrData = mesh.getUserProperties();
     read_user_data(prim, usrData, iSS, read_done);
-    return prim;
+    return storeABCSample(prim, sample_index, cache);
 }
 
-void traverseABC(
+// decode the sample of obj itself, children are left to the caller
+static void readABCObject(
     Alembic::AbcGeom::IObject &obj,
     ABCTree &tree,
     int frameid,
-    bool read_done
+    bool read_done,
+    ABCObjectCache *cache
 ) {
     {
         auto const &md = obj.getMetaData();
@@ -564,7 +669,7 @@ void traverseABC(
 
             Alembic::AbcGeom::IPolyMesh meshy(obj);
             auto &mesh = meshy.getSchema();
-            tree.prim = foundABCMesh(mesh, frameid, read_done);
+            tree.prim = foundABCMesh(mesh, frameid, read_done, cache);
             tree.prim->userData().set2("_abc_name", obj.getName());
         } else if (Alembic::AbcGeom::IXformSchema::matches(md)) {
             if (!read_done) {
@@ -586,7 +691,7 @@ void traverseABC(
             }
             Alembic::AbcGeom::IPoints points(obj);
             auto &points_sch = points.getSchema();
-            tree.prim = foundABCPoints(points_sch, frameid, read_done);
+            tree.prim = foundABCPoints(points_sch, frameid, read_done, cache);
             tree.prim->userData().set2("_abc_name", obj.getName());
         } else if(Alembic::AbcGeom::ICurvesSchema::matches(md)) {
             if (!read_done) {
@@ -594,7 +699,7 @@ void traverseABC(
             }
             Alembic::AbcGeom::ICurves curves(obj);
             auto &curves_sch = curves.getSchema();
-            tree.prim = foundABCCurves(curves_sch, frameid, read_done);
+            tree.prim = foundABCCurves(curves_sch, frameid, read_done, cache);
             tree.prim->userData().set2("_abc_name", obj.getName());
         } else if (Alembic::AbcGeom::ISubDSchema::matches(md)) {
             if (!read_done) {
@@ -602,10 +707,19 @@ void traverseABC(
             }
             Alembic::AbcGeom::ISubD subd(obj);
             auto &subd_sch = subd.getSchema();
-            tree.prim = foundABCSubd(subd_sch, frameid, read_done);
+            tree.prim = foundABCSubd(subd_sch, frameid, read_done, cache);
             tree.prim->userData().set2("_abc_name", obj.getName());
         }
     }
+}
+
+void traverseABC(
+    Alembic::AbcGeom::IObject &obj,
+    ABCTree &tree,
+    int frameid,
+    bool read_done
+) {
+    readABCObject(obj, tree, frameid, read_done, nullptr);
 
     size_t nch = obj.getNumChildren();
     if (!read_done) {
@@ -626,7 +740,9 @@ void traverseABC(
     }
 }
 
-Alembic::AbcGeom::IArchive readABC(std::string const &path) {
+// numStreams > 1 lets an Ogawa archive be read from several threads at once,
+// concurrent tells whether that is the case (HDF5 archives never are)
+Alembic::AbcGeom::IArchive readABC(std::string const &path, int numStreams, bool *concurrent) {
     std::string native_path = std::filesystem::u8path(path).string();
     std::string hdr;
     {
@@ -641,19 +757,99 @@ Alembic::AbcGeom::IArchive readABC(std::string const &path) {
     }
     if (hdr == "\x89HDF") {
         log_info("[alembic] opening as HDF5 format");
+        if (concurrent) {
+            *concurrent = false;
+        }
         return {Alembic::AbcCoreHDF5::ReadArchive(), native_path};
     } else if (hdr == "Ogaw") {
         log_info("[alembic] opening as Ogawa format");
-        return {Alembic::AbcCoreOgawa::ReadArchive(), native_path};
+        if (concurrent) {
+            *concurrent = numStreams > 1;
+        }
+        return {Alembic::AbcCoreOgawa::ReadArchive(std::max(numStreams, 1)), native_path};
     } else {
         throw Exception("[alembic] unrecognized ABC header: [" + hdr + "]");
     }
 }
 
+// the hierarchy of an archive, flattened once so that the objects of a frame
+// can be decoded in parallel and keep their samples between frames
+struct ABCCachedReader {
+    struct Entry {
+        Alembic::AbcGeom::IObject obj;
+        int parent;
+        ABCObjectCache cache;
+        ABCObjectCache pending;  // filled by a prefetch, until it is used or dropped
+    };
+    std::vector<Entry> entries;
+    bool concurrent = false;
+
+    void open(Alembic::AbcGeom::IArchive &archive, bool concurrent_) {
+        entries.clear();
+        concurrent = concurrent_;
+        addObject(archive.getTop(), -1);
+    }
+
+    void addObject(Alembic::AbcGeom::IObject const &obj, int parent) {
+        int id = entries.size();
+        entries.push_back({obj, parent});
+        for (size_t i = 0; i < obj.getNumChildren(); i++) {
+            addObject(Alembic::AbcGeom::IObject(obj, obj.getChildHeader(i).getName()), id);
+        }
+    }
+
+    // a prefetch starts from the samples of the current frame but leaves them
+    // alone, so that seeking elsewhere still reuses the current frame
+    std::shared_ptr<ABCTree> read(int frameid, bool read_done, bool prefetch = false) {
+        std::vector<std::shared_ptr<ABCTree>> trees(entries.size());
+        auto readOne = [&] (size_t i) {
+            auto &ent = entries[i];
+            if (prefetch) {
+                ent.pending = ent.cache;
+            }
+            trees[i] = std::make_shared<ABCTree>();
+            readABCObject(ent.obj, *trees[i], frameid, read_done, prefetch ? &ent.pending : &ent.cache);
+        };
+        if (concurrent) {
+            parallel_for(entries.size(), readOne);
+        } else {
+            for (size_t i = 0; i < entries.size(); i++) {
+                readOne(i);
+            }
+        }
+        // entries are in depth first order, so the children keep their order
+        for (size_t i = 1; i < entries.size(); i++) {
+            trees[entries[i].parent]->children.push_back(trees[i]);
+        }
+        return trees[0];
+    }
+
+    void commitPrefetch() {
+        for (auto &ent: entries) {
+            ent.cache = std::move(ent.pending);
+            ent.pending = {};
+        }
+    }
+
+    void dropPrefetch() {
+        for (auto &ent: entries) {
+            ent.pending = {};
+        }
+    }
+};
+
 struct ReadAlembic : INode {
     Alembic::Abc::v12::IArchive archive;
     std::string usedPath;
     bool read_done = false;
+    bool concurrent = false;
+    ABCCachedReader reader;
+    // next frame decoded in the background, declared last so that it is
+    // waited for before the archive and the reader go away
+    std::future<std::shared_ptr<ABCTree>> prefetched;
+    int prefetchedFrame = -1;
+    int lastFrame = std::numeric_limits<int>::min();
+
     virtual void apply() override {
         int frameid;
         if (has_input("frameid")) {
@@ -661,23 +857,58 @@ struct ReadAlembic : INode {
         } else {
             frameid = getGlobalState()->frameid;
         }
-        auto abctree = std::make_shared<ABCTree>();
+        std::shared_ptr<ABCTree> abctree;
         {
             auto path = get_input<StringObject>("path")->get();
+            // never touch the archive while the prefetch is still reading it
+            if (prefetched.valid()) {
+                try {
+                    auto tree = prefetched.get();
+                    if (prefetchedFrame == frameid && usedPath == path) {
+                        abctree = std::move(tree);
+                        reader.commitPrefetch();
+                    }
+                } catch (...) {
+                    // errors are reported when the frame is read for real
+                }
+                reader.dropPrefetch();
+            }
             if (usedPath != path) {
                 read_done = false;
             }
             if (read_done == false) {
-                archive = readABC(path);
+                archive = readABC(path, std::thread::hardware_concurrency(), &concurrent);
+                reader.entries.clear();
             }
             double start, _end;
             GetArchiveStartAndEndTime(archive, start, _end);
             // fmt::print("GetArchiveStartAndEndTime: {}\n", start);
             // fmt::print("archive.getNumTimeSamplings: {}\n", archive.getNumTimeSamplings());
-            auto obj = archive.getTop();
-            traverseABC(obj, *abctree, frameid, read_done);
+            if (get_input2<bool>("cached")) {
+                if (reader.entries.empty()) {
+                    reader.open(archive, concurrent);
+                }
+                if (!abctree) {
+                    abctree = reader.read(frameid, read_done);
+                }
+                // only while playing forward: an unchanged frame, or one coming
+                // from the frameid input, says nothing about the next one. and only
+                // for Ogawa archives with several streams, HDF5 is not thread safe
+                // and a single stream would just be held by the prefetch
+                if (concurrent && !has_input("frameid") && frameid == lastFrame + 1) {
+                    prefetchedFrame = frameid + 1;
+                    prefetched = std::async(std::launch::async, [this, frame = prefetchedFrame] {
+                        return reader.read(frame, true, true);
+                    });
+                }
+            } else {
+                abctree = std::make_shared<ABCTree>();
+                auto obj = archive.getTop();
+                traverseABC(obj, *abctree, frameid, read_done);
+            }
             read_done = true;
             usedPath = path;
+            lastFrame = frameid;
         }
         set_output("abctree", std::move(abctree));
     }
@@ -687,6 +918,7 @@ ZENDEFNODE(ReadAlembic, {
     {
         {"readpath", "path"},
         {"frameid"},
+        {"bool", "cached", "0"},
     },
     {{"ABCTree", "abctree"}},
     {},
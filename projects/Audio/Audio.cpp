@@ -10,8 +10,15 @@
 #include "aquila/aquila/aquila.h"
 #include <deque>
 #include <zeno/types/ListObject.h>
+#include <zeno/para/parallel_for.h>
+#include <zeno/utils/envconfig.h>
 #include "AudioFile.h"
 #include<algorithm>
+#include <complex>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <mutex>
 
 #define MINIMP3_IMPLEMENTATION
 #define MINIMP3_FLOAT_OUTPUT
@@ -53,7 +60,7 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     // read the data:
     auto data = std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
-    static mp3dec_t mp3d;
+    mp3dec_t mp3d;
     mp3dec_init(&mp3d);
 
     mp3dec_frame_info_t info;
@@ -89,6 +96,258 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     return std::move(result);
 }
 
+// decoded tracks are kept by path, and decoded again once the file changes
+static std::string fileStamp(std::string const &path) {
+    std::error_code ec;
+    auto fspath = std::filesystem::u8path(path);
+    auto mtime = std::filesystem::last_write_time(fspath, ec).time_since_epoch().count();
+    auto size = ec ? 0 : std::filesystem::file_size(fspath, ec);
+    return std::to_string(mtime) + ':' + std::to_string(size);
+}
+
+// decoded data by key, dropping the least recently used entries once the total
+// size passes ZENO_AUDIO_CACHE_MB (default 512) megabytes; an entry is decoded
+// again once the file changes
+template <class T>
+struct AudioCache {
+    struct Entry {
+        std::string stamp;
+        std::shared_ptr<T const> data;
+        std::size_t bytes = 0;
+        typename std::list<std::string>::iterator lru;
+    };
+
+    std::mutex mtx;
+    std::map<std::string, Entry> entries;
+    std::list<std::string> lru;  // most recently used first
+    std::size_t bytes = 0;
+
+    static std::size_t budget() {
+        static std::size_t mb = std::max(zeno::envconfig::getInt("AUDIO_CACHE_MB", 512), 0);
+        return mb << 20;
+    }
+
+    std::shared_ptr<T const> get(std::string const &key, std::string const &stamp) {
+        std::lock_guard lck(mtx);
+        auto it = entries.find(key);
+        if (it == entries.end() || it->second.stamp != stamp)
+            return nullptr;
+        lru.splice(lru.begin(), lru, it->second.lru);
+        return it->second.data;
+    }
+
+    void put(std::string const &key, std::string const &stamp, std::shared_ptr<T const> data, std::size_t size) {
+        std::lock_guard lck(mtx);
+        if (auto it = entries.find(key); it != entries.end()) {
+            bytes -= it->second.bytes;
+            lru.erase(it->second.lru);
+            entries.erase(it);
+        }
+        lru.push_front(key);
+        entries[key] = {stamp, std::move(data), size, lru.begin()};
+        bytes += size;
+        // the newest entry stays even if it alone exceeds the budget
+        while (bytes > budget() && lru.size() > 1) {
+            auto it = entries.find(lru.back());
+            bytes -= it->second.bytes;
+            entries.erase(it);
+            lru.pop_back();
+        }
+    }
+};
+
+static std::shared_ptr<PrimitiveObject const> readAudioCached(std::string const &path) {
+    static AudioCache<PrimitiveObject> cache;
+    auto stamp = fileStamp(path);
+    if (auto wave = cache.get(path, stamp))
+        return wave;
+    auto lower_path = path;
+    transform(lower_path.begin(), lower_path.end(), lower_path.begin(), ::tolower);
+    zeno::log_debug("{} -> {}", path, lower_path);
+    auto *pFile = strrchr(lower_path.c_str(),'.');
+    std::shared_ptr<PrimitiveObject> result;
+    if (pFile != NULL) {
+        if (strcmp(pFile, ".wav") == 0) {
+            zeno::log_debug("is wave");
+            result = zeno::readWav(path);
+        } else if (strcmp(pFile, ".mp3") == 0) {
+            zeno::log_debug("is mp3");
+            result = zeno::readMp3(path);
+        }
+    }
+    if (!result)
+        return nullptr;
+    // the cached track is shared with every ReadAudioFile output, nothing may
+    // write to it anymore; sealed arrays are shared by copies instead of duplicated
+    result->seal();
+    std::size_t size = result->verts.size() * sizeof(vec3f);
+    result->verts.foreach_attr([&] (auto const &key, auto const &arr) {
+        size += arr.size() * sizeof(arr[0]);
+    });
+    cache.put(path, stamp, result, size);
+    return result;
+}
+
+struct SpectrogramParams {
+    int windowSize = 1024;
+    int hop = 1024;
+    bool preEmphasis = false;
+    float preEmphasisAlpha = 0.97f;
+    bool hammingWindow = true;
+    int melCount = 15;
+    float rangePerFilter = 1;
+
+    std::string key() const {
+        return std::to_string(windowSize) + ':' + std::to_string(hop) + ':' + std::to_string(preEmphasis) + ':'
+            + std::to_string(preEmphasisAlpha) + ':' + std::to_string(hammingWindow) + ':'
+            + std::to_string(melCount) + ':' + std::to_string(rangePerFilter);
+    }
+};
+
+// log mel filter bank of one power spectrum, same as the MelFilter node
+static void melFilterBank(float const *power, int numBins, int windowSize, float sampleFreq,
+                          int count, float rangePerFilter, float *fbank) {
+    float halfFreq = sampleFreq / 2;
+    std::vector<int> bin;
+    float mel_fh = 2595.0 * log10(1+halfFreq/700.0);
+    for (int i = 0; i <= count + 1; i++) {
+        float mel = mel_fh * i / (count + 1);
+        float hz = 700.0 * (pow(10.0, mel / 2595.0) - 1);
+        bin.push_back((windowSize+1.0) * hz / sampleFreq);
+    }
+    for (auto i = 1; i <= count; i++) {
+        int s = bin[i-1];
+        int m = bin[i];
+        int e = bin[i+1];
+        s = (int) zaudio::lerp(m, s, rangePerFilter);
+        e = (int) zaudio::lerp(m, e, rangePerFilter);
+        float total = 0;
+        for (auto j = std::max(s, 0); j < std::min(m, numBins); j++) {
+            float cof = (float)(m - j) / (float)(m - s);
+            total += power[j] * cof;
+        }
+        for (auto j = std::max(m, 0); j < std::min(e, numBins); j++) {
+            float cof = 1 - (float)(m - j) / (float)(e - m);
+            total += power[j] * cof;
+        }
+        if (total == 0) {
+            fbank[i-1] = std::numeric_limits<float>::min();
+        }
+        else {
+            fbank[i-1] = log(total);
+        }
+    }
+}
+
+// short time fourier transform of a whole track, frame f is the window that
+// starts at sample f * hop; samples past the end repeat the last one
+struct Spectrogram {
+    SpectrogramParams params;
+    int sampleRate = 0;
+    int numSamples = 0;
+    int numFrames = 0;
+    int numBins = 0;  // windowSize / 2 + 1
+    std::vector<std::complex<float>> spectrum;  // numFrames x numBins
+    std::vector<float> mel;  // numFrames x melCount
+    std::vector<double> energyPrefix;  // prefix sums of the squared samples
+    std::shared_ptr<PrimitiveObject const> wave;  // the decoded track, shared with readAudioCached
+
+    int frameAt(float time) const {
+        int start = int(sampleRate * time);
+        return std::clamp((start + params.hop / 2) / params.hop, 0, numFrames - 1);
+    }
+
+    std::complex<float> const *frameSpectrum(int frame) const {
+        return spectrum.data() + (std::size_t)frame * numBins;
+    }
+
+    float const *frameMel(int frame) const {
+        return mel.data() + (std::size_t)frame * params.melCount;
+    }
+
+    // sum of |X|^2 / count over the unwindowed fft of the samples
+    // [start, start + count), equal to the sum of squared samples by Parseval
+    double energy(int start, int count) const {
+        if (!numSamples)
+            return 0;
+        start = std::clamp(start, 0, numSamples - 1);
+        int end = std::min(start + count, numSamples);
+        double last = energyPrefix[numSamples] - energyPrefix[numSamples - 1];
+        return energyPrefix[end] - energyPrefix[start] + (double)(start + count - end) * last;
+    }
+};
+
+static std::shared_ptr<Spectrogram const> computeSpectrogram(std::shared_ptr<PrimitiveObject const> const &wave, SpectrogramParams const &params) {
+    int N = params.windowSize;
+    if (N < 2 || (N & (N - 1)))
+        throw makeError("windowSize must be a power of two");
+    if (params.hop < 1)
+        throw makeError("hop must be positive");
+    auto const &value = wave->attr<float>("value");
+    auto res = std::make_shared<Spectrogram>();
+    res->params = params;
+    res->wave = wave;
+    res->sampleRate = wave->userData().get<zeno::NumericObject>("SampleRate")->get<int>();
+    res->numSamples = value.size();
+    res->numFrames = std::max((res->numSamples + params.hop - 1) / params.hop, 1);
+    res->numBins = N / 2 + 1;
+    res->spectrum.resize((std::size_t)res->numFrames * res->numBins);
+    res->mel.resize((std::size_t)res->numFrames * params.melCount);
+    res->energyPrefix.resize(res->numSamples + 1);
+    for (int i = 0; i < res->numSamples; i++)
+        res->energyPrefix[i + 1] = res->energyPrefix[i] + (double)value[i] * value[i];
+
+    std::vector<double> hamming(N);
+    for (auto i = 0; i < N; i++)
+        hamming[i] = 0.54 - 0.46 * std::cos(2.0 * M_PI * i / (N - 1));
+    auto fft = Aquila::FftFactory::getFft(N);
+    auto transformFrame = [&] (int f) {
+        std::vector<double> samples(N + 1);
+        std::vector<float> power(res->numBins);
+        for (auto i = 0; i < N + 1; i++)
+            samples[i] = res->numSamples ? value[std::min(f * params.hop + i, res->numSamples - 1)] : 0;
+        if (params.preEmphasis) {
+            for (auto i = 0; i < N; i++)
+                samples[i] = samples[i+1] - params.preEmphasisAlpha * samples[i];
+        }
+        if (params.hammingWindow) {
+            for (auto i = 0; i < N; i++)
+                samples[i] *= hamming[i];
+        }
+        Aquila::SpectrumType spectrums = fft->fft(samples.data());
+        auto *out = res->spectrum.data() + (std::size_t)f * res->numBins;
+        for (auto i = 0; i < res->numBins; i++) {
+            out[i] = std::complex<float>(spectrums[i]);
+            power[i] = std::norm(out[i]) / N;
+        }
+        melFilterBank(power.data(), res->numBins, N, res->sampleRate, params.melCount, params.rangePerFilter,
+                      res->mel.data() + (std::size_t)f * params.melCount);
+    };
+    // the first call fills the twiddle tables of Ooura's fft, after that it only reads them
+    transformFrame(0);
+    parallel_for(1, res->numFrames, transformFrame);
+    return res;
+}
+
+static std::shared_ptr<Spectrogram const> spectrogramCached(std::string const &path, SpectrogramParams const &params) {
+    static AudioCache<Spectrogram> cache;
+    auto stamp = fileStamp(path);
+    auto key = path + '|' + params.key();
+    if (auto spec = cache.get(key, stamp))
+        return spec;
+    auto wave = readAudioCached(path);
+    if (!wave)
+        throw makeError("unsupported audio file: " + path);
+    auto result = computeSpectrogram(wave, params);
+    cache.put(key, stamp, result, result->spectrum.size() * sizeof(result->spectrum[0])
+              + result->mel.size() * sizeof(float) + result->energyPrefix.size() * sizeof(double));
+    return result;
+}
+
+struct SpectrogramObject : IObjectClone<SpectrogramObject> {
+    std::shared_ptr<Spectrogram const> data;
+};
+
     struct ReadWavFile : zeno::INode {
         virtual void apply() override {
             auto path = get_input<StringObject>("path")->get(); // std::string
@@ -133,21 +392,14 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
 
         virtual void apply() override {
             auto path = get_input<StringObject>("path")->get(); // std::string
-            auto lower_path = path;
-            transform(lower_path.begin(), lower_path.end(), lower_path.begin(), ::tolower);
-            zeno::log_debug("{} -> {}", path, lower_path);
-            auto *pFile = strrchr(lower_path.c_str(),'.');
-
-            if(pFile !=NULL) {
-                if (strcmp(pFile, ".wav") == 0) {
-                    zeno::log_debug("is wave");
-                    auto result = zeno::readWav(path);
-                    set_output("wave", result);
-                } else if (strcmp(pFile, ".mp3") == 0) {
-                    zeno::log_debug("is mp3");
-                    auto result = zeno::readMp3(path);
-                    set_output("wave", result);
-                }
+            // the samples are shared with the cache until someone writes to them;
+            // pos is all zeros in a decoded track, so it is filled instead of copied
+            if (auto wave = readAudioCached(path)) {
+                auto result = std::make_shared<PrimitiveObject>();
+                result->verts.values.resize(wave->verts.size());
+                result->verts.attrs = wave->verts.attrs;
+                result->userData() = wave->userData();
+                set_output("wave", std::move(result));
             }
         }
     };
@@ -166,35 +418,82 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     });
 
 
+    struct AudioSpectrogram : zeno::INode {
+        virtual void apply() override {
+            auto path = get_input<StringObject>("path")->get(); // std::string
+            SpectrogramParams params;
+            params.windowSize = get_input2<int>("windowSize");
+            params.hop = get_input2<int>("hop");
+            params.preEmphasis = get_input2<int>("preEmphasis");
+            params.preEmphasisAlpha = get_input2<float>("preEmphasisAlpha");
+            params.hammingWindow = get_input2<int>("hammingWindow");
+            params.melCount = get_input2<int>("melCount");
+            params.rangePerFilter = get_input2<float>("rangePerFilter");
+            auto spec = std::make_shared<SpectrogramObject>();
+            spec->data = spectrogramCached(path, params);
+            set_output("spectrogram", std::move(spec));
+        }
+    };
+
+    ZENDEFNODE(AudioSpectrogram, {
+        {
+            {"readpath", "path"},
+            {"int", "windowSize", "1024"},
+            {"int", "hop", "1024"},
+            {"bool", "preEmphasis", "0"},
+            {"float", "preEmphasisAlpha", "0.97"},
+            {"bool", "hammingWindow", "1"},
+            {"int", "melCount", "15"},
+            {"float", "rangePerFilter", "1"},
+        },
+        {
+            "spectrogram",
+        },
+        {},
+        {
+            "audio"
+        },
+    });
+
     struct AudioBeats : zeno::INode {
         std::deque<double> H;
         virtual void apply() override {
-            auto wave = get_input<PrimitiveObject>("wave");
             float threshold = get_input<NumericObject>("threshold")->get<float>();
             auto start_time = get_input<NumericObject>("time")->get<float>();
-            float sampleFrequency = wave->userData().get<zeno::NumericObject>("SampleRate")->get<float>();
-            int start_index = int(sampleFrequency * start_time);
             int duration_count = 1024;
-            auto fft = Aquila::FftFactory::getFft(duration_count);
-            std::vector<double> samples;
-            samples.resize(duration_count);
-            for (auto i = 0; i < duration_count; i++) {
-//                if (start_index + i >= wave->size()) {
-//                    break;
-//                }
-                samples[i] = wave->attr<float>("value")[min((start_index + i), wave->size()-1)];
-                
-                //if (start_index + i >= wave->size()) {
-                //    break;
-                //}
-                //samples[i] = wave->attr<float>("value")[start_index + i];
-            }
-            Aquila::SpectrumType spectrums = fft->fft(samples.data());
+            std::vector<float> energies;
+            if (has_input("spectrogram")) {
+                // no fft here: E of the 1024 samples starting at time is their sum of
+                // squares (Parseval), the per bin energies are those of the cached
+                // frame nearest to time, which is windowed and hop-aligned
+                auto spec = get_input<SpectrogramObject>("spectrogram")->data;
+                int start_index = int(spec->sampleRate * start_time);
+                H.push_back(spec->energy(start_index, duration_count));
+                auto const *X = spec->frameSpectrum(spec->frameAt(start_time));
+                int N = spec->params.windowSize;
+                energies.resize(N);
+                for (auto i = 0; i < N; i++) {
+                    // the spectrum of real samples is conjugate symmetric
+                    energies[i] = std::norm(X[i < spec->numBins ? i : N - i]);
+                }
+            } else {
+                auto wave = get_input<PrimitiveObject>("wave");
+                auto const &value = wave->attr<float>("value");
+                float sampleFrequency = wave->userData().get<zeno::NumericObject>("SampleRate")->get<float>();
+                int start_index = int(sampleFrequency * start_time);
+                auto fft = Aquila::FftFactory::getFft(duration_count);
+                std::vector<double> samples;
+                samples.resize(duration_count);
+                for (auto i = 0; i < duration_count; i++) {
+                    samples[i] = value[min((start_index + i), wave->size()-1)];
+                }
+                Aquila::SpectrumType spectrums = fft->fft(samples.data());
 
-            {
                 double E = 0;
                 for (const auto& spectrum: spectrums) {
-                    E += spectrum.real() * spectrum.real() + spectrum.imag() * spectrum.imag();
+                    double e = spectrum.real() * spectrum.real() + spectrum.imag() * spectrum.imag();
+                    energies.push_back((float)e);
+                    E += e;
                 }
                 E /= duration_count;
                 H.push_back(E);
@@ -229,9 +528,8 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
             set_output("H", output_H);
 
             auto output_E = std::make_shared<ListObject>();
-            for (const auto& spectrum: spectrums) {
-                double e = spectrum.real() * spectrum.real() + spectrum.imag() * spectrum.imag();
-                output_E->arr.emplace_back(std::make_shared<NumericObject>((float)e));
+            for (auto e: energies) {
+                output_E->arr.emplace_back(std::make_shared<NumericObject>(e));
             }
             set_output("E", output_E);
         }
@@ -240,6 +538,7 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     ZENDEFNODE(AudioBeats, {
         {
             "wave",
+            "spectrogram",
             {"float", "time", "0"},
             {"float", "threshold", "0.005"},
         },
@@ -260,9 +559,26 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
         double maxE = std::numeric_limits<double>::min();
         std::vector<double> init;
         virtual void apply() override {
-            auto wave = get_input<PrimitiveObject>("wave");
             int duration_count = 1024;
-            if (init.empty()) {
+            std::shared_ptr<Spectrogram const> spec;
+            std::shared_ptr<PrimitiveObject> wave;
+            if (has_input("spectrogram")) {
+                spec = get_input<SpectrogramObject>("spectrogram")->data;
+            } else {
+                wave = get_input<PrimitiveObject>("wave");
+            }
+            if (init.empty() && spec) {
+                int clip_count = spec->numSamples / duration_count;
+                init.reserve(clip_count);
+                for (auto i = 0; i < clip_count; i++) {
+                    double E = spec->energy(duration_count * i, duration_count);
+                    minE = min(minE, E);
+                    maxE = max(maxE, E);
+                    init.push_back(E);
+                }
+            }
+            if (init.empty() && wave) {
+                auto const &value = wave->attr<float>("value");
                 auto fft = Aquila::FftFactory::getFft(duration_count);
                 int clip_count = wave->size() / duration_count;
                 init.reserve(clip_count);
@@ -270,7 +586,7 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
                     std::vector<double> samples;
                     samples.resize(duration_count);
                     for (auto j = 0; j < duration_count; j++) {
-                        samples[j] = wave->attr<float>("value")[min(duration_count * i + j, wave->size()-1)];
+                        samples[j] = value[min(duration_count * i + j, wave->size()-1)];
                     }
                     Aquila::SpectrumType spectrums = fft->fft(samples.data());
                     {
@@ -303,20 +619,27 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
             set_output("maxE", std::make_shared<NumericObject>((float)maxE));
 
             auto start_time = get_input2<float>("time");
-            float sampleFrequency = wave->userData().get<zeno::NumericObject>("SampleRate")->get<float>();
-            int start_index = int(sampleFrequency * start_time);
-            auto fft = Aquila::FftFactory::getFft(duration_count);
-            std::vector<double> samples;
-            samples.resize(duration_count);
-            for (auto i = 0; i < duration_count; i++) {
-                samples[i] = wave->attr<float>("value")[min((start_index + i), wave->size()-1)];
-            }
-            Aquila::SpectrumType spectrums = fft->fft(samples.data());
+            int start_index;
             double E = 0;
-            for (const auto& spectrum: spectrums) {
-                E += spectrum.real() * spectrum.real() + spectrum.imag() * spectrum.imag();
+            if (spec) {
+                start_index = int(spec->sampleRate * start_time);
+                E = spec->energy(start_index, duration_count);
+            } else {
+                auto const &value = wave->attr<float>("value");
+                float sampleFrequency = wave->userData().get<zeno::NumericObject>("SampleRate")->get<float>();
+                start_index = int(sampleFrequency * start_time);
+                auto fft = Aquila::FftFactory::getFft(duration_count);
+                std::vector<double> samples;
+                samples.resize(duration_count);
+                for (auto i = 0; i < duration_count; i++) {
+                    samples[i] = value[min((start_index + i), wave->size()-1)];
+                }
+                Aquila::SpectrumType spectrums = fft->fft(samples.data());
+                for (const auto& spectrum: spectrums) {
+                    E += spectrum.real() * spectrum.real() + spectrum.imag() * spectrum.imag();
+                }
+                E /= duration_count;
             }
-            E /= duration_count;
             set_output("E", std::make_shared<NumericObject>((float)E));
             double uniE = (E - minE) / (maxE - minE);
             set_output("uniE", std::make_shared<NumericObject>((float)uniE));
@@ -351,6 +674,7 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     ZENDEFNODE(AudioEnergy, {
         {
             "wave",
+            "spectrogram",
             {"float", "time", "0"},
             {"float", "threshold", "1"},
         },
@@ -370,15 +694,37 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
 
     struct AudioFFT : zeno::INode {
         virtual void apply() override {
+            auto start_time = get_input2<float>("time");
+            if (has_input("spectrogram")) {
+                // window and emphasis were chosen when the spectrogram was made
+                auto spec = get_input<SpectrogramObject>("spectrogram")->data;
+                auto const *frame = spec->frameSpectrum(spec->frameAt(start_time));
+                auto fft_prim = std::make_shared<PrimitiveObject>();
+                fft_prim->resize(spec->numBins);
+                auto &freq = fft_prim->add_attr<float>("freq");
+                auto &real = fft_prim->add_attr<float>("real");
+                auto &image = fft_prim->add_attr<float>("image");
+                auto &square = fft_prim->add_attr<float>("square");
+                auto &power = fft_prim->add_attr<float>("power");
+                for (std::size_t i = 0; i < fft_prim->verts.size(); ++i) {
+                    freq[i] = float(i);
+                    real[i] = frame[i].real();
+                    image[i] = frame[i].imag();
+                    square[i] = std::norm(frame[i]);
+                    power[i] = square[i] / spec->params.windowSize;
+                }
+                set_output("FFTPrim", fft_prim);
+                return;
+            }
             auto wave = get_input<PrimitiveObject>("wave");
+            auto const &value = wave->attr<float>("value");
             int duration_count = 1024;
-            auto start_time = get_input2<float>("time");
             float sampleFrequency = wave->userData().get<zeno::NumericObject>("SampleRate")->get<float>();
             int start_index = int(sampleFrequency * start_time);
             std::vector<double> samples;
             samples.resize(duration_count+1);
             for (auto i = 0; i < duration_count+1; i++) {
-                samples[i] = wave->attr<float>("value")[min((start_index + i), wave->size()-1)];
+                samples[i] = value[min((start_index + i), wave->size()-1)];
             }
             auto pre_emphasis = get_input2<int>("preEmphasis");
             if (pre_emphasis) {
@@ -422,6 +768,7 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
     ZENDEFNODE(AudioFFT, {
         {
             "wave",
+            "spectrogram",
             {"float", "time", "0"},
             {"bool", "preEmphasis", "0"},
             {"float", "preEmphasisAlpha", "0.97"},
@@ -441,45 +788,11 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
             auto &power = fftPrim->attr<float>("power");
             auto sampleFreq = get_input2<float>("sampleFreq");
             auto rangePerFilter = get_input2<float>("rangePerFilter");
-            float halfFreq = sampleFreq / 2;
             auto count = get_input2<int>("count");
-            std::vector<float> hz_points;
-            float mel_fh = 2595.0 * log10(1+halfFreq/700.0);
-            for (int i = 0; i <= count + 1; i++) {
-                float mel = mel_fh * i / (count + 1);
-                float hz = 700.0 * (pow(10.0, mel / 2595.0) - 1);
-                hz_points.push_back(hz);
-            }
-            std::vector<int> bin;
-            for (const auto& hz: hz_points) {
-                int index = (1024.0+1.0) * hz / sampleFreq;
-                bin.push_back(index);
-            }
             auto fbank = std::make_shared<PrimitiveObject>();
             fbank->resize(count);
             auto& fbank_v = fbank->add_attr<float>("fbank");
-            for (auto i = 1; i <= count; i++) {
-                int s = bin[i-1];
-                int m = bin[i];
-                int e = bin[i+1];
-                s = (int) zaudio::lerp(m, s, rangePerFilter);
-                e = (int) zaudio::lerp(m, e, rangePerFilter);
-                float total = 0;
-                for (auto i = s; i < m; i++) {
-                    float cof = (float)(m - i) / (float)(m - s);
-                    total += power[i] * cof;
-                }
-                for (auto i = m; i < e; i++) {
-                    float cof = 1 - (float)(m - i) / (float)(e - m);
-                    total += power[i] * cof;
-                }
-                if (total == 0) {
-                    fbank_v[i-1] = std::numeric_limits<float>::min();
-                }
-                else {
-                    fbank_v[i-1] = log(total);
-                }
-            }
+            melFilterBank(power.data(), power.size(), 1024, sampleFreq, count, rangePerFilter, fbank_v.data());
             auto indexType = get_input2<std::string>("indexType");
             if (indexType == "index") {
                 auto& index = fbank->add_attr<float>("i");
@@ -511,4 +824,43 @@ static std::shared_ptr<PrimitiveObject> readMp3(std::string path) {
             "audio",
         },
     });
+    struct AudioMelBands : zeno::INode {
+        virtual void apply() override {
+            auto spec = get_input<SpectrogramObject>("spectrogram")->data;
+            auto start_time = get_input2<float>("time");
+            int count = spec->params.melCount;
+            auto const *mel = spec->frameMel(spec->frameAt(start_time));
+            auto fbank = std::make_shared<PrimitiveObject>();
+            fbank->resize(count);
+            auto& fbank_v = fbank->add_attr<float>("fbank");
+            std::copy(mel, mel + count, fbank_v.begin());
+            auto indexType = get_input2<std::string>("indexType");
+            if (indexType == "index") {
+                auto& index = fbank->add_attr<float>("i");
+                for (auto i = 0; i < count; i++) {
+                    index[i] = (float)i;
+                }
+            } else if (indexType == "indexdivcount") {
+                auto& index = fbank->add_attr<float>("i");
+                for (auto i = 0; i < count; i++) {
+                    index[i] = (float)i / count;
+                }
+            }
+            set_output("FilterBank", fbank);
+        }
+    };
+    ZENDEFNODE(AudioMelBands, {
+        {
+            "spectrogram",
+            {"float", "time", "0"},
+            {"enum none index indexdivcount", "indexType", "index"},
+        },
+        {
+            "FilterBank",
+        },
+        {},
+        {
+            "audio",
+        },
+    });
 } // namespace zeno
@@ -23,8 +23,8 @@
 
 namespace zeno {
 
-static zfx::Compiler compiler;
-static zfx::cuda::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::cuda::Assembler &assembler = zfx::cuda::Assembler::global();
 
 struct ZSParticlesWrangler : zeno::INode {
     ~ZSParticlesWrangler() {
@@ -115,6 +115,12 @@ struct FEMIntegrator : zeno::IObject {
     std::vector<double> _elmCharacteristicNorm;
 
     SpMat _connMatrix;
+    // elements grouped by color, elements of the same color share no vertex
+    // so that they can be assembled in parallel
+    std::vector<std::vector<size_t>> _elmColors;
+    // LDLT solver of the hessian, the symbolic analysis only depends on _connMatrix
+    // and is done once per topology, each newton iteration only refactorizes
+    std::shared_ptr<Eigen::SimplicialLDLT<SpMat>> _LDLTSolver;
 
     size_t _stepID;
 
@@ -153,6 +159,9 @@ struct FEMIntegrator : zeno::IObject {
         _connMatrix = SpMat(prim->size() * 3,prim->size() * 3);
         _connMatrix.setFromTriplets(connTriplets.begin(),connTriplets.end());
         _connMatrix.makeCompressed();
+        _LDLTSolver = nullptr;
+
+        ColorElements(prim);
 
         // _elmVolume.resize(nm_elms);
         _elmdFdx.resize(nm_elms);
@@ -218,6 +227,39 @@ struct FEMIntegrator : zeno::IObject {
         }      
     };
 
+    // greedy coloring, each vertex keeps a bitmask of the colors of its elements
+    void ColorElements(const std::shared_ptr<zeno::PrimitiveObject>& prim){
+        size_t nm_elms = prim->quads.size();
+        std::vector<std::vector<uint64_t>> vertColors(prim->size());
+        _elmColors.clear();
+        for(size_t elm_id = 0;elm_id < nm_elms;++elm_id){
+            const auto& elm = prim->quads[elm_id];
+            size_t color = 0;
+            for(size_t word = 0;;++word){
+                uint64_t used = 0;
+                for(size_t i = 0;i < 4;++i)
+                    if(word < vertColors[elm[i]].size())
+                        used |= vertColors[elm[i]][word];
+                if(~used){
+                    size_t bit = 0;
+                    while(used >> bit & 1)
+                        ++bit;
+                    color = word * 64 + bit;
+                    break;
+                }
+            }
+            for(size_t i = 0;i < 4;++i){
+                auto& mask = vertColors[elm[i]];
+                if(mask.size() <= color / 64)
+                    mask.resize(color / 64 + 1,0);
+                mask[color / 64] |= uint64_t(1) << (color % 64);
+            }
+            if(_elmColors.size() <= color)
+                _elmColors.resize(color + 1);
+            _elmColors[color].push_back(elm_id);
+        }
+    }
+
     // Except for the static parameters set during the contruction process, you can manipulate
     // the dynamic parameters of FEM mesh in prim using wrangle.
     // Currently the supported dynamic parameters include:
@@ -560,15 +602,18 @@ struct FEMIntegrator : zeno::IObject {
             // std::cout << "SIZE_OF_H_MATRIX : " << HValBuffer.size() << std::endl;
 
             // std::cout << "ASSEMBLE_HERE" << std::endl;
-            for(size_t elm_id = 0;elm_id < nm_elms;++elm_id){
-                auto tet = shape->quads[elm_id];
-                obj += objBuffer[elm_id];
-                // std::cout << "ASSEMBLE_ELM_VECTOR" << std::endl;
-                AssembleElmVector(tet,derivBuffer[elm_id],deriv);
-                // std::cout << "ASSEMBLE_ELM_MATRIX" << std::endl;
-                AssembleElmMatrixAdd(tet,HBuffer[elm_id],MatHelper::MapHMatrixRef(shape->size(),_connMatrix,HValBuffer.data()));
-                // std::cout << "FINISH ASSEMBLING" << std::endl;
+            auto H = MatHelper::MapHMatrixRef(shape->size(),_connMatrix,HValBuffer.data());
+            for(const auto& color : _elmColors){
+                #pragma omp parallel for
+                for(size_t k = 0;k < color.size();++k){
+                    size_t elm_id = color[k];
+                    auto tet = shape->quads[elm_id];
+                    AssembleElmVector(tet,derivBuffer[elm_id],deriv);
+                    AssembleElmMatrixAdd(tet,HBuffer[elm_id],H);
+                }
             }
+            for(size_t elm_id = 0;elm_id < nm_elms;++elm_id)
+                obj += objBuffer[elm_id];
 
             // auto tet = shape->quads[11221];
             // std::cout << "g1:\n" <<  
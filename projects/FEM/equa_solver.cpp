@@ -389,7 +389,6 @@ struct SolveFEM : zeno::INode {
     virtual void apply() override {
         // std::cout << "BEGIN SOLVER " << std::endl;
         Eigen::SparseLU<SpMat> _LUSolver;
-        Eigen::SimplicialLDLT<SpMat> _LDLTSolver;
 
         auto integrator = get_input<FEMIntegrator>("integrator");
         auto shape = get_input<PrimitiveObject>("shape");
@@ -515,8 +514,22 @@ struct SolveFEM : zeno::INode {
             r *= -1;
 
             clock_t begin_solve = clock();
-            _LDLTSolver.compute(MatHelper::MapHMatrix(shape->size(),integrator->_connMatrix,HBuffer.data()));
-            dp = _LDLTSolver.solve(r);
+            auto H = MatHelper::MapHMatrix(shape->size(),integrator->_connMatrix,HBuffer.data());
+            if(!integrator->_LDLTSolver){
+                integrator->_LDLTSolver = std::make_shared<Eigen::SimplicialLDLT<SpMat>>();
+                integrator->_LDLTSolver->analyzePattern(H);
+            }
+            integrator->_LDLTSolver->factorize(H);
+            // the cached pattern is stale if the hessian's sparsity changed, analyze it again
+            if(integrator->_LDLTSolver->info() != Eigen::Success){
+                integrator->_LDLTSolver->analyzePattern(H);
+                integrator->_LDLTSolver->factorize(H);
+                if(integrator->_LDLTSolver->info() != Eigen::Success){
+                    std::cerr << "LDLT FACTORIZATION FAILED : " << integrator->_LDLTSolver->info() << std::endl;
+                    throw std::runtime_error("LDLT factorization failed");
+                }
+            }
+            dp = integrator->_LDLTSolver->solve(r);
             clock_t end_solve = clock();
 
             // std::cout << "INTERNAL SIZE : " << r.norm() << "\t" << dp.norm() << HBuffer.norm() << std::endl;
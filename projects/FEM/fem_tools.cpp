@@ -775,14 +775,39 @@ struct ComputeNodalRotationCenter : zeno::INode {
                 break;
         }
 
+        // the skinning weight generators only keep the top-4 weights unless
+        // dense channels are asked for (<prefix>_idx/<prefix>_w), expand those when
+        // there are no dense ones
+        bool sparse = nm_bones == 0 && prim->has_attr(attr_prefix + "_idx");
+        if(sparse){
+            for(auto* p : {prim.get(),primNei.get()}){
+                const auto& idx = p->attr<zeno::vec4i>(attr_prefix + "_idx");
+                for(const auto& id : idx)
+                    for(int k = 0;k < 4;++k)
+                        nm_bones = std::max(nm_bones,(size_t)(id[k] + 1));
+            }
+        }
+        auto gather = [&](zeno::PrimitiveObject* p,size_t vi,std::vector<double>& wv) {
+            if(sparse){
+                std::fill(wv.begin(),wv.end(),0.0);
+                const auto& id = p->attr<zeno::vec4i>(attr_prefix + "_idx")[vi];
+                const auto& w = p->attr<zeno::vec4f>(attr_prefix + "_w")[vi];
+                for(int k = 0;k < 4;++k)
+                    if(id[k] >= 0)
+                        wv[id[k]] += w[k];
+                return;
+            }
+            for(size_t j = 0;j < nm_bones;++j){
+                std::string attr_name = attr_prefix + "_" + std::to_string(j);
+                wv[j] = p->attr<float>(attr_name)[vi];
+            }
+        };
+
 
         #pragma omp parallel for
         for(size_t i = 0;i < prim->size();++i){
             std::vector<double> wv(nm_bones);
-            for(size_t j = 0;j < nm_bones;++j){
-                std::string attr_name = attr_prefix + "_" + std::to_string(j);
-                wv[j] = prim->attr<float>(attr_name)[i];
-            }
+            gather(prim.get(),i,wv);
 
             rcenter[i] = zeno::vec3f(0);
             float weight_sum = 0;
@@ -792,10 +817,7 @@ struct ComputeNodalRotationCenter : zeno::INode {
                     // std::cout << "GET CALLED" << std::endl;
 
                     std::vector<double> wn(nm_bones);
-                    for(size_t j = 0;j < nm_bones;++j){
-                        std::string attr_name = attr_prefix + "_" + std::to_string(j);
-                        wn[j] = primNei->attr<float>(attr_name)[pid];
-                    }
+                    gather(primNei.get(),pid,wn);
 
                     // remove the possibly points with same location
                     float dist = zeno::length(pos[i] - npos[pid]);
@@ -0,0 +1,270 @@
+#ifndef ZENO_IMAGEOBJECT_H
+#define ZENO_IMAGEOBJECT_H
+#include <opencv2/core.hpp>
+#include <zeno/core/IObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/UserData.h>
+#include <zeno/utils/Error.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace zeno {
+    // hue in degrees, shared by the prim and the planar image nodes
+    inline void RGBtoHSV(float r, float g, float b, float &h, float &s, float &v) {
+        float rd = r;
+        float gd = g;
+        float bd = b;
+        float cmax = fmax(rd, fmax(gd, bd));
+        float cmin = fmin(rd, fmin(gd, bd));
+        float delta = cmax - cmin;
+
+        if (delta != 0) {
+            if (cmax == rd) {
+                h = fmod((gd - bd) / delta, 6.0);
+            } else if (cmax == gd) {
+                h = (bd - rd) / delta + 2.0;
+            } else if (cmax == bd) {
+                h = (rd - gd) / delta + 4.0;
+            }
+            h *= 60.0;
+            if (h < 0) {
+                h += 360.0;
+            }
+        }
+        s = (cmax != 0) ? delta / cmax : 0.0;
+        v = cmax;
+    }
+
+    inline void HSVtoRGB(float h, float s, float v, float &r, float &g, float &b)
+    {
+        int i;
+        float f, p, q, t;
+        if( s == 0 ) {
+            // achromatic (grey)
+            r = g = b = v;
+            return;
+        }
+        h /= 60;            // sector 0 to 5
+        i = floor( h );
+        f = h - i;          // factorial part of h
+        p = v * ( 1 - s );
+        q = v * ( 1 - s * f );
+        t = v * ( 1 - s * ( 1 - f ) );
+        switch( i ) {
+            case 0:
+                r = v;
+                g = t;
+                b = p;
+                break;
+            case 1:
+                r = q;
+                g = v;
+                b = p;
+                break;
+            case 2:
+                r = p;
+                g = v;
+                b = t;
+                break;
+            case 3:
+                r = p;
+                g = q;
+                b = v;
+                break;
+            case 4:
+                r = t;
+                g = p;
+                b = v;
+                break;
+            default:        // case 5:
+                r = v;
+                g = p;
+                b = q;
+                break;
+        }
+    }
+
+    // planar float image: one buffer per channel, every row starts on a 64 byte
+    // boundary so that a plane can be wrapped by a cv::Mat without copying.
+    // planes are shared between copies and detached on first write, so passing
+    // an image through nodes that only touch one channel does not copy the others
+    struct ImageObject : IObjectClone<ImageObject> {
+        static constexpr std::size_t kAlign = 64;
+        static constexpr std::size_t kAlignFloats = kAlign / sizeof(float);
+
+        int w = 0;
+        int h = 0;
+        std::size_t stride = 0;  // floats per row
+
+        ImageObject() = default;
+        ImageObject(int w, int h) : w(w), h(h),
+            stride((std::size_t(w) + kAlignFloats - 1) / kAlignFloats * kAlignFloats) {}
+
+        std::size_t size() const { return std::size_t(w) * h; }
+        std::size_t planeSize() const { return stride * h; }
+        int channels() const { return (int)m_names.size(); }
+        std::string const &channelName(int c) const { return m_names.at(c); }
+
+        int findChannel(std::string const &name) const {
+            auto it = std::find(m_names.begin(), m_names.end(), name);
+            return it == m_names.end() ? -1 : int(it - m_names.begin());
+        }
+        bool hasChannel(std::string const &name) const { return findChannel(name) >= 0; }
+
+        // returns the existing channel, or adds one filled with value
+        int addChannel(std::string const &name, float value = 0) {
+            int c = findChannel(name);
+            if (c >= 0)
+                return c;
+            auto plane = allocPlane();
+            std::fill_n(plane.get(), planeSize(), value);
+            m_names.push_back(name);
+            m_planes.push_back(std::move(plane));
+            return channels() - 1;
+        }
+
+        void removeChannel(std::string const &name) {
+            int c = findChannel(name);
+            if (c < 0)
+                return;
+            m_names.erase(m_names.begin() + c);
+            m_planes.erase(m_planes.begin() + c);
+        }
+
+        // share a plane of another image of the same size, no copy
+        int shareChannel(ImageObject const &src, int srcChannel, std::string const &name) {
+            if (src.w != w || src.h != h || src.stride != stride)
+                throw makeError("ImageObject: cannot share a channel between images of different size");
+            int c = findChannel(name);
+            if (c < 0) {
+                m_names.push_back(name);
+                m_planes.push_back(src.m_planes.at(srcChannel));
+                return channels() - 1;
+            }
+            m_planes[c] = src.m_planes.at(srcChannel);
+            return c;
+        }
+
+        float const *data(int c) const { return m_planes.at(c).get(); }
+        float const *row(int c, int y) const { return data(c) + stride * y; }
+
+        // writable access, copies the plane first if another image still uses it;
+        // call this before entering a parallel loop, not inside of it
+        float *data(int c) {
+            auto &plane = m_planes.at(c);
+            if (plane.use_count() > 1) {
+                auto copy = allocPlane();
+                std::memcpy(copy.get(), plane.get(), planeSize() * sizeof(float));
+                plane = std::move(copy);
+            }
+            return plane.get();
+        }
+
+        // writable access when the old content is not needed, e.g. the output of
+        // a filter: a shared plane is replaced by a new uninitialized one
+        float *overwrite(int c) {
+            auto &plane = m_planes.at(c);
+            if (plane.use_count() > 1)
+                plane = allocPlane();
+            return plane.get();
+        }
+
+        // zero-copy views for OpenCV, writing through the Mat writes the image
+        cv::Mat mat(int c) {
+            return cv::Mat(h, w, CV_32FC1, data(c), stride * sizeof(float));
+        }
+        cv::Mat mat(int c) const {
+            return cv::Mat(h, w, CV_32FC1, const_cast<float *>(data(c)), stride * sizeof(float));
+        }
+
+        // the usual rgb(a) image prims of this project: vec3f verts holding the
+        // color, an optional "alpha" attribute and w/h in userData; extra float
+        // attributes become extra channels of the same name
+        static std::shared_ptr<ImageObject> fromPrimitive(PrimitiveObject const *prim, bool extraChannels = true) {
+            auto &ud = prim->userData();
+            int w = ud.get2<int>("w");
+            int h = ud.get2<int>("h");
+            if (std::size_t(w) * h != prim->verts.size())
+                throw makeError("ImageObject: image prim has " + std::to_string(prim->verts.size())
+                                + " pixels, expect w * h = " + std::to_string(std::size_t(w) * h));
+            auto img = std::make_shared<ImageObject>(w, h);
+            float *rgb[3];
+            for (int k = 0; k < 3; k++)
+                rgb[k] = img->data(img->addChannel(std::string(1, "rgb"[k])));
+            auto const &verts = prim->verts;
+#pragma omp parallel for
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    auto const &c = verts[std::size_t(y) * w + x];
+                    rgb[0][y * img->stride + x] = c[0];
+                    rgb[1][y * img->stride + x] = c[1];
+                    rgb[2][y * img->stride + x] = c[2];
+                }
+            }
+            prim->verts.foreach_attr([&] (auto const &key, auto const &arr) {
+                using T = std::decay_t<decltype(arr[0])>;
+                if constexpr (std::is_same_v<T, float>) {
+                    if (key != "alpha" && !extraChannels)
+                        return;
+                    float *dst = img->data(img->addChannel(key == "alpha" ? "a" : key));
+                    for (int y = 0; y < h; y++)
+                        std::copy_n(arr.data() + std::size_t(y) * w, w, dst + y * img->stride);
+                }
+            });
+            return img;
+        }
+
+        std::shared_ptr<PrimitiveObject> toPrimitive(bool extraChannels = true) const {
+            auto prim = std::make_shared<PrimitiveObject>();
+            prim->verts.resize(size());
+            prim->userData().set2("isImage", 1);
+            prim->userData().set2("w", w);
+            prim->userData().set2("h", h);
+            float const *rgb[3];
+            for (int k = 0; k < 3; k++) {
+                int c = findChannel(std::string(1, "rgb"[k]));
+                rgb[k] = c >= 0 ? data(c) : nullptr;
+            }
+            auto &verts = prim->verts;
+#pragma omp parallel for
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    vec3f c;
+                    for (int k = 0; k < 3; k++)
+                        c[k] = rgb[k] ? rgb[k][y * stride + x] : 0.f;
+                    verts[std::size_t(y) * w + x] = c;
+                }
+            }
+            for (int c = 0; c < channels(); c++) {
+                auto const &name = m_names[c];
+                if (name == "r" || name == "g" || name == "b")
+                    continue;
+                if (name != "a" && !extraChannels)
+                    continue;
+                auto &attr = prim->verts.add_attr<float>(name == "a" ? "alpha" : name);
+                for (int y = 0; y < h; y++)
+                    std::copy_n(row(c, y), w, attr.data() + std::size_t(y) * w);
+            }
+            return prim;
+        }
+
+    private:
+        std::vector<std::string> m_names;
+        std::vector<std::shared_ptr<float>> m_planes;
+
+        std::shared_ptr<float> allocPlane() const {
+            auto n = std::max<std::size_t>(planeSize(), 1);
+            auto p = static_cast<float *>(::operator new[](n * sizeof(float), std::align_val_t(kAlign)));
+            return std::shared_ptr<float>(p, [] (float *p) {
+                ::operator delete[](p, std::align_val_t(kAlign));
+            });
+        }
+    };
+}
+#endif //ZENO_IMAGEOBJECT_H
@@ -0,0 +1,663 @@
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/UserData.h>
+#include <zeno/utils/log.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include "ImageObject.h"
+
+namespace zeno {
+
+namespace {
+
+// per-pixel kernels split the image into bands of rows, the vertical blur pass
+// into strips of columns; a task never spans two channels
+constexpr int kTileRows = 32;
+constexpr int kTileCols = 64;
+
+template <class F>
+void forEachRowTile(int nplanes, int h, F const &f) {
+    int ntiles = (h + kTileRows - 1) / kTileRows;
+    int ntasks = nplanes * ntiles;
+#pragma omp parallel for schedule(static)
+    for (int t = 0; t < ntasks; t++) {
+        int y0 = t % ntiles * kTileRows;
+        f(t / ntiles, y0, std::min(h, y0 + kTileRows));
+    }
+}
+
+std::vector<int> selectChannels(ImageObject const &img, std::string const &which) {
+    std::vector<std::string> names;
+    if (which == "All") {
+        std::vector<int> all(img.channels());
+        for (int c = 0; c < img.channels(); c++)
+            all[c] = c;
+        return all;
+    }
+    else if (which == "RGBA")
+        names = {"r", "g", "b", "a"};
+    else if (which == "RGB")
+        names = {"r", "g", "b"};
+    else if (which == "R" || which == "G" || which == "B" || which == "A")
+        names = {std::string(1, char(std::tolower(which[0])))};
+    else
+        names = {which};
+    std::vector<int> res;
+    for (auto const &name: names) {
+        int c = img.findChannel(name);
+        if (c >= 0)
+            res.push_back(c);
+    }
+    return res;
+}
+
+struct PlanePair {
+    float const *src;
+    float *dst;
+};
+
+// running box sums with clamp-to-edge borders, like boxBlurH/boxBlurT of ImageBlur
+void boxBlurRows(std::vector<PlanePair> const &planes, int w, int h, std::size_t stride, int r) {
+    float iarr = 1.f / (r + r + 1);
+    forEachRowTile(planes.size(), h, [&] (int p, int y0, int y1) {
+        for (int y = y0; y < y1; y++) {
+            float const *s = planes[p].src + stride * y;
+            float *d = planes[p].dst + stride * y;
+            float val = 0;
+            for (int j = -r; j <= r; j++)
+                val += s[std::clamp(j, 0, w - 1)];
+            // the borders clamp, the middle part runs without index checks
+            int xa = std::min(r, w), xb = std::max(xa, w - r - 1);
+            for (int x = 0; x < xa; x++) {
+                d[x] = val * iarr;
+                val += s[std::min(x + r + 1, w - 1)] - s[0];
+            }
+            for (int x = xa; x < xb; x++) {
+                d[x] = val * iarr;
+                val += s[x + r + 1] - s[x - r];
+            }
+            for (int x = xb; x < w; x++) {
+                d[x] = val * iarr;
+                val += s[w - 1] - s[std::max(x - r, 0)];
+            }
+        }
+    });
+}
+
+void boxBlurColumns(std::vector<PlanePair> const &planes, int w, int h, std::size_t stride, int r) {
+    float iarr = 1.f / (r + r + 1);
+    int nstrips = (w + kTileCols - 1) / kTileCols;
+    int ntasks = planes.size() * nstrips;
+#pragma omp parallel for schedule(static)
+    for (int t = 0; t < ntasks; t++) {
+        auto const &p = planes[t / nstrips];
+        int x0 = t % nstrips * kTileCols;
+        int n = std::min(kTileCols, w - x0);
+        float acc[kTileCols] = {};
+        for (int j = -r; j <= r; j++) {
+            float const *s = p.src + stride * std::clamp(j, 0, h - 1) + x0;
+            for (int i = 0; i < n; i++)
+                acc[i] += s[i];
+        }
+        for (int y = 0; y < h; y++) {
+            float *d = p.dst + stride * y + x0;
+            float const *add = p.src + stride * std::min(y + r + 1, h - 1) + x0;
+            float const *sub = p.src + stride * std::max(y - r, 0) + x0;
+            for (int i = 0; i < n; i++) {
+                d[i] = acc[i] * iarr;
+                acc[i] += add[i] - sub[i];
+            }
+        }
+    }
+}
+
+// three box passes approximating a gaussian, radii as in boxesForGauss
+std::vector<int> gaussBoxRadii(float sigma, int n) {
+    float wIdeal = std::sqrt(12 * sigma * sigma / n + 1);
+    int wl = std::floor(wIdeal);
+    if (wl % 2 == 0)
+        wl--;
+    int wu = wl + 2;
+    float mIdeal = (12 * sigma * sigma - n * wl * wl - 4 * n * wl - 3 * n) / (-4 * wl - 4);
+    int m = std::round(mIdeal);
+    std::vector<int> radii(n);
+    for (int i = 0; i < n; i++)
+        radii[i] = ((i < m ? wl : wu) - 1) / 2;
+    return radii;
+}
+
+struct ImageToPlanar : INode {
+    virtual void apply() override {
+        auto image = get_input<PrimitiveObject>("image");
+        auto extra = get_input2<bool>("extraChannels");
+        set_output("image", ImageObject::fromPrimitive(image.get(), extra));
+    }
+};
+
+ZENDEFNODE(ImageToPlanar, {
+    {
+        {"image"},
+        {"bool", "extraChannels", "1"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "image" },
+});
+
+struct PlanarToImage : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> image = get_input<ImageObject>("image");
+        auto extra = get_input2<bool>("extraChannels");
+        set_output("image", image->toPrimitive(extra));
+    }
+};
+
+ZENDEFNODE(PlanarToImage, {
+    {
+        {"ImageObject", "image"},
+        {"bool", "extraChannels", "1"},
+    },
+    {
+        {"image"},
+    },
+    {},
+    { "image" },
+});
+
+struct PlanarImageBlur : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> image = get_input<ImageObject>("image");
+        auto type = get_input2<std::string>("type");
+        auto kernelSize = get_input2<int>("kernelSize");
+        auto sigma = get_input2<float>("GaussianSigma");
+        auto sigmaColor = get_input2<vec2f>("BilateralSigma")[0];
+        auto sigmaSpace = get_input2<vec2f>("BilateralSigma")[1];
+        auto channels = selectChannels(*image, get_input2<std::string>("channels"));
+        if (kernelSize % 2 == 0)
+            kernelSize += 1;
+
+        // the channels that are not blurred stay shared with the input
+        auto out = std::make_shared<ImageObject>(*image);
+        int w = image->w, h = image->h;
+        std::size_t stride = image->stride;
+
+        if (type == "Gaussian" || type == "Box") {
+            std::vector<int> radii = type == "Box" ? std::vector<int>{kernelSize / 2} : gaussBoxRadii(sigma, 3);
+            ImageObject tmp(w, h);
+            std::vector<PlanePair> rows, cols;
+            for (int c: channels) {
+                float *t = tmp.data(tmp.addChannel(image->channelName(c)));
+                float *d = out->overwrite(c);
+                rows.push_back({image->data(c), t});
+                cols.push_back({t, d});
+            }
+            for (int r: radii) {
+                boxBlurRows(rows, w, h, stride, r);
+                boxBlurColumns(cols, w, h, stride, r);
+                // later passes start from the previous result
+                for (std::size_t i = 0; i < rows.size(); i++)
+                    rows[i].src = cols[i].dst;
+            }
+        }
+        else if (type == "Median" || type == "Stack") {
+            for (int c: channels) {
+                cv::Mat src = image->mat(c);
+                out->overwrite(c);
+                cv::Mat dst = out->mat(c);
+                if (type == "Median")
+                    cv::medianBlur(src, dst, std::min(kernelSize, 5));//float images only support kernel size 3 and 5
+                else
+                    cv::stackBlur(src, dst, cv::Size(kernelSize, kernelSize));
+            }
+        }
+        else if (type == "Bilateral") {
+            // each channel is filtered on its own, so the range term uses that channel only
+            for (int c: channels) {
+                cv::Mat src = image->mat(c);
+                out->overwrite(c);
+                cv::Mat dst = out->mat(c);
+                cv::bilateralFilter(src, dst, kernelSize, sigmaColor, sigmaSpace);
+            }
+        }
+        else {
+            zeno::log_error("PlanarImageBlur: Blur type does not exist");
+        }
+        set_output("image", out);
+    }
+};
+
+ZENDEFNODE(PlanarImageBlur, {
+    {
+        {"ImageObject", "image"},
+        {"enum Gaussian Box Median Bilateral Stack", "type", "Gaussian"},
+        {"int", "kernelSize", "5"},
+        {"float", "GaussianSigma", "1"},
+        {"vec2f", "BilateralSigma", "50,50"},
+        {"enum RGBA RGB All", "channels", "RGBA"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "image" },
+});
+
+struct PlanarImageLevels : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> image = get_input<ImageObject>("image");
+        auto inputLevels = get_input2<vec2f>("Input Levels");
+        auto outputLevels = get_input2<vec2f>("Output Levels");
+        auto gamma = get_input2<float>("gamma");
+        auto channel = get_input2<std::string>("channel");
+        auto clamp = get_input2<bool>("Clamp Output");
+        auto autolevel = get_input2<bool>("Auto Level");
+        // same as ImageLevels: All includes alpha, Auto Level only looks at the colors
+        auto channels = selectChannels(*image, autolevel ? "RGB" : channel == "All" ? "RGBA" : channel);
+        if (channels.empty())
+            zeno::log_error("PlanarImageLevels: no {} channel", channel);
+
+        int w = image->w, h = image->h;
+        std::size_t stride = image->stride;
+        int nc = channels.size();
+        std::vector<float> inMin(nc, inputLevels[0]), inRange(nc, inputLevels[1] - inputLevels[0]);
+        float outMin = outputLevels[0], outRange = outputLevels[1] - outputLevels[0];
+        float gammaCorrection = autolevel ? 1.f : 1.f / gamma;
+
+        if (autolevel) {
+            // per tile histograms, summed afterwards
+            int ntiles = (h + kTileRows - 1) / kTileRows;
+            std::vector<int> hist(std::size_t(nc) * ntiles * 256);
+            forEachRowTile(nc, h, [&] (int p, int y0, int y1) {
+                int *hp = hist.data() + (std::size_t(p) * ntiles + y0 / kTileRows) * 256;
+                for (int y = y0; y < y1; y++) {
+                    float const *s = image->row(channels[p], y);
+                    for (int x = 0; x < w; x++)
+                        hp[std::clamp(int(s[x] * 255.99f), 0, 255)]++;
+                }
+            });
+            float threshold = float(image->size()) * 0.001f;
+            for (int p = 0; p < nc; p++) {
+                int total[256] = {};
+                for (int t = 0; t < ntiles; t++)
+                    for (int i = 0; i < 256; i++)
+                        total[i] += hist[(std::size_t(p) * ntiles + t) * 256 + i];
+                int lo = 0, hi = 0, sum = 0;
+                for (int i = 0; i < 256; i++) {
+                    sum += total[i];
+                    if (sum >= threshold) { lo = i; break; }
+                }
+                sum = 0;
+                for (int i = 255; i >= 0; i--) {
+                    sum += total[i];
+                    if (sum >= threshold) { hi = i; break; }
+                }
+                inMin[p] = lo / 255.f;
+                inRange[p] = (hi - lo) / 255.f;
+            }
+        }
+
+        auto out = std::make_shared<ImageObject>(*image);
+        std::vector<PlanePair> planes;
+        for (int c: channels)
+            planes.push_back({image->data(c), out->overwrite(c)});
+        forEachRowTile(nc, h, [&] (int p, int y0, int y1) {
+            float lo = inMin[p], inv = 1.f / inRange[p];
+            for (int y = y0; y < y1; y++) {
+                float const *s = planes[p].src + stride * y;
+                float *d = planes[p].dst + stride * y;
+                for (int x = 0; x < w; x++) {
+                    float v = (std::max(s[x], lo) - lo) * inv;
+                    if (gammaCorrection != 1.f)
+                        v = std::pow(v, gammaCorrection);
+                    v = v * outRange + outMin;
+                    d[x] = clamp ? std::clamp(v, 0.f, 1.f) : v;
+                }
+            }
+        });
+        set_output("image", out);
+    }
+};
+
+ZENDEFNODE(PlanarImageLevels, {
+    {
+        {"ImageObject", "image"},
+        {"vec2f", "Input Levels", "0, 1"},
+        {"float", "gamma", "1"},
+        {"vec2f", "Output Levels", "0, 1"},
+        {"enum All R G B A", "channel", "All"},
+        {"bool", "Auto Level", "0"},
+        {"bool", "Clamp Output", "1"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "image" },
+});
+
+struct PlanarImageHSV : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> image = get_input<ImageObject>("image");
+        auto mode = get_input2<std::string>("mode");
+        int modeId = mode == "RGB2HSV" ? 1 : mode == "HSV2RGB" ? 2 : 0;
+        float hueShift = get_input2<float>("H");
+        float Si = get_input2<float>("S");
+        float Vi = get_input2<float>("V");
+        int ch[3] = {image->findChannel("r"), image->findChannel("g"), image->findChannel("b")};
+        if (ch[0] < 0 || ch[1] < 0 || ch[2] < 0)
+            throw zeno::makeError("PlanarImageHSV: image needs r, g and b channels");
+
+        auto out = std::make_shared<ImageObject>(*image);
+        float const *src[3];
+        float *dst[3];
+        for (int k = 0; k < 3; k++) {
+            src[k] = image->data(ch[k]);
+            dst[k] = out->overwrite(ch[k]);
+        }
+        int w = image->w;
+        std::size_t stride = image->stride;
+        forEachRowTile(1, image->h, [&] (int, int y0, int y1) {
+            for (int y = y0; y < y1; y++) {
+                std::size_t o = stride * y;
+                for (int x = 0; x < w; x++) {
+                    float a = src[0][o + x], b = src[1][o + x], c = src[2][o + x];
+                    float H = 0, S = 0, V = 0;
+                    if (modeId == 1) {
+                        zeno::RGBtoHSV(a, b, c, H, S, V);
+                        a = H, b = S, c = V;
+                    }
+                    else if (modeId == 2) {
+                        zeno::HSVtoRGB(a, b, c, H, S, V);
+                        a = H, b = S, c = V;
+                    }
+                    else {
+                        zeno::RGBtoHSV(a, b, c, H, S, V);
+                        H = std::fmod(H + hueShift, 360.f);
+                        if (H < 0)
+                            H += 360.f;
+                        S = S + (S - 0.5f) * (Si - 1);
+                        V = V + (V - 0.5f) * (Vi - 1);
+                        zeno::HSVtoRGB(H, S, V, a, b, c);
+                    }
+                    dst[0][o + x] = a;
+                    dst[1][o + x] = b;
+                    dst[2][o + x] = c;
+                }
+            }
+        });
+        set_output("image", out);
+    }
+};
+
+ZENDEFNODE(PlanarImageHSV, {
+    {
+        {"ImageObject", "image"},
+        {"enum Edit RGB2HSV HSV2RGB", "mode", "Edit"},
+        {"float", "H", "0"},//hue shift in degrees
+        {"float", "S", "1"},
+        {"float", "V", "1"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "image" },
+});
+
+// the blending modes of the Blend node, one channel at a time:
+// f foreground, b background, bg background times its opacity
+enum class BlendOp {
+    Over, Copy, Under, Atop, In, Out, Screen, Add, Subtract, Multiply,
+    Max, Min, Average, Difference, Overlay, SoftLight, Divide, Xor,
+};
+
+BlendOp parseBlendOp(std::string const &mode) {
+    static const char *const names[] = {
+        "Over", "Copy", "Under", "Atop", "In", "Out", "Screen", "Add", "Subtract", "Multiply",
+        "Max(Lighten)", "Min(Darken)", "Average", "Difference", "Overlay", "SoftLight", "Divide", "Xor",
+    };
+    for (int i = 0; i < int(std::size(names)); i++)
+        if (mode == names[i])
+            return BlendOp(i);
+    throw zeno::makeError("unknown blending mode " + mode);
+}
+
+template <BlendOp Op>
+inline float blendOp(float f, float b, float bg, float a1, float a2) {
+    if constexpr (Op == BlendOp::Over) return f + bg * (1 - a1);
+    else if constexpr (Op == BlendOp::Copy) return f;
+    else if constexpr (Op == BlendOp::Under) return bg + f * (1 - a2);
+    else if constexpr (Op == BlendOp::Atop) return f * a2 + bg * (1 - a1);
+    else if constexpr (Op == BlendOp::In) return f * a2;
+    else if constexpr (Op == BlendOp::Out) return f * (1 - a2);
+    else if constexpr (Op == BlendOp::Screen) return 1 - (1 - bg) * (1 - f);
+    else if constexpr (Op == BlendOp::Add) return f + bg;
+    else if constexpr (Op == BlendOp::Subtract) return bg - f;
+    else if constexpr (Op == BlendOp::Multiply) return f * bg;
+    else if constexpr (Op == BlendOp::Max) return std::max(f, bg);
+    else if constexpr (Op == BlendOp::Min) return std::min(f, bg);
+    else if constexpr (Op == BlendOp::Average) return (f + bg) / 2;
+    else if constexpr (Op == BlendOp::Difference) return std::abs(f - bg);
+    else if constexpr (Op == BlendOp::Overlay) return b < 0.5f ? 2 * f * bg : 1 - 2 * (1 - f) * (1 - bg);
+    else if constexpr (Op == BlendOp::SoftLight)
+        return f < 0.5f ? 2 * f * bg + bg * bg * (1 - 2 * f) : 2 * bg * (1 - f) + std::sqrt(bg) * (2 * f - 1);
+    else if constexpr (Op == BlendOp::Divide) return f == 0 ? 1.f : bg / f;
+    else return f * (1 - a2) + bg * (1 - a1);
+}
+
+// calls f with the blending mode as a compile time constant, so that the
+// pixel loops do not branch on it
+template <class F>
+void visitBlendOp(BlendOp op, F const &f) {
+    using B = BlendOp;
+    switch (op) {
+    case B::Over: f(std::integral_constant<B, B::Over>{}); break;
+    case B::Copy: f(std::integral_constant<B, B::Copy>{}); break;
+    case B::Under: f(std::integral_constant<B, B::Under>{}); break;
+    case B::Atop: f(std::integral_constant<B, B::Atop>{}); break;
+    case B::In: f(std::integral_constant<B, B::In>{}); break;
+    case B::Out: f(std::integral_constant<B, B::Out>{}); break;
+    case B::Screen: f(std::integral_constant<B, B::Screen>{}); break;
+    case B::Add: f(std::integral_constant<B, B::Add>{}); break;
+    case B::Subtract: f(std::integral_constant<B, B::Subtract>{}); break;
+    case B::Multiply: f(std::integral_constant<B, B::Multiply>{}); break;
+    case B::Max: f(std::integral_constant<B, B::Max>{}); break;
+    case B::Min: f(std::integral_constant<B, B::Min>{}); break;
+    case B::Average: f(std::integral_constant<B, B::Average>{}); break;
+    case B::Difference: f(std::integral_constant<B, B::Difference>{}); break;
+    case B::Overlay: f(std::integral_constant<B, B::Overlay>{}); break;
+    case B::SoftLight: f(std::integral_constant<B, B::SoftLight>{}); break;
+    case B::Divide: f(std::integral_constant<B, B::Divide>{}); break;
+    case B::Xor: f(std::integral_constant<B, B::Xor>{}); break;
+    }
+}
+
+struct PlanarImageComposite : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> fg = get_input<ImageObject>("Foreground");
+        std::shared_ptr<ImageObject const> bg = get_input<ImageObject>("Background");
+        auto colorOp = parseBlendOp(get_input2<std::string>("Blending Mode"));
+        auto alphaOp = parseBlendOp(get_input2<std::string>("Alpha Mode"));
+        float maskOpacity = get_input2<float>("Mask Opacity");
+        float opacity1 = get_input2<float>("Foreground Opacity");
+        float opacity2 = get_input2<float>("Background Opacity");
+        if (fg->w != bg->w || fg->h != bg->h)
+            throw zeno::makeError("PlanarImageComposite: Foreground and Background differ in size");
+        int w = fg->w, h = fg->h;
+        std::size_t stride = fg->stride;
+
+        // the mask is read from its first channel
+        float const *mask = nullptr;
+        std::shared_ptr<ImageObject const> maskImage;
+        if (has_input("Mask")) {
+            maskImage = get_input<ImageObject>("Mask");
+            if (maskImage->w != w || maskImage->h != h || !maskImage->channels())
+                throw zeno::makeError("PlanarImageComposite: Mask differs in size from the images");
+            mask = maskImage->data(0);
+        }
+        // a missing alpha is opaque
+        int fa = fg->findChannel("a"), ba = bg->findChannel("a");
+        ImageObject opaque(w, h);
+        opaque.addChannel("a", 1.f);
+        float const *alpha1 = fa >= 0 ? fg->data(fa) : opaque.data(0);
+        float const *alpha2 = ba >= 0 ? bg->data(ba) : opaque.data(0);
+
+        // the background's extra channels are passed through without copying
+        auto out = std::make_shared<ImageObject>(*bg);
+        float const *f[4], *b[4];
+        float *d[4];
+        int nc = 0;
+        for (auto name: {"r", "g", "b"}) {
+            int cf = fg->findChannel(name), cb = bg->findChannel(name);
+            if (cf < 0 || cb < 0)
+                throw zeno::makeError(std::string("PlanarImageComposite: missing channel ") + name);
+            f[nc] = fg->data(cf);
+            b[nc] = bg->data(cb);
+            d[nc++] = out->overwrite(cb);
+        }
+        float *dalpha = nullptr;
+        if (fa >= 0 || ba >= 0)
+            dalpha = out->overwrite(out->addChannel("a"));
+
+        visitBlendOp(colorOp, [&] (auto colorTag) {
+            constexpr BlendOp Op = decltype(colorTag)::value;
+            forEachRowTile(nc, h, [&] (int k, int y0, int y1) {
+                for (int y = y0; y < y1; y++) {
+                    std::size_t o = stride * y;
+                    for (int x = 0; x < w; x++) {
+                        float opacity = std::clamp((mask ? mask[o + x] : 1.f) * maskOpacity, 0.f, 1.f);
+                        float a1 = std::clamp(alpha1[o + x] * opacity1, 0.f, 1.f);
+                        float a2 = std::clamp(alpha2[o + x] * opacity2, 0.f, 1.f);
+                        float rgb2 = b[k][o + x];
+                        float v = blendOp<Op>(f[k][o + x] * opacity1, rgb2, rgb2 * opacity2, a1, a2);
+                        d[k][o + x] = v * opacity + rgb2 * (1 - opacity);
+                    }
+                }
+            });
+        });
+        if (dalpha) {
+            visitBlendOp(alphaOp, [&] (auto alphaTag) {
+                constexpr BlendOp Op = decltype(alphaTag)::value;
+                forEachRowTile(1, h, [&] (int, int y0, int y1) {
+                    for (int y = y0; y < y1; y++) {
+                        std::size_t o = stride * y;
+                        for (int x = 0; x < w; x++) {
+                            float opacity = std::clamp((mask ? mask[o + x] : 1.f) * maskOpacity, 0.f, 1.f);
+                            float a1 = alpha1[o + x] * opacity1, a2 = alpha2[o + x];
+                            float v = blendOp<Op>(a1, a2, a2 * opacity2, a1, a2);
+                            dalpha[o + x] = v * opacity + a2 * (1 - opacity);
+                        }
+                    }
+                });
+            });
+        }
+        set_output("image", out);
+    }
+};
+
+ZENDEFNODE(PlanarImageComposite, {
+    {
+        {"ImageObject", "Foreground"},
+        {"ImageObject", "Background"},
+        {"ImageObject", "Mask"},
+        {"enum Over Copy Under Atop In Out Screen Add Subtract Multiply Max(Lighten) Min(Darken) Average Difference Overlay SoftLight Divide Xor", "Blending Mode", "Over"},
+        {"enum Over Under Atop In Out Screen Add Subtract Multiply Max(Lighten) Min(Darken) Average Difference Xor", "Alpha Mode", "Over"},
+        {"float", "Mask Opacity", "1"},
+        {"float", "Foreground Opacity", "1"},
+        {"float", "Background Opacity", "1"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "comp" },
+});
+
+struct PlanarImageResize : INode {
+    virtual void apply() override {
+        std::shared_ptr<ImageObject const> image = get_input<ImageObject>("image");
+        int width = get_input2<int>("width");
+        int height = get_input2<int>("height");
+        auto filter = get_input2<std::string>("filter");
+        if (width <= 0 || height <= 0)
+            throw zeno::makeError("PlanarImageResize: size must be positive");
+        int w = image->w, h = image->h;
+        int nc = image->channels();
+
+        auto out = std::make_shared<ImageObject>(width, height);
+        for (int c = 0; c < nc; c++)
+            out->addChannel(image->channelName(c));
+
+        if (filter == "Area") {
+            for (int c = 0; c < nc; c++) {
+                cv::Mat dst = out->mat(c);
+                cv::resize(image->mat(c), dst, dst.size(), 0, 0, cv::INTER_AREA);
+            }
+            set_output("image", out);
+            return;
+        }
+
+        // pixel centers are aligned, the source coordinates of a column are the
+        // same for every row and channel
+        bool nearest = filter == "Nearest";
+        float scaleX = float(w) / width, scaleY = float(h) / height;
+        std::vector<int> x0(width), x1(width);
+        std::vector<float> fx(width);
+        for (int x = 0; x < width; x++) {
+            float sx = (x + 0.5f) * scaleX - 0.5f;
+            if (nearest)
+                sx = std::floor((x + 0.5f) * scaleX);
+            float fl = std::floor(sx);
+            x0[x] = std::clamp(int(fl), 0, w - 1);
+            x1[x] = std::clamp(int(fl) + 1, 0, w - 1);
+            fx[x] = nearest ? 0.f : sx - fl;
+        }
+        std::vector<float const *> src(nc);
+        std::vector<float *> dst(nc);
+        for (int c = 0; c < nc; c++) {
+            src[c] = image->data(c);
+            dst[c] = out->data(c);
+        }
+        forEachRowTile(nc, height, [&] (int c, int y0, int y1) {
+            for (int y = y0; y < y1; y++) {
+                float sy = nearest ? std::floor((y + 0.5f) * scaleY) : (y + 0.5f) * scaleY - 0.5f;
+                float fl = std::floor(sy);
+                float fy = nearest ? 0.f : sy - fl;
+                float const *r0 = src[c] + image->stride * std::clamp(int(fl), 0, h - 1);
+                float const *r1 = src[c] + image->stride * std::clamp(int(fl) + 1, 0, h - 1);
+                float *d = dst[c] + out->stride * y;
+                for (int x = 0; x < width; x++) {
+                    float top = r0[x0[x]] + (r0[x1[x]] - r0[x0[x]]) * fx[x];
+                    float bot = r1[x0[x]] + (r1[x1[x]] - r1[x0[x]]) * fx[x];
+                    d[x] = top + (bot - top) * fy;
+                }
+            }
+        });
+        set_output("image", out);
+    }
+};
+
+ZENDEFNODE(PlanarImageResize, {
+    {
+        {"ImageObject", "image"},
+        {"int", "width", "1024"},
+        {"int", "height", "1024"},
+        {"enum Bilinear Nearest Area", "filter", "Bilinear"},
+    },
+    {
+        {"ImageObject", "image"},
+    },
+    {},
+    { "image" },
+});
+
+}
+
+}
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <zeno/utils/log.h>
 #include <opencv2/opencv.hpp>
+#include "ImageObject.h"
 
 
 using namespace cv;
@@ -19,81 +20,6 @@ namespace zeno {
 
 namespace {
 
-static void RGBtoHSV(float r, float g, float b, float &h, float &s, float &v) {
-    float rd = r;
-    float gd = g;
-    float bd = b;
-    float cmax = fmax(rd, fmax(gd, bd));
-    float cmin = fmin(rd, fmin(gd, bd));
-    float delta = cmax - cmin;
-
-    if (delta != 0) {
-        if (cmax == rd) {
-            h = fmod((gd - bd) / delta, 6.0);
-        } else if (cmax == gd) {
-            h = (bd - rd) / delta + 2.0;
-        } else if (cmax == bd) {
-            h = (rd - gd) / delta + 4.0;
-        }
-        h *= 60.0;
-        if (h < 0) {
-            h += 360.0;
-        }
-    }
-    s = (cmax != 0) ? delta / cmax : 0.0;
-    v = cmax;
-}
-
-static void HSVtoRGB(float h, float s, float v, float &r, float &g, float &b)
-{
-    int i;
-    float f, p, q, t;
-    if( s == 0 ) {
-        // achromatic (grey)
-        r = g = b = v;
-        return;
-    }
-    h /= 60;            // sector 0 to 5
-    i = floor( h );
-    f = h - i;          // factorial part of h
-    p = v * ( 1 - s );
-    q = v * ( 1 - s * f );
-    t = v * ( 1 - s * ( 1 - f ) );
-    switch( i ) {
-        case 0:
-            r = v;
-            g = t;
-            b = p;
-            break;
-        case 1:
-            r = q;
-            g = v;
-            b = p;
-            break;
-        case 2:
-            r = p;
-            g = v;
-            b = t;
-            break;
-        case 3:
-            r = p;
-            g = q;
-            b = v;
-            break;
-        case 4:
-            r = t;
-            g = p;
-            b = v;
-            break;
-        default:        // case 5:
-            r = v;
-            g = p;
-            b = q;
-            break;
-    }
-}
-
-
 struct ImageResize: INode {//TODO::FIX BUG
     void apply() override {
         std::shared_ptr<PrimitiveObject> image = get_input<PrimitiveObject>("image");
@@ -574,6 +500,10 @@ struct ImageBlur : INode {
         auto &ud = image->userData();
         int w = ud.get2<int>("w");
         int h = ud.get2<int>("h");
+        // both blurs index verts as a w*h grid, the cv::Mat wraps them in place
+        if (w <= 0 || h <= 0 || image->verts.size() != (size_t)w * h)
+            throw zeno::makeError("ImageBlur: image has " + std::to_string(image->verts.size())
+                                  + " pixels, expect w*h = " + std::to_string(w) + "*" + std::to_string(h));
         auto img_out = std::make_shared<PrimitiveObject>();
         img_out->resize(w * h);
         img_out->userData().set2("w", w);
@@ -584,14 +514,9 @@ struct ImageBlur : INode {
             gaussBlur(image->verts, img_out->verts, w, h, sigmaX, 3);
         }
         else{//CV BLUR
-            cv::Mat imagecvin(h, w, CV_32FC3);
-            cv::Mat imagecvout(h, w, CV_32FC3);
-            for (auto a = 0; a < image->verts.size(); a++){
-                int i = a / w;
-                int j = a % w;
-                vec3f rgb = image->verts[i * w + j];
-                imagecvin.at<cv::Vec3f>(i, j) = {rgb[0], rgb[1], rgb[2]};
-            }
+            // vec3f verts are packed rgb floats, wrap them instead of copying
+            cv::Mat imagecvin(h, w, CV_32FC3, image->verts.data());
+            cv::Mat imagecvout(h, w, CV_32FC3, img_out->verts.data());
             if(kernelSize%2==0){
                 kernelSize += 1;
             }
@@ -613,12 +538,6 @@ struct ImageBlur : INode {
             else{
                 zeno::log_error("ImageBlur: Blur type does not exist");
             }
-            for (auto a = 0; a < image->verts.size(); a++){
-                int i = a / w;
-                int j = a % w;
-                cv::Vec3f rgb = imagecvout.at<cv::Vec3f>(i, j);
-                img_out->verts[i * w + j] = {rgb[0], rgb[1], rgb[2]};
-            }
         }
         set_output("image", img_out);
     }
@@ -0,0 +1,125 @@
+#include "NeighborGrid.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+using namespace zeno;
+
+void PBFNeighborGrid::build(const std::vector<vec3f> &pos, const vec3f &bmin, const vec3f &bmax,
+                            float radius, float cellSize)
+{
+    const int n = pos.size();
+    dx = std::max(cellSize, radius);
+    dxInv = 1.0f / dx;
+    origin = bmin;
+    res = zeno::max(toint(floor((bmax - bmin) * dxInv)) + 1, vec3i(1));
+    const int numCell = res[0] * res[1] * res[2];
+
+    //parallel cell binning: keys, histogram, prefix sum, scatter
+    cellKey.resize(n);
+    cellParticles.resize(n);
+    cellStart.assign(numCell + 1, 0);
+    std::vector<std::atomic<int>> cursor(numCell);
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++)
+    {
+        cellKey[i] = cellID(cellXYZ(pos[i]));
+        cursor[cellKey[i]].fetch_add(1, std::memory_order_relaxed);
+    }
+    int acc = 0;
+    for (int c = 0; c < numCell; c++)
+    {
+        cellStart[c] = acc;
+        acc += cursor[c].load(std::memory_order_relaxed);
+        cursor[c].store(cellStart[c], std::memory_order_relaxed);
+    }
+    cellStart[numCell] = acc;
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++)
+        cellParticles[cursor[cellKey[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+    //keep particles of a cell in index order so the result is deterministic
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int c = 0; c < numCell; c++)
+        if (cellStart[c + 1] - cellStart[c] > 1)
+            std::sort(cellParticles.begin() + cellStart[c], cellParticles.begin() + cellStart[c + 1]);
+
+    //two passes over the 27 cells: count, then fill the flat neighbour list
+    const float radius2 = radius * radius;
+    auto visit = [&](int i, auto &&f)
+    {
+        vec3i xyz = cellXYZ(pos[i]);
+        int x0 = std::max(xyz[0] - 1, 0), x1 = std::min(xyz[0] + 1, res[0] - 1);
+        for (int z = std::max(xyz[2] - 1, 0); z <= std::min(xyz[2] + 1, res[2] - 1); z++)
+            for (int y = std::max(xyz[1] - 1, 0); y <= std::min(xyz[1] + 1, res[1] - 1); y++)
+            {
+                //cells adjacent in x are adjacent in cellParticles
+                int row = res[0] * (y + res[1] * z);
+                for (int k = cellStart[row + x0]; k < cellStart[row + x1 + 1]; k++)
+                {
+                    int j = cellParticles[k];
+                    if (j != i && lengthSquared(pos[i] - pos[j]) < radius2)
+                        f(j);
+                }
+            }
+    };
+
+    neighborStart.resize(n + 1);
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++)
+    {
+        int cnt = 0;
+        visit(i, [&](int) { cnt++; });
+        neighborStart[i + 1] = cnt;
+    }
+    neighborStart[0] = 0;
+    for (int i = 0; i < n; i++)
+        neighborStart[i + 1] += neighborStart[i];
+
+    neighbors.resize(neighborStart[n]);
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++)
+    {
+        int k = neighborStart[i];
+        visit(i, [&](int j) { neighbors[k++] = j; });
+    }
+}
+
+namespace zeno{
+
+static unsigned expandBits(unsigned v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+std::vector<int> mortonOrder(const std::vector<vec3f> &pos, const vec3f &bmin, float dx)
+{
+    const int n = pos.size();
+    std::vector<unsigned> code(n);
+    const float dxInv = 1.0f / dx;
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++)
+    {
+        vec3i xyz = zeno::min(zeno::max(toint(floor((pos[i] - bmin) * dxInv)), vec3i(0)), vec3i(1023));
+        code[i] = (expandBits(xyz[0]) << 2) | (expandBits(xyz[1]) << 1) | expandBits(xyz[2]);
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return code[a] < code[b]; });
+    return order;
+}
+
+void reorderParticles(PrimitiveObject *prim, const std::vector<int> &order)
+{
+    prim->verts.forall_attr<AttrAcceptAll>([&](auto const &key, auto &arr)
+    {
+        auto old = arr;
+        #pragma omp parallel for
+        for (int i = 0; i < (int)order.size(); i++)
+            arr[i] = old[order[i]];
+    });
+}
+
+}//zeno
@@ -0,0 +1,62 @@
+#pragma once
+#include <zeno/utils/vec.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <vector>
+
+namespace zeno{
+
+/**
+ * @brief 均匀网格邻域搜索。粒子按网格计数排序（CSR），邻居表也是一个扁平的
+ * CSR 数组。所有缓冲区在多次调用间复用，粒子数不变时不会再分配内存。
+ */
+struct PBFNeighborGrid
+{
+    vec3f origin;
+    float dx = 1;
+    float dxInv = 1;
+    vec3i res{1, 1, 1};
+
+    //cell binning: particles of cell c are cellParticles[cellStart[c] .. cellStart[c+1])
+    std::vector<int> cellKey;
+    std::vector<int> cellStart;
+    std::vector<int> cellParticles;
+
+    //neighbours of particle i are neighbors[neighborStart[i] .. neighborStart[i+1])
+    std::vector<int> neighborStart;
+    std::vector<int> neighbors;
+
+    //cellSize is raised to radius if smaller, so that 27 cells always suffice
+    void build(const std::vector<vec3f> &pos, const vec3f &bmin, const vec3f &bmax,
+               float radius, float cellSize = 0);
+
+    int numNeighbors(int i) const
+    {
+        return neighborStart[i + 1] - neighborStart[i];
+    }
+
+    template <class F>
+    void forEachNeighbor(int i, F &&f) const
+    {
+        for (int k = neighborStart[i]; k < neighborStart[i + 1]; k++)
+            f(neighbors[k]);
+    }
+
+    vec3i cellXYZ(const vec3f &p) const
+    {
+        vec3i xyz = toint(floor((p - origin) * dxInv));
+        return zeno::min(zeno::max(xyz, vec3i(0)), res - 1);
+    }
+
+    int cellID(const vec3i &xyz) const
+    {
+        return xyz[0] + res[0] * (xyz[1] + res[1] * xyz[2]);
+    }
+};
+
+//permutation sorting particles along a Morton curve over cells of size dx
+std::vector<int> mortonOrder(const std::vector<vec3f> &pos, const vec3f &bmin, float dx);
+
+//reorder all vertex attributes of a point cloud so that new vertex i is old vertex order[i]
+void reorderParticles(PrimitiveObject *prim, const std::vector<int> &order);
+
+}//zeno
@@ -1,5 +1,4 @@
 #include "PBF.h"
-#include "CellHelpers.h"
 using namespace zeno;
 
 void PBF::preSolve()
@@ -53,21 +52,21 @@ void PBF::computeLambda()
     lambda.resize(numParticles);
     auto &pos = prim->verts;
 
-    for (size_t i = 0; i < numParticles; i++)
+    #pragma omp parallel for
+    for (int i = 0; i < numParticles; i++)
     {
         vec3f gradI{0.0, 0.0, 0.0};
         float sumSqr = 0.0;
         float densityCons = 0.0;
 
-        for (size_t j = 0; j < neighborList[i].size(); j++)
+        neighborGrid.forEachNeighbor(i, [&](int pj)
         {
-            int pj = neighborList[i][j];
             vec3f distVec = pos[i] - pos[pj];
             vec3f gradJ = kernelSpikyGradient(distVec, h);
             gradI += gradJ;
             sumSqr += dot(gradJ, gradJ);
             densityCons += kernelPoly6(length(distVec), h);
-        }
+        });
         densityCons = (mass * densityCons / rho0) - 1.0;
 
         //compute lambda
@@ -82,17 +81,17 @@ void PBF::computeDpos()
     dpos.resize(numParticles);
     auto &pos = prim->verts;
 
-    for (size_t i = 0; i < numParticles; i++)
+    #pragma omp parallel for
+    for (int i = 0; i < numParticles; i++)
     {
         vec3f dposI{0.0, 0.0, 0.0};
-        for (size_t j = 0; j < neighborList[i].size(); j++)
+        neighborGrid.forEachNeighbor(i, [&](int pj)
         {
-            int pj = neighborList[i][j];
             vec3f distVec = pos[i] - pos[pj];
 
             float sCorr = computeScorr(distVec, coeffDq, coeffK, h);
             dposI += (lambda[i] + lambda[pj] + sCorr) * kernelSpikyGradient(distVec, h);
-        }
+        });
         dposI /= rho0;
         dpos[i] = dposI;
     }
@@ -116,4 +115,25 @@ void PBF::postSolve()
         vel[i] = (pos[i] - oldPos[i]) / dt;
 }
 
-
+namespace zeno {
+ZENDEFNODE(PBF, {   
+                    {
+                        {"PrimitiveObject", "prim"},
+                        {"float", "dx", "2.51"},
+                        {"vec3f", "bounds_max", "40, 40, 40"},
+                        {"vec3f", "bounds_min", "0,0,0"},
+                        {"int", "numSubsteps", "5"},
+                        {"float", "particle_radius", "3.0"},
+                        {"float", "dt", "0.05"},
+                        {"vec3f", "gravity", "0, -10, 0"},
+                        {"float", "mass", "1.0"},
+                        {"float", "rho0", "1.0"},
+                        {"float", "coeffDq", "0.3"},
+                        {"float", "coeffK", "0.001"},
+                        {"float", "lambdaEpsilon", "100.0"}
+                    },
+                    {   {"PrimitiveObject", "outPrim"} },
+                    {},
+                    {"PBD"},
+                });
+}//namespace zeno
@@ -4,6 +4,7 @@
 #include <map>
 #include <zeno/types/PrimitiveObject.h>
 #include "SPHKernelFuncs.h"
+#include "NeighborGrid.h"
 
 namespace zeno{
 struct PBF : INode{
@@ -47,30 +48,13 @@ private:
     void boundaryHandling(vec3f &p);
     inline float computeScorr(const vec3f& distVec, float coeffDq, float coeffK, float h);
 
-    //data for cells
-    inline vec3i getCellXYZ(const vec3f& p);
-    inline int getCellID(const vec3f& p);
-    inline int getCellHash(int i, int j, int k);
-    inline bool isInBound(const vec3i& cell);
-    inline int cellXYZ2ID(const vec3i& xyz);
-    inline vec3i cellID2XYZ(int i);
-    std::array<int, 3> numCellXYZ;
-    int numCell;
+    //neighborhood, rebuilt once per step and shared by all substeps
     float dx; //cell size
-    float dxInv; 
-    void initCellData();
-    void initNeighborList();
-    struct Cell
-    {
-        int x,y,z;
-        std::vector<int> parInCell; 
-    };
-    std::map<int, Cell>  cell;
-
-    //neighborList
-    std::vector<std::vector<int>> neighborList;
+    PBFNeighborGrid neighborGrid;
     void neighborSearch();
 
+    bool firstTime = true;
+
 public:
     void setParams()
     {
@@ -99,7 +83,6 @@ public:
         prim = get_input<PrimitiveObject>("prim");
         auto &pos = prim->verts;
 
-        static bool firstTime = true;
         if(firstTime == true)
         {
             firstTime = false;
@@ -111,9 +94,6 @@ public:
             vel.resize(numParticles);
             lambda.resize(numParticles);
             dpos.resize(numParticles);
-
-            initCellData();
-            initNeighborList(); 
         }
 
         preSolve();
@@ -126,24 +106,4 @@ public:
     }
 };
 
-ZENDEFNODE(PBF, {   
-                    {
-                        {"PrimitiveObject", "prim"},
-                        {"float", "dx", "2.51"},
-                        {"vec3f", "bounds_max", "40, 40, 40"},
-                        {"vec3f", "bounds_min", "0,0,0"},
-                        {"int", "numSubsteps", "5"},
-                        {"float", "particle_radius", "3.0"},
-                        {"float", "dt", "0.05"},
-                        {"vec3f", "gravity", "0, -10, 0"},
-                        {"float", "mass", "1.0"},
-                        {"float", "rho0", "1.0"},
-                        {"float", "coeffDq", "0.3"},
-                        {"float", "coeffK", "0.001"},
-                        {"float", "lambdaEpsilon", "100.0"}
-                    },
-                    {   {"PrimitiveObject", "outPrim"} },
-                    {},
-                    {"PBD"},
-                });
 }//namespace zeno
\ No newline at end of file
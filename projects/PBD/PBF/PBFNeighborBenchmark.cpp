@@ -0,0 +1,77 @@
+#include <zeno/zeno.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/UserData.h>
+#include <zeno/utils/log.h>
+#include "NeighborGrid.h"
+#include <chrono>
+using namespace zeno;
+
+/**
+ * @brief 邻域搜索的性能测试：对输入粒子重复建立邻居表，输出平均耗时与平均邻居数。
+ * 可选先按 Morton 曲线重排粒子（只重排输出的副本，输入 prim 保持不变）。
+ */
+struct PBFNeighborSearchBenchmark : INode{
+
+    virtual void apply() override{
+        //在副本上重排和写 userData，不改动上游的 prim
+        auto prim = std::make_shared<PrimitiveObject>(*get_input<PrimitiveObject>("prim"));
+        auto radius = get_input2<float>("radius");
+        auto iterations = std::max(get_input2<int>("iterations"), 1);
+        auto &pos = prim->verts;
+
+        vec3f bmin(0), bmax(0);
+        if (pos.size())
+        {
+            bmin = bmax = pos[0];
+            for (size_t i = 1; i < pos.size(); i++)
+            {
+                bmin = zeno::min(bmin, pos[i]);
+                bmax = zeno::max(bmax, pos[i]);
+            }
+        }
+
+        using clock = std::chrono::steady_clock;
+        if (get_input2<bool>("mortonReorder"))
+        {
+            auto t0 = clock::now();
+            reorderParticles(prim.get(), mortonOrder(pos, bmin, radius));
+            auto ms = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+            log_info("PBFNeighborSearchBenchmark: morton reorder {} ms", ms);
+        }
+
+        PBFNeighborGrid grid;
+        //first build allocates, the timed ones reuse the buffers like substeps do
+        grid.build(pos, bmin, bmax, radius);
+        auto t0 = clock::now();
+        for (int it = 0; it < iterations; it++)
+            grid.build(pos, bmin, bmax, radius);
+        auto ms = std::chrono::duration<float, std::milli>(clock::now() - t0).count() / iterations;
+
+        float avgNeighbors = pos.size() ? (float)grid.neighbors.size() / pos.size() : 0.f;
+        log_info("PBFNeighborSearchBenchmark: {} particles, {} ms per search, {} neighbors on average",
+                 pos.size(), ms, avgNeighbors);
+
+        prim->userData().set2("neighborSearchTime", ms);
+        prim->userData().set2("avgNeighbors", avgNeighbors);
+        set_output("outPrim", std::move(prim));
+        set_output2("time", ms);
+        set_output2("avgNeighbors", avgNeighbors);
+    }
+};
+
+ZENDEFNODE(PBFNeighborSearchBenchmark, {
+    {
+        {"PrimitiveObject", "prim"},
+        {"float", "radius", "1.1"},
+        {"int", "iterations", "10"},
+        {"bool", "mortonReorder", "0"},
+    },
+    {
+        {"PrimitiveObject", "outPrim"},
+        {"float", "time"},
+        {"float", "avgNeighbors"},
+    },
+    {},
+    {"PBD"},
+});
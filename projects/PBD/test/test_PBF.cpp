@@ -0,0 +1,72 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/zeno.h>
+#include <zeno/core/Graph.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/NumericObject.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <omp.h>
+
+using namespace zeno;
+
+//10x10x10的粒子块，在默认参数下下落numFrames帧，返回最终位置
+static std::vector<vec3f> runPBF(int numThreads, int numFrames)
+{
+    omp_set_num_threads(numThreads);
+    //boundaryHandling用rand()扰动，固定种子使两次运行可比
+    std::srand(0);
+
+    auto prim = std::make_shared<PrimitiveObject>();
+    for (int z = 0; z < 10; z++)
+        for (int y = 0; y < 10; y++)
+            for (int x = 0; x < 10; x++)
+                prim->verts.push_back(vec3f(10 + x, 10 + y, 10 + z));
+
+    auto graph = getSession().createGraph();
+    graph->addNode("PBF", "pbf");
+    graph->setNodeInput("pbf", "prim", prim);
+    //与ZENDEFNODE中的默认值相同
+    auto param = [&](const char *name, auto value)
+    {
+        graph->setNodeInput("pbf", name, std::make_shared<NumericObject>(value));
+    };
+    param("dx", 2.51f);
+    param("bounds_max", vec3f(40, 40, 40));
+    param("bounds_min", vec3f(0, 0, 0));
+    param("particle_radius", 3.0f);
+    param("dt", 0.05f);
+    param("gravity", vec3f(0, -10, 0));
+    param("rho0", 1.0f);
+    param("coeffDq", 0.3f);
+    param("coeffK", 0.001f);
+    param("lambdaEpsilon", 100.0f);
+    for (int frame = 0; frame < numFrames; frame++)
+        graph->applyNodes({"pbf"});
+    return safe_dynamic_cast<PrimitiveObject>(graph->getNodeOutput("pbf", "outPrim"))->verts.values;
+}
+
+TEST_CASE("test_PBF_parallel_solve", "[PBF]")
+{
+    auto serial = runPBF(1, 10);
+    auto parallel = runPBF(4, 10);
+    REQUIRE(serial.size() == 1000);
+    REQUIRE(parallel.size() == serial.size());
+
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        for (int d = 0; d < 3; d++)
+        {
+            REQUIRE(std::isfinite(serial[i][d]));
+            //默认边界0~40，粒子半径3
+            REQUIRE(serial[i][d] >= 3.0f);
+            REQUIRE(serial[i][d] <= 37.0f);
+            //每个粒子只写自己的lambda和dpos，线程数不影响结果
+            REQUIRE(parallel[i][d] == serial[i][d]);
+        }
+    }
+    //粒子在重力作用下下落
+    REQUIRE(serial[0][1] < 10.0f);
+}
@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/utils/vec.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../PBF/NeighborGrid.h"
+#include "../Utils/readFile.h"
+
+using namespace zeno;
+
+#ifndef PBD_TEST_PATH
+#define PBD_TEST_PATH ""
+#endif
+
+//每行一个粒子的邻居下标，以制表符分隔（printVectorField的格式）
+static std::vector<std::vector<int>> readNeighborList(const std::string &path)
+{
+    std::vector<std::vector<int>> list;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream ss(line);
+        std::vector<int> nei;
+        int j;
+        while (ss >> j)
+            nei.push_back(j);
+        std::sort(nei.begin(), nei.end());
+        list.push_back(std::move(nei));
+    }
+    return list;
+}
+
+static void boundingBox(const std::vector<vec3f> &pos, vec3f &bmin, vec3f &bmax)
+{
+    bmin = bmax = pos[0];
+    for (auto const &p : pos)
+    {
+        bmin = zeno::min(bmin, p);
+        bmax = zeno::max(bmax, p);
+    }
+}
+
+//与test_NeighborSearch_BVH相同的输入和搜索半径，期望输出是它的neighborList_out4.csv
+TEST_CASE("test_PBFNeighborGrid_BVH_reference", "[PBF]")
+{
+    std::vector<vec3f> pos;
+    readVectorField(PBD_TEST_PATH "input_data/pos_input_neighborBVH.csv", pos);
+    auto expected = readNeighborList(PBD_TEST_PATH "neighborList_out4.csv");
+    REQUIRE(pos.size() == 10000);
+    REQUIRE(expected.size() == pos.size());
+
+    vec3f bmin, bmax;
+    boundingBox(pos, bmin, bmax);
+    const float searchRadius = 1.155f;
+
+    PBFNeighborGrid grid;
+    //单元格比半径小时会被放大到半径，结果应当一样
+    for (float cellSize : {0.f, 0.5f, 2.f})
+    {
+        grid.build(pos, bmin, bmax, searchRadius, cellSize);
+        REQUIRE(grid.neighborStart.size() == pos.size() + 1);
+        for (int i = 0; i < (int)pos.size(); i++)
+        {
+            std::vector<int> nei;
+            grid.forEachNeighbor(i, [&](int j) { nei.push_back(j); });
+            std::sort(nei.begin(), nei.end());
+            INFO("particle " << i << " cellSize " << cellSize);
+            REQUIRE(nei == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("test_PBFNeighborGrid_rebuild", "[PBF]")
+{
+    //粒子数不变时重建不应分配内存，且移动后的结果与新建的网格一致
+    std::vector<vec3f> pos;
+    for (int z = 0; z < 10; z++)
+        for (int y = 0; y < 10; y++)
+            for (int x = 0; x < 10; x++)
+                pos.push_back(vec3f(x, y, z) * 0.5f);
+    vec3f bmin, bmax;
+    boundingBox(pos, bmin, bmax);
+
+    PBFNeighborGrid grid;
+    grid.build(pos, bmin, bmax, 0.6f);
+    //内部粒子有6个邻居
+    REQUIRE(grid.numNeighbors(5 + 10 * (5 + 10 * 5)) == 6);
+    auto *neighborsData = grid.neighbors.data();
+
+    for (auto &p : pos)
+        p = vec3f(p[1], p[2], p[0]);
+    grid.build(pos, bmin, bmax, 0.6f);
+    REQUIRE(grid.neighbors.data() == neighborsData);
+
+    PBFNeighborGrid fresh;
+    fresh.build(pos, bmin, bmax, 0.6f);
+    REQUIRE(grid.neighborStart == fresh.neighborStart);
+    REQUIRE(grid.neighbors == fresh.neighbors);
+}
@@ -9,12 +9,11 @@
 #include <igl/directed_edge_parents.h>
 #include <igl/forward_kinematics.h>
 #include <igl/deform_skeleton.h>
-#include <igl/dqs.h>
-
-
-#include <igl/lbs_matrix.h>
 
 #include "skinning_iobject.h"
+#include "skinning_weights.h"
+
+#include <utility>
 
 namespace{
 using namespace zeno;
@@ -80,13 +79,8 @@ struct DoSkinning : zeno::INode {
         auto Ts_ = get_input<zeno::ListObject>("Ts")->get<NumericObject>();
 
         // std::cout << "GOT QS AND TS INPUT" << std::endl;
-        size_t dim = 3;
         size_t nm_handles = 0;
 
-
-        auto& out_chan = shape->add_attr<zeno::vec3f>(outputChannel);
-        // std::cout << "CHECKOUT_1" << std::endl;
-
         while(true){
             std::string attr_name = attr_prefix + "_" + std::to_string(nm_handles);
             if(shape->has_attr(attr_name)){
@@ -96,21 +90,42 @@ struct DoSkinning : zeno::INode {
             break;
         }
 
-        Eigen::MatrixXd W;
-        W.resize(shape->size(),nm_handles);
-        for(size_t i = 0;i < nm_handles;++i){ 
-            std::string attr_name = attr_prefix +  "_" + std::to_string(i);
-            for(size_t j = 0;j < shape->size();++j){
-                if(!shape->has_attr(attr_name)){
-                    std::cout << "DO NOT HAVE " << attr_name << std::endl;
-                    std::cout << "NM_QS_AND_TS : " << nm_handles << std::endl;
-                    throw std::runtime_error("The Skinned Prim Does Not Have Weight Attr");
-                }
-                W(j,i) = shape->attr<float>(attr_name)[j];
-                if(std::isnan(W(j,i))){
-                    std::cout << "NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX : " << j << "\t" << i << "\t" << W(j,i) << std::endl;
+        // the weight generators store the top-K weights <prefix>_idx/_w, which are
+        // used as they are. dense <prefix>_<i> channels from elsewhere are reduced
+        // once and the result is kept on the node until the channels change; the
+        // input prim is shared with other nodes, so it is not written to
+        const auto& verts = std::as_const(shape->verts);
+        bool has_sparse = shape->has_attr(SparseSkinningIndexAttr(attr_prefix)) && shape->has_attr(SparseSkinningWeightAttr(attr_prefix));
+        bool from_dense = !has_sparse && nm_handles > 0;
+        if(from_dense){
+            if(!denseCacheValid(verts,attr_prefix,nm_handles)){
+                std::vector<const float*> W(nm_handles);
+                for(size_t i = 0;i < nm_handles;++i)
+                    W[i] = verts.attr<float>(attr_prefix + "_" + std::to_string(i)).data();
+                ComputeSparseSkinningWeights(shape->size(),nm_handles,[&](size_t v,size_t h){
+                    return W[h][v];
+                },sparse_idx,sparse_w);
+                dense_attrs = verts.attrs;
+                dense_prefix = attr_prefix;
+            }
+        }else if(!has_sparse){
+            throw std::runtime_error("The Skinned Prim Does Not Have Weight Attr");
+        }else{
+            nm_handles = std::min(Qs_.size(),Ts_.size());
+        }
+
+        const auto& w_idx = from_dense ? sparse_idx : verts.attr<zeno::vec4i>(SparseSkinningIndexAttr(attr_prefix));
+        const auto& w_val = from_dense ? sparse_w : verts.attr<zeno::vec4f>(SparseSkinningWeightAttr(attr_prefix));
+        for(size_t i = 0;i < shape->size();++i){
+            for(int k = 0;k < kSkinInfluences;++k){
+                if(std::isnan(w_val[i][k])){
+                    std::cout << "NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX : " << i << "\t" << w_idx[i][k] << "\t" << w_val[i][k] << std::endl;
                     throw std::runtime_error("NAN VALUE DETECTED IN SKINNING WEIGHT MATRIX");
                 }
+                if(w_idx[i][k] >= (int)nm_handles || w_idx[i][k] >= (int)Qs_.size() || w_idx[i][k] >= (int)Ts_.size()){
+                    std::cout << "HANDLE : " << w_idx[i][k] << "\tNM_QS_AND_TS : " << Qs_.size() << std::endl;
+                    throw std::runtime_error("The Skinning Weights Refer To More Handles Than Given Qs And Ts");
+                }
             }
         }
 
@@ -188,60 +203,51 @@ struct DoSkinning : zeno::INode {
 
         // std::cout << "CHECKOUT_3" << std::endl;
 
-        Eigen::MatrixXd T(nm_handles*(dim+1),dim);
-        for(int e = 0;e<nm_handles;e++){
-            Eigen::Affine3d a = Eigen::Affine3d::Identity();
-            a.translate(Ts[e]);
-            a.rotate(Qs[e]);
-            T.block(e*(dim+1),0,dim+1,dim) =
-                a.matrix().transpose().block(0,0,dim+1,dim);
+        for(size_t i = 0;i < nm_handles;++i){
+            if(std::isnan(Ts[i].norm()) || std::isnan(Qs[i].coeffs().norm())){
+                std::cout << "T<" << i << "> : " << Ts[i].transpose() << std::endl;
+                std::cout << "Q<" << i << "> : " << Qs[i].coeffs().transpose() << std::endl;
+                throw std::runtime_error("IN SKINNING NAN TRANSFORMATION DETECTED");
+            }
         }
-        // Compute deformation via LBS as matrix multiplication
-        Eigen::MatrixXd U,V;
-        V.resize(shape->size(),3);
-        for(size_t i = 0;i < V.rows();++i)
-            V.row(i) << shape->verts[i][0],shape->verts[i][1],shape->verts[i][2];
+        SkinningTransforms xforms(Qs,Ts);
 
-
-        if(std::isnan(V.norm()) || std::isnan(W.norm()) || std::isnan(T.norm())){
-            std::cout << V.norm() << "\t" << W.norm() << std::endl;
-            throw std::runtime_error("IN SKINNING NAN VW DETECTED");
-        }
+        auto deformed_shape = std::make_shared<zeno::PrimitiveObject>(*shape);// automatic copy all the attributes
+        auto& out_chan = deformed_shape->add_attr<zeno::vec3f>(outputChannel);
+        out_chan.resize(deformed_shape->size());
 
         if(algorithm == "DQS"){
             // std::cout << "DQS SKINNING " << std::endl;
-            igl::dqs(V,W,Qs,Ts,U);
+            DualQuaternionSkinning(xforms,shape->verts.values,w_idx,w_val,out_chan);
         }else if(algorithm == "LBS"){
-            Eigen::MatrixXd M;
-            igl::lbs_matrix(V,W,M);
-            U = M*T;
-        }        
-
-        auto deformed_shape = std::make_shared<zeno::PrimitiveObject>(*shape);// automatic copy all the attributes
-        // deformed_shape->resize(shape->size());
-        // deformed_shape->tris.resize(shape->tris.size());
-        // deformed_shape->quads.resize(shape->quads.size());
-
-        if(std::isnan(U.norm())){
-            std::cout << "W : \n" << W << std::endl;
-            std::cout << "NAN DEFORMED SHAPE DETECTED: " << U.norm() << std::endl;
-            std::cout << "AFFINE : " << std::endl;
-            for(size_t i = 0;i < nm_handles;++i){
-                std::cout << Qs[i].x() << "\t" 
-                            << Qs[i].y() << "\t" 
-                            << Qs[i].z() << "\t" 
-                            << Qs[i].w() << std::endl;
-                std::cout << Ts[i].transpose() << std::endl;
-            }
-
-            throw std::runtime_error("NAN DEFORMED SHAPE DETECTED");
+            LinearBlendSkinning(xforms,shape->verts.values,w_idx,w_val,out_chan);
         }
-        // std::cout << "CHECKOUT_4" << std::endl;
-        for(size_t i = 0;i < deformed_shape->size();++i)
-            out_chan[i] = zeno::vec3f(U.row(i)[0],U.row(i)[1],U.row(i)[2]);
 
         set_output("dshape",std::move(deformed_shape));
     }
+
+    // the top-K reduction of the dense channels it was computed from. dense_attrs
+    // shares those arrays copy-on-write, so writing any of them since unshares it
+    // and the arrays of the input differ from the ones kept here
+    zeno::AttrVector<zeno::vec3f>::AttrMap dense_attrs;
+    std::string dense_prefix;
+    std::vector<zeno::vec4i> sparse_idx;
+    std::vector<zeno::vec4f> sparse_w;
+
+    bool denseCacheValid(const zeno::AttrVector<zeno::vec3f>& verts,const std::string& prefix,size_t nm_handles) const {
+        if(prefix != dense_prefix || sparse_idx.size() != verts.size())
+            return false;
+        // computed from more channels than the input has now
+        if(dense_attrs.count(prefix + "_" + std::to_string(nm_handles)))
+            return false;
+        for(size_t i = 0;i < nm_handles;++i){
+            std::string channel_name = prefix + "_" + std::to_string(i);
+            auto cached = dense_attrs.peek(channel_name);
+            if(!cached || cached != verts.attrs.peek(channel_name))
+                return false;
+        }
+        return true;
+    }
 };
 
 ZENDEFNODE(DoSkinning, {
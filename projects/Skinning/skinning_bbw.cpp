@@ -12,6 +12,7 @@
 #include <igl/project_to_line.h>
 
 #include "skinning_iobject.h"
+#include "skinning_weights.h"
 #include "LBFGSB.h"
 
 
@@ -72,11 +73,18 @@ struct SolveBiharmonicWeight : zeno::INode {
         //assert(W.rows() == V.rows() && W.cols() == C.rows());
         igl::normalize_row_sums(W,W);
 
-        for(size_t i = 0;i < W.cols();++i){
-            std::string channel_name = attr_prefix + "_" + std::to_string(i);
-            auto& c = mesh->add_attr<float>(channel_name);
-            for(size_t j = 0;j < W.rows();++j){
-                c[j] = W(j,i);
+        // DoSkinning reads the top-K weights, the dense <prefix>_<i> channels are
+        // still written for graphs that inspect or edit them, unless turned off
+        StoreSparseSkinningWeights(mesh.get(),attr_prefix,W.cols(),[&](size_t v,size_t h){
+            return (float)W(v,h);
+        });
+        if(get_param<int>("dense_channels")){
+            for(size_t i = 0;i < W.cols();++i){
+                std::string channel_name = attr_prefix + "_" + std::to_string(i);
+                auto& c = mesh->add_attr<float>(channel_name);
+                for(size_t j = 0;j < W.rows();++j){
+                    c[j] = W(j,i);
+                }
             }
         }
         set_output("mesh",mesh);
@@ -88,6 +96,7 @@ ZENDEFNODE(SolveBiharmonicWeight, {
     {"mesh"},
     {
         {"string","attr_prefix","sw"},
+        {"int","dense_channels","1"},
     },
     {"Skinning"},
 });
@@ -170,19 +179,26 @@ struct GenerateSkinningWeight : zeno::INode {
         assert(W.rows() == V.rows() && W.cols() == C.rows());
         igl::normalize_row_sums(W,W);
 
-        // add weight channel
-
-        for(size_t i = 0;i < W.cols()/duplicate;++i){
-            std::string channel_name = attr_prefix + "_" + std::to_string(i);
-            std::cout << "add channels " << channel_name << std::endl;
-            auto& c = mesh->add_attr<float>(channel_name);
-
-            for(size_t j = 0;j < W.rows();++j){
-                c[j] = 0;
-                for(size_t k = 0;k < duplicate;++k){
-                    c[j] += W(j,i*duplicate + k);
+        // add weight channels, both layouts (see SolveBiharmonicWeight)
+        StoreSparseSkinningWeights(mesh.get(),attr_prefix,W.cols()/duplicate,[&](size_t v,size_t h){
+            float w = 0;
+            for(size_t k = 0;k < duplicate;++k)
+                w += W(v,h*duplicate + k);
+            return w;
+        });
+        if(get_param<int>("dense_channels")){
+            for(size_t i = 0;i < W.cols()/duplicate;++i){
+                std::string channel_name = attr_prefix + "_" + std::to_string(i);
+                std::cout << "add channels " << channel_name << std::endl;
+                auto& c = mesh->add_attr<float>(channel_name);
+
+                for(size_t j = 0;j < W.rows();++j){
+                    c[j] = 0;
+                    for(size_t k = 0;k < duplicate;++k){
+                        c[j] += W(j,i*duplicate + k);
+                    }
+                    // std::cout << W(j,0) << std::endl;
                 }
-                // std::cout << W(j,0) << std::endl;
             }
         }
         set_output("mesh",mesh);
@@ -359,7 +375,8 @@ ZENDEFNODE(GenerateSkinningWeight, {
         {"float","sp_radius","1e-6"},
         {"float","bone_radius","1e-6"},
         {"float","cage_radius","1e-6"},
-        {"float","duplicate","1.0"}
+        {"float","duplicate","1.0"},
+        {"int","dense_channels","1"},
     },
     {"Skinning"},
 });
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <zeno/zeno.h>
+#include <zeno/PrimitiveObject.h>
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "skinning_iobject.h"
+
+namespace {
+using namespace zeno;
+
+// the skinning weights of a vertex are its kSkinInfluences largest handle weights,
+// stored as two attributes <prefix>_idx (vec4i, -1 for an unused slot) and
+// <prefix>_w (vec4f), renormalized to sum up to one
+constexpr int kSkinInfluences = 4;
+
+inline std::string SparseSkinningIndexAttr(const std::string& prefix) {
+    return prefix + "_idx";
+}
+
+inline std::string SparseSkinningWeightAttr(const std::string& prefix) {
+    return prefix + "_w";
+}
+
+// weight(v,h) returns the dense weight of handle h at vertex v
+template <class GetWeight>
+void ComputeSparseSkinningWeights(size_t nm_verts,size_t nm_handles,GetWeight&& weight,
+    std::vector<zeno::vec4i>& idx,std::vector<zeno::vec4f>& w) {
+    idx.resize(nm_verts);
+    w.resize(nm_verts);
+
+    #pragma omp parallel for
+    for(size_t v = 0;v < nm_verts;++v){
+        int best_i[kSkinInfluences];
+        float best_w[kSkinInfluences];
+        std::fill(best_i,best_i + kSkinInfluences,-1);
+        std::fill(best_w,best_w + kSkinInfluences,0.f);
+        for(size_t h = 0;h < nm_handles;++h){
+            float wh = weight(v,h);
+            if(!(wh > best_w[kSkinInfluences - 1]))
+                continue;
+            int k = kSkinInfluences - 1;
+            for(;k > 0 && wh > best_w[k - 1];--k){
+                best_w[k] = best_w[k - 1];
+                best_i[k] = best_i[k - 1];
+            }
+            best_w[k] = wh;
+            best_i[k] = (int)h;
+        }
+        float sum = 0;
+        for(int k = 0;k < kSkinInfluences;++k)
+            sum += best_w[k];
+        for(int k = 0;k < kSkinInfluences;++k){
+            idx[v][k] = best_i[k];
+            w[v][k] = sum > 0 ? best_w[k] / sum : 0.f;
+        }
+    }
+}
+
+template <class GetWeight>
+void StoreSparseSkinningWeights(PrimitiveObject* mesh,const std::string& prefix,size_t nm_handles,GetWeight&& weight) {
+    std::vector<zeno::vec4i> idx;
+    std::vector<zeno::vec4f> w;
+    ComputeSparseSkinningWeights(mesh->size(),nm_handles,weight,idx,w);
+    mesh->add_attr<zeno::vec4i>(SparseSkinningIndexAttr(prefix)) = std::move(idx);
+    mesh->add_attr<zeno::vec4f>(SparseSkinningWeightAttr(prefix)) = std::move(w);
+}
+
+// the rigid transformation of every handle, converted once per evaluation
+struct SkinningTransforms {
+    // row major 3x4 affine matrices for linear blending
+    std::vector<std::array<float,12>> affine;
+    // unit dual quaternions (x,y,z,w) of real and dual part for DQS
+    std::vector<std::array<float,8>> dualQuat;
+
+    SkinningTransforms(const RotationList& Qs,const std::vector<Eigen::Vector3d>& Ts) {
+        size_t nm_handles = Qs.size();
+        affine.resize(nm_handles);
+        dualQuat.resize(nm_handles);
+        for(size_t h = 0;h < nm_handles;++h){
+            Eigen::Matrix3d R = Qs[h].toRotationMatrix();
+            for(int r = 0;r < 3;++r){
+                for(int c = 0;c < 3;++c)
+                    affine[h][r * 4 + c] = (float)R(r,c);
+                affine[h][r * 4 + 3] = (float)Ts[h][r];
+            }
+            Eigen::Quaterniond qe = Eigen::Quaterniond(0,Ts[h][0],Ts[h][1],Ts[h][2]) * Qs[h];
+            dualQuat[h] = {(float)Qs[h].x(),(float)Qs[h].y(),(float)Qs[h].z(),(float)Qs[h].w(),
+                (float)(0.5 * qe.x()),(float)(0.5 * qe.y()),(float)(0.5 * qe.z()),(float)(0.5 * qe.w())};
+        }
+    }
+};
+
+// blend the handle matrices of every vertex, then apply the blended matrix once
+inline void LinearBlendSkinning(const SkinningTransforms& xforms,
+    const std::vector<zeno::vec3f>& pos,
+    const std::vector<zeno::vec4i>& idx,
+    const std::vector<zeno::vec4f>& w,
+    std::vector<zeno::vec3f>& out) {
+        size_t nm_verts = pos.size();
+        #pragma omp parallel for
+        for(size_t v = 0;v < nm_verts;++v){
+            float M[12] = {};
+            for(int k = 0;k < kSkinInfluences;++k){
+                if(idx[v][k] < 0)
+                    continue;
+                const float* A = xforms.affine[idx[v][k]].data();
+                float wk = w[v][k];
+                #pragma omp simd
+                for(int e = 0;e < 12;++e)
+                    M[e] += wk * A[e];
+            }
+            const auto& p = pos[v];
+            out[v] = zeno::vec3f(
+                M[0] * p[0] + M[1] * p[1] + M[2] * p[2] + M[3],
+                M[4] * p[0] + M[5] * p[1] + M[6] * p[2] + M[7],
+                M[8] * p[0] + M[9] * p[1] + M[10] * p[2] + M[11]);
+        }
+}
+
+// dual quaternion skinning, same as igl::dqs plus flipping antipodal quaternions
+inline void DualQuaternionSkinning(const SkinningTransforms& xforms,
+    const std::vector<zeno::vec3f>& pos,
+    const std::vector<zeno::vec4i>& idx,
+    const std::vector<zeno::vec4f>& w,
+    std::vector<zeno::vec3f>& out) {
+        size_t nm_verts = pos.size();
+        #pragma omp parallel for
+        for(size_t v = 0;v < nm_verts;++v){
+            float B[8] = {};
+            const float* Q0 = nullptr;
+            for(int k = 0;k < kSkinInfluences;++k){
+                if(idx[v][k] < 0)
+                    continue;
+                const float* Q = xforms.dualQuat[idx[v][k]].data();
+                float wk = w[v][k];
+                if(!Q0)
+                    Q0 = Q;
+                else if(Q0[0] * Q[0] + Q0[1] * Q[1] + Q0[2] * Q[2] + Q0[3] * Q[3] < 0)
+                    wk = -wk;
+                #pragma omp simd
+                for(int e = 0;e < 8;++e)
+                    B[e] += wk * Q[e];
+            }
+            const auto& p = pos[v];
+            float len = std::sqrt(B[0] * B[0] + B[1] * B[1] + B[2] * B[2] + B[3] * B[3]);
+            if(!(len > 0)){
+                out[v] = p;
+                continue;
+            }
+            float inv = 1 / len;
+            zeno::vec3f d0(B[0] * inv,B[1] * inv,B[2] * inv);
+            zeno::vec3f de(B[4] * inv,B[5] * inv,B[6] * inv);
+            float a0 = B[3] * inv,ae = B[7] * inv;
+            out[v] = p + 2.f * zeno::cross(d0,zeno::cross(d0,p) + a0 * p)
+                + 2.f * (a0 * de - ae * d0 + zeno::cross(d0,de));
+        }
+}
+
+};
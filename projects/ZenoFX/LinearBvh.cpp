@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <atomic>
 #include <exception>
+#include <cstring>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <zeno/zeno.h>
 #if defined(_OPENMP)
@@ -838,4 +840,198 @@ vec3f LBvh::retrievePrimitiveCenter(Ti eid, const TV &w) const {
   return ret;
 }
 
+/// tree cache
+namespace {
+
+// trees currently alive, so that nodes asking for the same unchanged
+// primitive share one; entries go away with the last node holding the tree
+struct SharedTree {
+  std::weak_ptr<LBvh> bvh;
+  std::weak_ptr<const PrimitiveObject> prim;
+  LBvh::element_e et;
+  float thickness;
+  std::string radiusAttr, neiRadiusAttr;
+  std::uint64_t topoHash, shapeHash;
+};
+
+std::mutex g_sharedTreesMtx;
+std::vector<SharedTree> g_sharedTrees;
+
+template <class T>
+std::uint64_t hashArray(std::vector<T> const &arr, std::uint64_t h) {
+  auto p = reinterpret_cast<const unsigned char *>(arr.data());
+  std::size_t n = arr.size() * sizeof(T), i = 0;
+  h = (h ^ n) * 1099511628211ull;
+  for (; i + 8 <= n; i += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, p + i, 8);
+    h = (h ^ w) * 1099511628211ull;
+  }
+  for (; i < n; ++i)
+    h = (h ^ p[i]) * 1099511628211ull;
+  return h;
+}
+
+LBvh::element_e resolveCategory(PrimitiveObject const &prim) {
+  if (prim.quads.size() > 0)
+    return LBvh::element_e::tet;
+  if (prim.tris.size() > 0)
+    return LBvh::element_e::tri;
+  if (prim.lines.size() > 0)
+    return LBvh::element_e::line;
+  return LBvh::element_e::point;
+}
+
+std::uint64_t topologyHash(PrimitiveObject const &prim, LBvh::element_e et) {
+  std::uint64_t h = 14695981039346656037ull;
+  h = (h ^ prim.verts.size()) * 1099511628211ull;
+  switch (et) {
+  case LBvh::element_e::tet: return hashArray(prim.quads.values, h);
+  case LBvh::element_e::tri: return hashArray(prim.tris.values, h);
+  case LBvh::element_e::line: return hashArray(prim.lines.values, h);
+  default: return hashArray(prim.points.values, h);
+  }
+}
+
+std::uint64_t shapeHash(PrimitiveObject const &prim,
+                        std::string const &radiusAttr,
+                        std::string const &neiRadiusAttr) {
+  std::uint64_t h = hashArray(prim.verts.values, 14695981039346656037ull);
+  if (!radiusAttr.empty())
+    h = hashArray(prim.verts.attr<float>(radiusAttr), h);
+  if (!neiRadiusAttr.empty())
+    h = hashArray(prim.verts.attr<float>(neiRadiusAttr), h);
+  return h;
+}
+
+// how loose the tree is, grows as refitted boxes start to overlap
+float totalArea(LBvh const &bvh) {
+  double area = 0;
+  for (auto const &[lo, hi] : bvh.sortedBvs) {
+    auto d = hi - lo;
+    area += d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+  }
+  return (float)area;
+}
+
+} // namespace
+
+std::shared_ptr<LBvh>
+LBvhCache::acquire(const std::shared_ptr<PrimitiveObject> &prim,
+                   float thickness_, std::string const &radiusAttr_,
+                   std::string const &neiRadiusAttr_, LBvh::element_e et_) {
+  if (et_ == LBvh::element_e::unknown)
+    et_ = resolveCategory(*prim);
+  // do what build() would do up front, so that the topology hash is stable
+  if (et_ == LBvh::element_e::point && prim->points.size() == 0) {
+    prim->points.resize(prim->verts.size());
+    for (std::size_t i = 0; i < prim->points.size(); ++i)
+      prim->points[i] = i;
+  }
+  auto topo = topologyHash(*prim, et_);
+  auto shape = shapeHash(*prim, radiusAttr_, neiRadiusAttr_);
+  bool sameSettings = bvh && et == et_ && thickness == thickness_ &&
+                      radiusAttr == radiusAttr_ &&
+                      neiRadiusAttr == neiRadiusAttr_;
+
+  if (sameSettings && topoKey == topo && shapeKey == shape &&
+      bvh->primPtr.lock() == prim)
+    return bvh;
+
+  {
+    // another node already built a tree for this very primitive
+    std::lock_guard lck(g_sharedTreesMtx);
+    for (auto it = g_sharedTrees.begin(); it != g_sharedTrees.end();) {
+      auto other = it->bvh.lock();
+      if (!other) {
+        it = g_sharedTrees.erase(it);
+        continue;
+      }
+      if (other != bvh && it->prim.lock() == prim && it->topoHash == topo &&
+          it->shapeHash == shape && it->et == et_ &&
+          it->thickness == thickness_ && it->radiusAttr == radiusAttr_ &&
+          it->neiRadiusAttr == neiRadiusAttr_) {
+        // refit counters and areas belong to the other node's tree
+        bvh = std::move(other);
+        spare = nullptr;
+        et = et_, thickness = thickness_;
+        radiusAttr = radiusAttr_, neiRadiusAttr = neiRadiusAttr_;
+        topoKey = topo, shapeKey = shape;
+        refits = maxRefits;
+        return bvh;
+      }
+      ++it;
+    }
+  }
+
+  std::shared_ptr<LBvh> res;
+  if (sameSettings && topoKey == topo && refits < maxRefits) {
+    // same layout as last time: keep the tree topology, refit the boxes;
+    // the last tree may still be used downstream, refit a copy of it in
+    // the spare buffer unless someone else holds that one too
+    if (!spare || spare.use_count() > 1) {
+      spare = std::make_shared<LBvh>();
+    } else {
+      // about to be overwritten, must not be found for its old primitive
+      std::lock_guard lck(g_sharedTreesMtx);
+      g_sharedTrees.erase(
+          std::remove_if(g_sharedTrees.begin(), g_sharedTrees.end(),
+                         [&](auto const &ent) {
+                           return ent.bvh.lock() == spare;
+                         }),
+          g_sharedTrees.end());
+    }
+    *spare = *bvh;
+    spare->primPtr = prim;
+    spare->getBv = spare->getBvFunc(prim);
+    spare->refit();
+    if (totalArea(*spare) <= builtArea * maxAreaGrowth) {
+      res = std::move(spare);
+      spare = std::move(bvh);
+      ++refits;
+    }
+  }
+
+  if (!res) {
+    res = std::make_shared<LBvh>();
+    switch (et_) {
+    case LBvh::element_e::tet:
+      res->build(prim, thickness_, radiusAttr_, neiRadiusAttr_,
+                 LBvh::element_c<LBvh::element_e::tet>);
+      break;
+    case LBvh::element_e::tri:
+      res->build(prim, thickness_, radiusAttr_, neiRadiusAttr_,
+                 LBvh::element_c<LBvh::element_e::tri>);
+      break;
+    case LBvh::element_e::line:
+      res->build(prim, thickness_, radiusAttr_, neiRadiusAttr_,
+                 LBvh::element_c<LBvh::element_e::line>);
+      break;
+    default:
+      res->build(prim, thickness_, radiusAttr_, neiRadiusAttr_,
+                 LBvh::element_c<LBvh::element_e::point>);
+      break;
+    }
+    spare = nullptr;
+    refits = 0;
+    builtArea = totalArea(*res);
+  }
+
+  bvh = res;
+  et = et_, thickness = thickness_;
+  radiusAttr = radiusAttr_, neiRadiusAttr = neiRadiusAttr_;
+  topoKey = topo, shapeKey = shape;
+
+  std::lock_guard lck(g_sharedTreesMtx);
+  g_sharedTrees.push_back(
+      {bvh, prim, et, thickness, radiusAttr, neiRadiusAttr, topo, shape});
+  return bvh;
+}
+
+void LBvhCache::clear() {
+  bvh = nullptr;
+  spare = nullptr;
+  refits = 0;
+}
+
 } // namespace zeno
@@ -284,4 +284,31 @@ struct LBvh : IObjectClone<LBvh> {
 
 };
 
+/// tree cache owned by a build node, so the trees die with the node:
+/// a tree is refitted instead of rebuilt when only positions changed, and
+/// nodes asking for the same unchanged primitive share one tree.
+/// the tree handed out last time may still be in use downstream, so refits
+/// go into a second buffer; after too many refits, or once the refitted
+/// boxes got much larger than the freshly built ones, the tree is rebuilt
+struct LBvhCache {
+  /// et == unknown picks the element category from the primitive
+  std::shared_ptr<LBvh>
+  acquire(const std::shared_ptr<PrimitiveObject> &prim, float thickness,
+          std::string const &radiusAttr, std::string const &neiRadiusAttr,
+          LBvh::element_e et);
+  void clear();
+
+  static constexpr int maxRefits = 32;
+  static constexpr float maxAreaGrowth = 2.f;
+
+private:
+  std::shared_ptr<LBvh> bvh, spare;
+  LBvh::element_e et{LBvh::element_e::unknown};
+  float thickness{0};
+  std::string radiusAttr, neiRadiusAttr;
+  std::uint64_t topoKey{0}, shapeKey{0};
+  int refits{0};
+  float builtArea{0}; // summed box areas right after the last build
+};
+
 } // namespace zeno
@@ -0,0 +1,98 @@
+#include <zfx/utils.h>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace zfx {
+
+namespace fs = std::filesystem;
+
+static constexpr char kCacheMagic[8] = {'Z', 'F', 'X', 'C', 'A', 'C', 'H', '1'};
+
+static fs::path const &cache_dir() {
+    static fs::path dir = [] {
+        fs::path res;
+        if (auto env = std::getenv("ZENO_ZFX_CACHE"); env && *env) {
+            std::error_code ec;
+            fs::create_directories(env, ec);
+            if (!ec || fs::is_directory(env))
+                res = env;
+        }
+        return res;
+    }();
+    return dir;
+}
+
+static fs::path cache_path(const char *kind, std::string const &key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c: key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char name[64];
+    sprintf(name, "%s-%016llx.bin", kind, (unsigned long long)hash);
+    return cache_dir() / name;
+}
+
+bool disk_cache_load(const char *kind, std::string const &key, std::string &data) {
+    if (cache_dir().empty())
+        return false;
+    std::ifstream fin(cache_path(kind, key), std::ios::binary);
+    if (!fin)
+        return false;
+    char magic[sizeof(kCacheMagic)];
+    uint64_t keysize = 0, datasize = 0;
+    if (!fin.read(magic, sizeof(magic)) || std::memcmp(magic, kCacheMagic, sizeof(magic)))
+        return false;
+    if (!fin.read((char *)&keysize, sizeof(keysize)) || keysize != key.size())
+        return false;
+    std::string oldkey(keysize, '\0');
+    if (!fin.read(oldkey.data(), keysize) || oldkey != key)
+        return false;  // hash collision
+    if (!fin.read((char *)&datasize, sizeof(datasize)))
+        return false;
+    data.resize(datasize);
+    return (bool)fin.read(data.data(), datasize);
+}
+
+void disk_cache_store(const char *kind, std::string const &key, std::string const &data) {
+    if (cache_dir().empty())
+        return;
+    auto path = cache_path(kind, key);
+    // write to a private file then rename, so that concurrent runners
+    // never observe a partially written entry
+    static std::atomic<unsigned> counter{0};
+    auto tmppath = path;
+    tmppath += '.' + to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())
+        ^ std::chrono::steady_clock::now().time_since_epoch().count())
+        + '.' + to_string(counter++) + ".tmp";
+    {
+        std::ofstream fout(tmppath, std::ios::binary);
+        if (!fout)
+            return;
+        uint64_t keysize = key.size(), datasize = data.size();
+        fout.write(kCacheMagic, sizeof(kCacheMagic));
+        fout.write((char const *)&keysize, sizeof(keysize));
+        fout.write(key.data(), keysize);
+        fout.write((char const *)&datasize, sizeof(datasize));
+        fout.write(data.data(), datasize);
+        if (!fout) {
+            fout.close();
+            std::error_code ec;
+            fs::remove(tmppath, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmppath, path, ec);
+    if (ec)
+        fs::remove(tmppath, ec);
+}
+
+}
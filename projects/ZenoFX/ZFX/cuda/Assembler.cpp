@@ -331,4 +331,9 @@ std::string Assembler::impl_assemble
     return a.code;
 }
 
+Assembler &Assembler::global() {
+    static Assembler assembler;
+    return assembler;
+}
+
 }
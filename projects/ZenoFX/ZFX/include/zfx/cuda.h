@@ -4,6 +4,7 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <mutex>
 
 namespace zfx::cuda {
 
@@ -16,6 +17,7 @@ struct Executable {
 };
 
 struct Assembler {
+    std::mutex mtx;
     std::map<std::string, std::string> cache;
 
     static std::string impl_assemble
@@ -23,13 +25,19 @@ struct Assembler {
         );
 
     std::string assemble(std::string const &lines) {
-        if (auto it = cache.find(lines); it != cache.end()) {
-            return it->second;
+        {
+            std::lock_guard lck(mtx);
+            if (auto it = cache.find(lines); it != cache.end()) {
+                return it->second;
+            }
         }
         auto code = impl_assemble(lines);
-        cache[lines] = code;
-        return code;
+        std::lock_guard lck(mtx);
+        return cache.try_emplace(lines, std::move(code)).first->second;
     }
+
+    // the assembler shared by all CUDA wrangle nodes in this process
+    static Assembler &global();
 };
 
 }
@@ -140,4 +140,9 @@ static inline std::string to_string(T const &value) {
     return ss.str();
 }
 
+// persistent cache of compiled programs, shared between processes; enabled
+// by pointing ZENO_ZFX_CACHE at a directory, otherwise these are no-ops
+bool disk_cache_load(const char *kind, std::string const &key, std::string &data);
+void disk_cache_store(const char *kind, std::string const &key, std::string const &data);
+
 }
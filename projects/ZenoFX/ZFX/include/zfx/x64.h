@@ -3,6 +3,7 @@
 #include <memory>
 #include <cstring>
 #include <string>
+#include <mutex>
 #include <map>
 
 namespace zfx::x64 {
@@ -10,6 +11,7 @@ namespace zfx::x64 {
 struct Executable {
     uint8_t *mem = nullptr;
     size_t memsize = 0;
+    size_t codesize = 0;
     float consts[1024];
     void **functable = nullptr;
 
@@ -17,11 +19,12 @@ struct Executable {
 
     struct Context {
         Executable *exec;
+        float *consts;
         float locals[SimdWidth * 256];
 
         void execute() {
             auto entry = (void(*)(void *, void *, void *))exec->mem;
-            entry((void *)locals, (void *)exec->consts, (void *)exec->functable);
+            entry((void *)locals, (void *)consts, (void *)exec->functable);
         }
 
         float *channel(int chid) {
@@ -29,12 +32,36 @@ struct Executable {
         }
     };
 
+    // a private copy of the constant block for one invocation, so that
+    // several nodes may run the same program with different parameters
+    struct Instance {
+        Executable *exec;
+        float consts[1024];
+
+        static constexpr size_t SimdWidth = Executable::SimdWidth;
+
+        inline float &parameter(int parid) {
+            return consts[parid];
+        }
+
+        inline Context make_context() {
+            return {exec, consts, {}};
+        }
+    };
+
     inline float &parameter(int parid) {
         return consts[parid];
     }
 
     inline Context make_context() {
-        return {this};
+        return {this, consts, {}};
+    }
+
+    inline std::unique_ptr<Instance> make_instance() {
+        auto inst = std::make_unique<Instance>();
+        inst->exec = this;
+        std::memcpy(inst->consts, consts, sizeof(consts));
+        return inst;
     }
 
     Executable() = default;
@@ -47,17 +74,24 @@ struct Executable {
 };
 
 struct Assembler {
+    std::mutex mtx;
     std::map<std::string, std::unique_ptr<Executable>> cache;
 
     Executable *assemble(std::string const &lines) {
-        if (auto it = cache.find(lines); it != cache.end()) {
-            return it->second.get();
+        {
+            std::lock_guard lck(mtx);
+            if (auto it = cache.find(lines); it != cache.end()) {
+                return it->second.get();
+            }
         }
         auto prog = Executable::assemble(lines);
-        auto raw_ptr = prog.get();
-        cache[lines] = std::move(prog);
-        return raw_ptr;
+        std::lock_guard lck(mtx);
+        auto [it, ok] = cache.try_emplace(lines, std::move(prog));
+        return it->second.get();
     }
+
+    // the assembler shared by all wrangle nodes in this process
+    static Assembler &global();
 };
 
 }
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <tuple>
 #include <map>
 
@@ -68,6 +69,12 @@ struct Options {
         os << '|' << reassign_channels;
         os << '|' << save_math_registers;
         os << '|' << arch_maxregs;
+        os << '|' << demote_math_funcs;
+        os << '|' << detect_new_symbols;
+        os << '|' << reassign_parameters;
+        os << '|' << kill_unreachable;
+        os << '|' << constant_fold;
+        os << '|' << merge_identical;
     }
 };
 
@@ -117,41 +124,16 @@ struct Program {
 };
 
 struct Compiler {
+    std::mutex mtx;
     std::map<std::string, std::unique_ptr<Program>> cache;
 
     Program *compile
         ( std::string const &code
         , Options const &options
-        ) {
-        std::ostringstream ss;
-        ss << code << "<EOF>";
-        options.dump(ss);
-        auto key = ss.str();
-
-        auto it = cache.find(key);
-        if (it != cache.end()) {
-            return it->second.get();
-        }
+        );
 
-        auto 
-            [ assembly
-            , symbols
-            , params
-            , newsyms
-            ] = compile_to_assembly
-            ( code
-            , options
-            );
-        auto prog = std::make_unique<Program>();
-        prog->assembly = assembly;
-        prog->symbols = symbols;
-        prog->params = params;
-        prog->newsyms = newsyms;
-
-        auto raw_ptr = prog.get();
-        cache[key] = std::move(prog);
-        return raw_ptr;
-    }
+    // the compiler shared by all wrangle nodes in this process
+    static Compiler &global();
 };
 
 }
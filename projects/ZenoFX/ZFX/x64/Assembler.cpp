@@ -5,7 +5,12 @@
 #include <zfx/x64.h>
 #include <algorithm>
 #include <sstream>
+#include <cstring>
+#include <mutex>
 #include <map>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace zfx::x64 {
 
@@ -364,26 +369,98 @@ struct ImplAssembler {
         }
 #endif
 
-        if (!functable)
-            functable = std::make_unique<FuncTable>();
+        load_code(insts.data(), insts.size());
+    }
+
+    void load_code(uint8_t const *insts, size_t size) {
+        {
+            static std::mutex mtx;
+            std::lock_guard lck(mtx);
+            if (!functable)
+                functable = std::make_unique<FuncTable>();
+        }
         exec->functable = functable->funcptrs.data();
-        exec->memsize = (insts.size() + 4095) / 4096 * 4096;
+        exec->codesize = size;
+        exec->memsize = (size + 4095) / 4096 * 4096;
         exec->mem = (uint8_t *)exec_page_allocate(exec->memsize);
-        for (int i = 0; i < insts.size(); i++) {
-            exec->mem[i] = insts[i];
-        }
+        std::memcpy(exec->mem, insts, size);
         exec_page_mark_executable(exec->mem, exec->memsize);
     }
+
+    std::string save_blob() const {
+        std::string buf;
+        uint64_t size = exec->codesize;
+        buf.append((char const *)&size, sizeof(size));
+        buf.append((char const *)exec->mem, size);
+        buf.append((char const *)exec->consts, sizeof(exec->consts));
+        return buf;
+    }
+
+    bool load_blob(std::string const &buf) {
+        uint64_t size = 0;
+        if (buf.size() < sizeof(size))
+            return false;
+        std::memcpy(&size, buf.data(), sizeof(size));
+        if (buf.size() != sizeof(size) + size + sizeof(exec->consts))
+            return false;
+        std::memcpy(exec->consts, buf.data() + sizeof(size) + size, sizeof(exec->consts));
+        load_code((uint8_t const *)buf.data() + sizeof(size), size);
+        return true;
+    }
 };
 
+// bump whenever the emitted code or the blob layout of ImplAssembler changes
+static constexpr int kCodegenVersion = 1;
+
+// machine code depends on the code generator, the calling convention, the
+// instruction set of the host and the layout of the function table, so all
+// go into the key
+static std::string target_signature() {
+    std::string res = "x64-" + std::to_string(kCodegenVersion) + ',';
+#if defined(_WIN32)
+    res += "win64";
+#else
+    res += "sysv";
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) res += ",avx";
+    if (__builtin_cpu_supports("avx2")) res += ",avx2";
+    if (__builtin_cpu_supports("fma")) res += ",fma";
+    if (__builtin_cpu_supports("avx512f")) res += ",avx512f";
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    if (info[2] & (1 << 28)) res += ",avx";
+    if (info[2] & (1 << 12)) res += ",fma";
+    __cpuidex(info, 7, 0);
+    if (info[1] & (1 << 5)) res += ",avx2";
+    if (info[1] & (1 << 16)) res += ",avx512f";
+#endif
+    res += '|' + join_str(FuncTable::funcnames, ',');
+    return res;
+}
+
 std::unique_ptr<Executable> Executable::assemble
     ( std::string const &lines
     ) {
+    static const std::string signature = target_signature();
+    auto key = signature + '\n' + lines;
+
     ImplAssembler a;
+    if (std::string blob; disk_cache_load("x64", key, blob) && a.load_blob(blob)) {
+        return std::move(a.exec);
+    }
     a.parse(lines);
+    disk_cache_store("x64", key, a.save_blob());
     return std::move(a.exec);
 }
 
+Assembler &Assembler::global() {
+    static Assembler assembler;
+    return assembler;
+}
+
 Executable::~Executable() {
     if (mem) {
         exec_page_free(mem, memsize);
@@ -1,6 +1,8 @@
 #include "LowerAST.h"
 #include "Visitors.h"
 #include <zfx/zfx.h>
+#include <zfx/utils.h>
+#include <cstring>
 
 namespace zfx {
 
@@ -153,11 +155,11 @@ std::tuple
         ir->print();
 #endif
         std::vector<std::pair<std::string, int>> new_params;
-        for (int i = 0; i < params.size(); i++) {
+        for (size_t i = 0; i < params.size(); i++) {
             auto it = uniforms.find(i);
             if (it == uniforms.end())
                 continue;
-            auto dst = it->second;
+            size_t dst = it->second;
             if (new_params.size() < dst + 1)
                 new_params.resize(dst + 1);
             new_params[dst] = params[i];
@@ -230,11 +232,11 @@ std::tuple
         ir->print();
 #endif
         std::vector<std::pair<std::string, int>> new_symbols;
-        for (int i = 0; i < symbols.size(); i++) {
+        for (size_t i = 0; i < symbols.size(); i++) {
             auto it = globals.find(i);
             if (it == globals.end())
                 continue;
-            auto dst = it->second;
+            size_t dst = it->second;
             if (new_symbols.size() < dst + 1)
                 new_symbols.resize(dst + 1);
             new_symbols[dst] = symbols[i];
@@ -272,4 +274,138 @@ std::tuple
         };
 }
 
+static void put_string(std::string &buf, std::string const &str) {
+    uint32_t size = str.size();
+    buf.append((char const *)&size, sizeof(size));
+    buf.append(str);
+}
+
+static void put_int(std::string &buf, int value) {
+    buf.append((char const *)&value, sizeof(value));
+}
+
+struct BlobReader {
+    std::string const &buf;
+    size_t pos = 0;
+    bool ok = true;
+
+    int get_int() {
+        int value = 0;
+        if (pos + sizeof(value) > buf.size()) {
+            ok = false;
+            return 0;
+        }
+        std::memcpy(&value, buf.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return value;
+    }
+
+    std::string get_string() {
+        uint32_t size = get_int();
+        if (!ok || pos + size > buf.size()) {
+            ok = false;
+            return {};
+        }
+        std::string str(buf.data() + pos, size);
+        pos += size;
+        return str;
+    }
+};
+
+// bump whenever the passes change the emitted assembly or the layout below
+// changes, so that programs cached on disk by another version are not reused
+static constexpr int kCompilerVersion = 1;
+
+static std::string save_program(Program const &prog) {
+    std::string buf;
+    put_string(buf, prog.assembly);
+    put_int(buf, prog.symbols.size());
+    for (auto const &[name, dim]: prog.symbols) {
+        put_string(buf, name);
+        put_int(buf, dim);
+    }
+    put_int(buf, prog.params.size());
+    for (auto const &[name, dim]: prog.params) {
+        put_string(buf, name);
+        put_int(buf, dim);
+    }
+    put_int(buf, prog.newsyms.size());
+    for (auto const &[name, dim]: prog.newsyms) {
+        put_string(buf, name);
+        put_int(buf, dim);
+    }
+    return buf;
+}
+
+static std::unique_ptr<Program> load_program(std::string const &buf) {
+    BlobReader rd{buf};
+    auto prog = std::make_unique<Program>();
+    prog->assembly = rd.get_string();
+    for (int i = 0, n = rd.get_int(); rd.ok && i < n; i++) {
+        auto name = rd.get_string();
+        prog->symbols.emplace_back(name, rd.get_int());
+    }
+    for (int i = 0, n = rd.get_int(); rd.ok && i < n; i++) {
+        auto name = rd.get_string();
+        prog->params.emplace_back(name, rd.get_int());
+    }
+    for (int i = 0, n = rd.get_int(); rd.ok && i < n; i++) {
+        auto name = rd.get_string();
+        prog->newsyms[name] = rd.get_int();
+    }
+    if (!rd.ok || rd.pos != buf.size())
+        return nullptr;
+    return prog;
+}
+
+Program *Compiler::compile
+    ( std::string const &code
+    , Options const &options
+    ) {
+    std::ostringstream ss;
+    ss << code << "<EOF>";
+    options.dump(ss);
+    auto key = ss.str();
+    auto diskkey = "zfx-" + std::to_string(kCompilerVersion) + '\n' + key;
+
+    {
+        std::lock_guard lck(mtx);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_ptr<Program> prog;
+    if (std::string blob; disk_cache_load("prog", diskkey, blob)) {
+        prog = load_program(blob);
+    }
+    if (!prog) {
+        auto
+            [ assembly
+            , symbols
+            , params
+            , newsyms
+            ] = compile_to_assembly
+            ( code
+            , options
+            );
+        prog = std::make_unique<Program>();
+        prog->assembly = assembly;
+        prog->symbols = symbols;
+        prog->params = params;
+        prog->newsyms = newsyms;
+        disk_cache_store("prog", diskkey, save_program(*prog));
+    }
+
+    std::lock_guard lck(mtx);
+    auto [it, ok] = cache.try_emplace(key, std::move(prog));
+    return it->second.get();
+}
+
+Compiler &Compiler::global() {
+    static Compiler compiler;
+    return compiler;
+}
+
 }
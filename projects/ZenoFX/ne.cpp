@@ -18,10 +18,10 @@ namespace zeno {
     std::string preApplyRefs(const std::string& code, Graph* pGraph);
 
 namespace {
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
-static void numeric_eval (zfx::x64::Executable *exec,
+static void numeric_eval (zfx::x64::Executable::Instance *exec,
                          std::vector<float> &chs) {
     auto ctx = exec->make_context();
     for (int j = 0; j < chs.size(); j++) {
@@ -130,7 +130,7 @@ struct NumericEval : zeno::INode {
         if (code.find("@result") == std::string::npos)
             code = "@result = ( " + code + " )";
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         //计算输出结果
         auto result = std::make_shared<zeno::NumericObject>();
@@ -175,7 +175,7 @@ struct NumericEval : zeno::INode {
         assert(name[0] == '@');
     }
 
-    numeric_eval(exec, chs);
+    numeric_eval(exec.get(), chs);
 
     std::vector<float> resex(chs.size());
     for (int i = 0; i < chs.size(); i++) {
@@ -16,11 +16,11 @@ namespace zeno {
 namespace {
     using namespace zeno;
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 static void numeric_wrangle
-    ( zfx::x64::Executable *exec
+    ( zfx::x64::Executable::Instance *exec
     , std::vector<float> &chs
     ) {
     auto ctx = exec->make_context();
@@ -118,7 +118,7 @@ struct NumericWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         auto result = std::make_shared<zeno::DictObject>();
         for (auto const &[name, dim]: prog->newsyms) {
@@ -159,7 +159,7 @@ struct NumericWrangle : zeno::INode {
             assert(name[0] == '@');
         }
 
-        numeric_wrangle(exec, chs);
+        numeric_wrangle(exec.get(), chs);
 
         for (int i = 0; i < chs.size(); i++) {
             auto [name, dimid] = prog->symbols[i];
@@ -15,8 +15,8 @@ namespace zeno {
 
 namespace {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 struct Buffer {
     float *base = nullptr;
@@ -25,7 +25,7 @@ struct Buffer {
 };
 
 static void vectors_wrangle
-    ( zfx::x64::Executable *exec
+    ( zfx::x64::Executable::Instance *exec
     , std::vector<Buffer> const &chs
     ) {
     if (chs.size() == 0)
@@ -188,7 +188,7 @@ struct ParticlesTwoWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         for (auto const &[name, dim]: prog->newsyms) {
             dbg_printf("auto-defined new attribute: %s with dim %d\n",
@@ -242,7 +242,7 @@ struct ParticlesTwoWrangle : zeno::INode {
             });
             chs[i] = iob;
         }
-        vectors_wrangle(exec, chs);
+        vectors_wrangle(exec.get(), chs);
 
         set_output("prim", std::move(prim));
     }
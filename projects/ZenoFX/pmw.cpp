@@ -15,8 +15,8 @@ namespace zeno {
 
 namespace {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 struct Buffer {
     float *base = nullptr;
@@ -25,7 +25,7 @@ struct Buffer {
 };
 
 static void vectors_wrangle
-    ( zfx::x64::Executable *exec
+    ( zfx::x64::Executable::Instance *exec
     , std::vector<Buffer> const &chs
     , int *maskarr
     ) {
@@ -173,7 +173,7 @@ struct ParticlesMaskedWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         for (auto const &[name, dim]: prog->newsyms) {
             dbg_printf("auto-defined new attribute: %s with dim %d\n",
@@ -216,7 +216,7 @@ struct ParticlesMaskedWrangle : zeno::INode {
             chs[i] = iob;
         }
         auto &maskarr = prim->attr<int>(get_input2<std::string>("maskAttr"));
-        vectors_wrangle(exec, chs, maskarr.data());
+        vectors_wrangle(exec.get(), chs, maskarr.data());
 
         set_output("prim", std::move(prim));
     }
@@ -20,8 +20,8 @@
 
 namespace zeno {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 struct Buffer {
   float *base = nullptr;
@@ -30,7 +30,7 @@ struct Buffer {
   int which = 0;
 };
 
-static void sorted_bvh_vectors_wrangle(zfx::x64::Executable *exec,
+static void sorted_bvh_vectors_wrangle(zfx::x64::Executable::Instance *exec,
                                 std::vector<Buffer> const &chs,
                                 std::vector<Buffer> const &chs2,
                                 std::vector<zeno::vec3f> const &pos,
@@ -77,7 +77,7 @@ static void sorted_bvh_vectors_wrangle(zfx::x64::Executable *exec,
   }
 }
 
-static void bvh_vectors_wrangle(zfx::x64::Executable *exec,
+static void bvh_vectors_wrangle(zfx::x64::Executable::Instance *exec,
                                 std::vector<Buffer> const &chs,
                                 std::vector<Buffer> const &chs2,
                                 std::vector<zeno::vec3f> const &pos,
@@ -111,7 +111,7 @@ static void bvh_vectors_wrangle(zfx::x64::Executable *exec,
   }
 }
 
-static void bvh_vectors_wrangle_radius_two(zfx::x64::Executable *exec,
+static void bvh_vectors_wrangle_radius_two(zfx::x64::Executable::Instance *exec,
                                 std::vector<Buffer> const &chs,
                                 std::vector<Buffer> const &chs2,
                                 const float *maskarr,
@@ -186,6 +186,8 @@ static void bvh_vectors_wrangle_radius_two(zfx::x64::Executable *exec,
 }
 
 struct ParticlesBuildBvh : zeno::INode {
+  zeno::LBvhCache bvhCache;
+
   virtual void apply() override {
     auto primNei = get_input<zeno::PrimitiveObject>("primNei");
     float radius = get_input<zeno::NumericObject>("radius")->get<float>();
@@ -193,8 +195,8 @@ struct ParticlesBuildBvh : zeno::INode {
         has_input("radiusMin")
             ? get_input<zeno::NumericObject>("radiusMin")->get<float>()
             : -1.f;
-    auto lbvh = std::make_shared<zeno::LBvh>(
-        primNei, radius, zeno::LBvh::element_c<zeno::LBvh::element_e::point>);
+    auto lbvh = bvhCache.acquire(primNei, radius, "", "",
+                                 zeno::LBvh::element_e::point);
     set_output("lbvh", std::move(lbvh));
   }
 };
@@ -209,6 +211,8 @@ ZENDEFNODE(ParticlesBuildBvh, {
                               });
 
 struct BuildPrimitiveBvh : zeno::INode {
+  zeno::LBvhCache bvhCache;
+
   virtual void apply() override {
     auto prim = get_input<zeno::PrimitiveObject>("prim");
     float thickness =
@@ -216,26 +220,19 @@ struct BuildPrimitiveBvh : zeno::INode {
             ? get_input<zeno::NumericObject>("thickness")->get<float>()
             : 0.f;
     auto primType = get_param<std::string>("prim_type");
-    if (primType == "auto") {
-      auto lbvh = std::make_shared<zeno::LBvh>(prim, thickness);
-      set_output("lbvh", std::move(lbvh));
-    } else if (primType == "point") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
-          prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::point>);
-      set_output("lbvh", std::move(lbvh));
-    } else if (primType == "line") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
-          prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::line>);
-      set_output("lbvh", std::move(lbvh));
-    } else if (primType == "tri") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
-          prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::tri>);
-      set_output("lbvh", std::move(lbvh));
-    } else if (primType == "quad") {
-      auto lbvh = std::make_shared<zeno::LBvh>(
-          prim, thickness, zeno::LBvh::element_c<zeno::LBvh::element_e::tet>);
-      set_output("lbvh", std::move(lbvh));
-    }
+    auto et = zeno::LBvh::element_e::unknown;
+    if (primType == "point")
+      et = zeno::LBvh::element_e::point;
+    else if (primType == "line")
+      et = zeno::LBvh::element_e::line;
+    else if (primType == "tri")
+      et = zeno::LBvh::element_e::tri;
+    else if (primType == "quad")
+      et = zeno::LBvh::element_e::tet;
+    else if (primType != "auto")
+      return;
+    auto lbvh = bvhCache.acquire(prim, thickness, "", "", et);
+    set_output("lbvh", std::move(lbvh));
   }
 };
 
@@ -248,13 +245,15 @@ ZENDEFNODE(BuildPrimitiveBvh,
            });
 
 struct ParticlesBuildBvhRadius : zeno::INode {
+  zeno::LBvhCache bvhCache;
+
   virtual void apply() override {
     auto prim = get_input<zeno::PrimitiveObject>("prim");
     float radius = get_input2<float>("basicRadius");
     auto radiusAttr = get_input2<std::string>("radiusAttr");
     auto neiRadiusAttr = get_input2<std::string>("neiRadiusAttr");
-    auto lbvh = std::make_shared<zeno::LBvh>(
-        prim, radius, radiusAttr, neiRadiusAttr, zeno::LBvh::element_c<zeno::LBvh::element_e::point>);
+    auto lbvh = bvhCache.acquire(prim, radius, radiusAttr, neiRadiusAttr,
+                                 zeno::LBvh::element_e::point);
     set_output("lbvh", std::move(lbvh));
   }
 };
@@ -775,7 +774,7 @@ struct ParticlesNeighborBvhWrangle : zeno::INode {
         }
 
     auto prog = compiler.compile(code, opts);
-    auto exec = assembler.assemble(prog->assembly);
+    auto exec = assembler.assemble(prog->assembly)->make_instance();
 
     for (auto const &[name, dim] : prog->newsyms) {
       dbg_printf("auto-defined new attribute: %s with dim %d\n", name.c_str(),
@@ -854,7 +853,7 @@ struct ParticlesNeighborBvhWrangle : zeno::INode {
       chs2[i] = iob;
     }
 
-    bvh_vectors_wrangle(exec, chs, chs2, prim->attr<zeno::vec3f>("pos"),
+    bvh_vectors_wrangle(exec.get(), chs, chs2, prim->attr<zeno::vec3f>("pos"),
                         primNei->attr<zeno::vec3f>("pos"), get_input2<bool>("is_box"),
                         lbvh.get()->thickness * lbvh.get()->thickness, lbvh.get());
 
@@ -1001,7 +1000,7 @@ struct ParticlesNeighborBvhWrangleSorted : zeno::INode {
         }
 
     auto prog = compiler.compile(code, opts);
-    auto exec = assembler.assemble(prog->assembly);
+    auto exec = assembler.assemble(prog->assembly)->make_instance();
 
     for (auto const &[name, dim] : prog->newsyms) {
       dbg_printf("auto-defined new attribute: %s with dim %d\n", name.c_str(),
@@ -1080,7 +1079,7 @@ struct ParticlesNeighborBvhWrangleSorted : zeno::INode {
       chs2[i] = iob;
     }
 
-    sorted_bvh_vectors_wrangle(exec, chs, chs2, prim->attr<zeno::vec3f>("pos"),
+    sorted_bvh_vectors_wrangle(exec.get(), chs, chs2, prim->attr<zeno::vec3f>("pos"),
                         primNei->attr<zeno::vec3f>("pos"), get_input2<bool>("is_box"),
                         lbvh.get()->thickness * lbvh.get()->thickness, get_input2<int>("limit"), lbvh.get());
 
@@ -1231,7 +1230,7 @@ struct ParticlesNeighborBvhRadiusWrangle : zeno::INode {
         }
 
     auto prog = compiler.compile(code, opts);
-    auto exec = assembler.assemble(prog->assembly);
+    auto exec = assembler.assemble(prog->assembly)->make_instance();
 
     for (auto const &[name, dim] : prog->newsyms) {
       dbg_printf("auto-defined new attribute: %s with dim %d\n", name.c_str(),
@@ -1311,7 +1310,7 @@ struct ParticlesNeighborBvhRadiusWrangle : zeno::INode {
     }
     std::string maskAttr = get_input2<std::string>("maskAttr");
     const auto &mask = maskAttr == "" ? std::vector<float>(prim->verts.size(), 1.0f) : prim->attr<float>(maskAttr);
-    bvh_vectors_wrangle_radius_two(exec, chs, chs2, mask.data(), prim.get(), prim->attr<zeno::vec3f>("pos"), radiusAttr,
+    bvh_vectors_wrangle_radius_two(exec.get(), chs, chs2, mask.data(), prim.get(), prim->attr<zeno::vec3f>("pos"), radiusAttr,
                         primNei->attr<zeno::vec3f>("pos"), primNei.get(), neighborRadiusAttr, 
                         get_input2<bool>("is_box"),
                         lbvh.get()->thickness, lbvh.get());
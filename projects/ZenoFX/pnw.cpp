@@ -20,8 +20,8 @@ namespace zeno {
 
 namespace {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 struct Buffer {
     float *base = nullptr;
@@ -30,6 +30,8 @@ struct Buffer {
     int which = 0;
 };
 
+// uniform grid with cells of size radius; particles are counting-sorted by
+// cell into one index array, so each cell is a contiguous range in `indices`
 struct HashGrid : zeno::IObject {
     float inv_dx;
     float radius;
@@ -37,23 +39,10 @@ struct HashGrid : zeno::IObject {
     float radius_sqr_min;
     std::vector<zeno::vec3f> const &refpos;
 
-    std::vector<std::vector<int>> table;
-
-//#define DILEI
-#define XUBEN
-
-    int hash(int x, int y, int z) {
-#ifdef XUBEN
-        return (x%gridRes[0]+gridRes[0])%gridRes[0] + ((y%gridRes[1]+gridRes[1])%gridRes[1]) * gridRes[0] + ((z%gridRes[2]+gridRes[2])%gridRes[2]) * gridRes[0] * gridRes[1];
-#else
-        return ((73856093 * x) ^ (19349663 * y) ^ (83492791 * z)) % table.size();
-#endif
-    }
-
-#ifdef XUBEN
     zeno::vec3f pMin, pMax;
     zeno::vec3i gridRes;
-#endif
+    std::vector<int> cellStart;  // cell id -> first slot in indices, size ncells + 1
+    std::vector<int> indices;    // particle ids sorted by cell, stable within a cell
 
     HashGrid(std::vector<zeno::vec3f> const &refpos_,
             float radius_, float radius_min)
@@ -62,77 +51,73 @@ struct HashGrid : zeno::IObject {
         radius = radius_;
         radius_sqr = radius * radius;
         radius_sqr_min = radius_min < 0.f ? -1.f : radius_min * radius_min;
-#ifdef DILEI
-        inv_dx = 0.5f / radius;
-#else
         inv_dx = 1.0f / radius;
-#endif
 
-#ifdef XUBEN
-        pMin = refpos[0];
-        pMax = refpos[0];
-        for (int i = 1; i < refpos.size(); i++) {
-            auto coor = refpos[i];
-            pMin = zeno::min(pMin, coor);
-            pMax = zeno::max(pMax, coor);
+        const intptr_t n = refpos.size();
+        pMin = n ? refpos[0] : zeno::vec3f(0);
+        pMax = pMin;
+        for (intptr_t i = 1; i < n; i++) {
+            pMin = zeno::min(pMin, refpos[i]);
+            pMax = zeno::max(pMax, refpos[i]);
         }
         pMin -= radius;
         pMax += radius;
         gridRes = zeno::toint(zeno::floor((pMax - pMin) * inv_dx)) + 1;
-
         dbg_printf("grid res: %dx%dx%d\n", gridRes[0], gridRes[1], gridRes[2]);
-        table.clear();
-        table.resize(gridRes[0] * gridRes[1] * gridRes[2]);
-#else
-        int table_size = refpos.size() / 8;
-        dbg_printf("table size: %d\n", table_size);
-        table.clear();
-        table.resize(table_size);
-#endif
 
-        for (int i = 0; i < refpos.size(); i++) {
-#ifdef XUBEN
-            auto coor = zeno::toint(zeno::floor((refpos[i] - pMin) * inv_dx));
-#else
-            auto coor = zeno::toint(zeno::floor(refpos[i] * inv_dx));
-#endif
-            auto key = hash(coor[0], coor[1], coor[2]);
-            table[key].push_back(i);
+        const size_t ncells = (size_t)gridRes[0] * gridRes[1] * gridRes[2];
+        std::vector<int> keys(n);
+        std::vector<std::atomic<int>> counts(ncells);
+        #pragma omp parallel for
+        for (intptr_t i = 0; i < n; i++) {
+            keys[i] = cell_id(cell_coord(refpos[i]));
+            counts[keys[i]].fetch_add(1, std::memory_order_relaxed);
         }
+
+        cellStart.resize(ncells + 1);
+        int acc = 0;
+        for (size_t c = 0; c < ncells; c++) {
+            cellStart[c] = acc;
+            acc += counts[c].load(std::memory_order_relaxed);
+            counts[c].store(cellStart[c], std::memory_order_relaxed);
+        }
+        cellStart[ncells] = acc;
+
+        indices.resize(n);
+        #pragma omp parallel for
+        for (intptr_t i = 0; i < n; i++) {
+            indices[counts[keys[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+        }
+        // the parallel scatter is unordered; restore index order per cell
+        #pragma omp parallel for schedule(dynamic, 4096)
+        for (intptr_t c = 0; c < (intptr_t)ncells; c++) {
+            if (cellStart[c + 1] - cellStart[c] > 1)
+                std::sort(indices.begin() + cellStart[c], indices.begin() + cellStart[c + 1]);
+        }
+    }
+
+    zeno::vec3i cell_coord(zeno::vec3f const &pos) const {
+        return zeno::toint(zeno::floor((pos - pMin) * inv_dx));
+    }
+
+    int cell_id(zeno::vec3i const &coor) const {
+        return coor[0] + gridRes[0] * (coor[1] + gridRes[1] * coor[2]);
     }
 
     template <class F>
-    void iter_neighbors(zeno::vec3f const &pos, F const &f) {
-#ifdef XUBEN
-#ifdef DILEI
-        auto coor = zeno::toint(zeno::floor((pos - pMin) * inv_dx - 0.5f));
-#else
-        auto coor = zeno::toint(zeno::floor((pos - pMin) * inv_dx));
-#endif
-#else
-#ifdef DILEI
-        auto coor = zeno::toint(zeno::floor(pos * inv_dx - 0.5f));
-#else
-        auto coor = zeno::toint(zeno::floor(pos * inv_dx));
-#endif
-#endif
-#ifdef DILEI
-        for (int dz = 0; dz < 2; dz++) {
-            for (int dy = 0; dy < 2; dy++) {
-                for (int dx = 0; dx < 2; dx++) {
-#else
-        for (int dz = -1; dz < 2; dz++) {
-            for (int dy = -1; dy < 2; dy++) {
-                for (int dx = -1; dx < 2; dx++) {
-#endif
-                    int key = hash(coor[0] + dx, coor[1] + dy, coor[2] + dz);
-                    for (int pid: table[key]) {
-                        //auto dist = refpos[pid] - pos;
-                        //auto dis2 = zeno::dot(dist, dist);
-                        //if (dis2 <= radius_sqr && dis2 > radius_sqr_min) {
-                            f(pid);
-                        //}
-                    }
+    void iter_neighbors(zeno::vec3f const &pos, F const &f) const {
+        auto coor = cell_coord(pos);
+        // x-adjacent cells are adjacent in the index array, so each (y, z)
+        // row of the 3x3x3 stencil is a single contiguous range
+        int x0 = std::max(coor[0] - 1, 0);
+        int x1 = std::min(coor[0] + 1, gridRes[0] - 1);
+        if (x0 > x1)
+            return;
+        for (int z = std::max(coor[2] - 1, 0); z <= std::min(coor[2] + 1, gridRes[2] - 1); z++) {
+            for (int y = std::max(coor[1] - 1, 0); y <= std::min(coor[1] + 1, gridRes[1] - 1); y++) {
+                int row = gridRes[0] * (y + gridRes[1] * z);
+                for (int k = cellStart[row + x0], end = cellStart[row + x1 + 1]; k < end; k++) {
+                    f(indices[k]);
                 }
             }
         }
@@ -140,7 +125,7 @@ struct HashGrid : zeno::IObject {
 };
 
 static void vectors_wrangle
-    ( zfx::x64::Executable *exec
+    ( zfx::x64::Executable::Instance *exec
     , std::vector<Buffer> const &chs
     , std::vector<Buffer> const &chs2
     , std::vector<zeno::vec3f> const &pos
@@ -149,8 +134,13 @@ static void vectors_wrangle
     if (chs.size() == 0)
         return;
 
+    // when querying the grid's own particles, visit them in cell order so
+    // that consecutive queries touch the same neighbour ranges
+    bool cellorder = &pos == &hashgrid->refpos;
+
     #pragma omp parallel for
-    for (int i = 0; i < pos.size(); i++) {
+    for (intptr_t j = 0; j < (intptr_t)pos.size(); j++) {
+        int i = cellorder ? hashgrid->indices[j] : j;
         auto ctx = exec->make_context();
         for (int k = 0; k < chs.size(); k++) {
             if (!chs[k].which)
@@ -311,7 +301,7 @@ struct ParticlesNeighborWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         for (auto const &[name, dim]: prog->newsyms) {
             dbg_printf("auto-defined new attribute: %s with dim %d\n",
@@ -390,7 +380,7 @@ struct ParticlesNeighborWrangle : zeno::INode {
             chs2[i] = iob;
         }
 
-        vectors_wrangle(exec, chs, chs2, prim->attr<zeno::vec3f>("pos"),
+        vectors_wrangle(exec.get(), chs, chs2, prim->attr<zeno::vec3f>("pos"),
                 hashgrid.get());
 
         set_output("prim", std::move(prim));
@@ -15,8 +15,8 @@ namespace zeno {
 
 namespace {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 struct Buffer {
     float *base = nullptr;
@@ -25,36 +25,46 @@ struct Buffer {
 };
 
 static void vectors_wrangle
-    ( zfx::x64::Executable *exec
+    ( zfx::x64::Executable::Instance *exec
     , std::vector<Buffer> const &chs
     ) {
     if (chs.size() == 0)
         return;
     size_t size = chs[0].count;
-    for (int i = 1; i < chs.size(); i++) {
+    for (size_t i = 1; i < chs.size(); i++) {
         size = std::min(chs[i].count, size);
     }
 
-    #pragma omp parallel for
-    for (int i = 0; i < size - exec->SimdWidth + 1; i += exec->SimdWidth) {
+    constexpr size_t W = zfx::x64::Executable::SimdWidth;
+    const intptr_t ngroups = size / W;
+
+    #pragma omp parallel
+    {
+        // one context per thread, a context holds SimdWidth * 256 floats of locals
+        // and making one for every lane group clears all of them
         auto ctx = exec->make_context();
-        for (int j = 0; j < chs.size(); j++) {
-            for (int k = 0; k < exec->SimdWidth; k++)
-                ctx.channel(j)[k] = chs[j].base[chs[j].stride * (i + k)];
-        }
-        ctx.execute();
-        for (int j = 0; j < chs.size(); j++) {
-            for (int k = 0; k < exec->SimdWidth; k++)
-                 chs[j].base[chs[j].stride * (i + k)] = ctx.channel(j)[k];
+
+        #pragma omp for
+        for (intptr_t g = 0; g < ngroups; g++) {
+            size_t i = g * W;
+            for (size_t j = 0; j < chs.size(); j++) {
+                for (size_t k = 0; k < W; k++)
+                    ctx.channel(j)[k] = chs[j].base[chs[j].stride * (i + k)];
+            }
+            ctx.execute();
+            for (size_t j = 0; j < chs.size(); j++) {
+                for (size_t k = 0; k < W; k++)
+                     chs[j].base[chs[j].stride * (i + k)] = ctx.channel(j)[k];
+            }
         }
     }
-    for (int i = size / exec->SimdWidth * exec->SimdWidth; i < size; i++) {
+    for (size_t i = ngroups * W; i < size; i++) {
         auto ctx = exec->make_context();
-        for (int j = 0; j < chs.size(); j++) {
+        for (size_t j = 0; j < chs.size(); j++) {
             ctx.channel(j)[0] = chs[j].base[chs[j].stride * i];
         }
         ctx.execute();
-        for (int j = 0; j < chs.size(); j++) {
+        for (size_t j = 0; j < chs.size(); j++) {
             chs[j].base[chs[j].stride * i] = ctx.channel(j)[0];
         }
     }
@@ -168,7 +178,7 @@ struct ParticlesWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         for (auto const &[name, dim]: prog->newsyms) {
             dbg_printf("auto-defined new attribute: %s with dim %d\n",
@@ -210,7 +220,7 @@ struct ParticlesWrangle : zeno::INode {
             });
             chs[i] = iob;
         }
-        vectors_wrangle(exec, chs);
+        vectors_wrangle(exec.get(), chs);
 
         set_output("prim", std::move(prim));
     }
@@ -20,11 +20,11 @@ namespace zeno {
 
 namespace {
 
-static zfx::Compiler compiler;
-static zfx::x64::Assembler assembler;
+static zfx::Compiler &compiler = zfx::Compiler::global();
+static zfx::x64::Assembler &assembler = zfx::x64::Assembler::global();
 
 template <class GridPtr>
-void vdb_wrangle(zfx::x64::Executable *exec, GridPtr &grid, bool modifyActive, bool changeBackground, bool hasPos) {
+void vdb_wrangle(zfx::x64::Executable::Instance *exec, GridPtr &grid, bool modifyActive, bool changeBackground, bool hasPos) {
     //ZENO_P(grid->background());
     auto wrangler = [&](auto &leaf, openvdb::Index leafpos) {
         std::visit([&] (auto hasPos) {
@@ -213,7 +213,7 @@ struct VDBWrangle : zeno::INode {
         }
 
         auto prog = compiler.compile(code, opts);
-        auto exec = assembler.assemble(prog->assembly);
+        auto exec = assembler.assemble(prog->assembly)->make_instance();
 
         std::vector<float> pars(prog->params.size());
         for (int i = 0; i < pars.size(); i++) {
@@ -231,9 +231,9 @@ struct VDBWrangle : zeno::INode {
         auto changeBackground = has_input("ChangeBackground") ?
             (get_input<zeno::StringObject>("ChangeBackground")->get())=="true" : false;
         if (auto p = std::dynamic_pointer_cast<zeno::VDBFloatGrid>(grid); p)
-            vdb_wrangle(exec, p->m_grid, modifyActive, changeBackground, hasPos);
+            vdb_wrangle(exec.get(), p->m_grid, modifyActive, changeBackground, hasPos);
         else if (auto p = std::dynamic_pointer_cast<zeno::VDBFloat3Grid>(grid); p)
-            vdb_wrangle(exec, p->m_grid, modifyActive, changeBackground, hasPos);
+            vdb_wrangle(exec.get(), p->m_grid, modifyActive, changeBackground, hasPos);
 
         set_output("grid", std::move(grid));
     }
@@ -46,6 +46,7 @@ struct ProgramRunData {
 
 #ifdef ZENO_MULTIPROCESS
     inline static std::unique_ptr<QProcess> g_proc;
+    inline static qint64 g_runnerPid = 0;
 #endif
 
     void operator()() const {
@@ -59,6 +60,8 @@ struct ProgramRunData {
             int code = g_proc->exitCode();
             g_proc = nullptr;
             zeno::log_info("runner process terminated with {}", code);
+            // reading was stopped, the files still in the pipe will never be decoded
+            viewDecodeRemoveSharedFiles(g_runnerPid);
         }
 #endif
         g_state = kStopped;
@@ -167,6 +170,7 @@ struct ProgramRunData {
             zeno::log_warn("process failed to get started, giving up");
             return;
         }
+        g_runnerPid = g_proc->processId();
 
         g_proc->write(progJson.data(), progJson.size());
         g_proc->closeWriteChannel();
@@ -197,6 +201,7 @@ struct ProgramRunData {
         int code = g_proc->exitCode();
         g_proc = nullptr;
         zeno::log_info("runner process exited with {}", code);
+        viewDecodeRemoveSharedFiles(g_runnerPid);
 #endif
     }
 };
@@ -5,16 +5,20 @@
 #include <filesystem>
 #include <zeno/utils/log.h>
 #include <zeno/utils/Timer.h>
+#include <zeno/utils/envconfig.h>
 #include <zeno/core/Graph.h>
 #include <zeno/extra/GlobalState.h>
 #include <zeno/extra/GlobalComm.h>
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/extra/GraphException.h>
+#include <zeno/extra/FramePipeline.h>
 #include <zeno/extra/EventCallbacks.h>
 #include <zeno/extra/assetDir.h>
 #include <zeno/funcs/ObjectCodec.h>
 #include <zeno/zeno.h>
 #include <string>
+#include <atomic>
+#include <optional>
 #ifdef ZENO_IPC_USE_TCP
 #include <QTcpServer>
 #include <QtWidgets>
@@ -35,6 +39,9 @@ static FILE *ourfp;
 static char ourbuf[1 << 20]; // 1MB
 #endif
 
+static constexpr size_t kPacketChunkSize = 1 << 20;
+static constexpr size_t kSharedObjectThreshold = 4 << 20;
+
 struct Header { // sync with viewdecode.cpp
     size_t total_size;
     size_t info_size;
@@ -62,25 +69,79 @@ static void send_packet(std::string_view info, const char *buf, size_t len) {
     std::memcpy(headbuffer.data() + 4 + sizeof(Header), info.data(), info.size());
 
     zeno::log_debug("runner tx head-buffer {} data-buffer {}", headbuffer.size(), len);
+    // header and info go out in one write, the payload in fixed-size chunks
 #ifdef ZENO_IPC_USE_TCP
-    for (char c: headbuffer) {
-        clientSocket->write(&c, 1);
+    clientSocket->write(headbuffer.data(), headbuffer.size());
+    for (size_t offset = 0; offset < len; offset += kPacketChunkSize) {
+        clientSocket->write(buf + offset, std::min(kPacketChunkSize, len - offset));
+        // don't let Qt buffer the whole object in user space
+        while (clientSocket->bytesToWrite() > 4 * kPacketChunkSize) {
+            clientSocket->waitForBytesWritten();
+        }
     }
-    clientSocket->write(buf, len);
     while (clientSocket->bytesToWrite() > 0) {
         clientSocket->waitForBytesWritten();
     }
 #else
-    for (char c : headbuffer) {
-        fputc(c, ourfp);
-    }
-    for (size_t i = 0; i < len; i++) {
-        fputc(buf[i], ourfp);
+    fwrite(headbuffer.data(), 1, headbuffer.size(), ourfp);
+    for (size_t offset = 0; offset < len; offset += kPacketChunkSize) {
+        fwrite(buf + offset, 1, std::min(kPacketChunkSize, len - offset), ourfp);
     }
     fflush(ourfp);
 #endif
 }
 
+using Packets = std::vector<std::pair<std::string, std::vector<char>>>;
+
+// ZENO_IPC_SHM=1: view objects bigger than kSharedObjectThreshold are written to a
+// file in shared memory (/dev/shm on linux) instead of being piped, the editor maps
+// it, decodes in place and removes it. The runner never removes them itself, the
+// packet naming a file may still be unread when it exits; the editor removes what
+// is left of a runner once it has read its output to the end
+static bool writeSharedObject(std::vector<char> const &buf, std::string &path) {
+    static std::atomic<int> counter{0};
+    auto fsPath = viewSharedFileDir() / viewSharedFileName(QCoreApplication::applicationPid(), counter++);
+    FILE *fp = fopen(fsPath.string().c_str(), "wb");
+    if (!fp) {
+        zeno::log_warn("cannot create shared object file {}, falling back to pipe", fsPath.string());
+        return false;
+    }
+    bool ok = fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+    fclose(fp);
+    if (!ok) {
+        std::filesystem::remove(fsPath);
+        return false;
+    }
+    path = fsPath.u8string();
+    return true;
+}
+
+static void makeViewObjectPacket(std::string const &key, std::vector<char> &&buf, Packets &packets) {
+    static const bool useSharedMemory = zeno::envconfig::getBool("IPC_SHM");
+    std::string path;
+    if (useSharedMemory && buf.size() >= kSharedObjectThreshold && writeSharedObject(buf, path)) {
+        packets.emplace_back("{\"action\":\"viewObjectFile\",\"key\":\"" + key + "\"}",
+                             std::vector<char>(path.begin(), path.end()));
+    } else {
+        packets.emplace_back("{\"action\":\"viewObject\",\"key\":\"" + key + "\"}", std::move(buf));
+    }
+}
+
+static void sendPackets(Packets const &packets) {
+    for (auto const &[info, data]: packets) {
+        send_packet(info, data.data(), data.size());
+    }
+}
+
+static void dumpFrameCacheLocked(int frame, std::string const &cachedir, bool cacheLightCameraOnly, bool cacheMaterialOnly) {
+    //construct cache lock.
+    std::string sLockFile = cachedir + "/" + zeno::iotags::sZencache_lockfile_prefix + std::to_string(frame) + ".lock";
+    QLockFile lckFile(QString::fromStdString(sLockFile));
+    bool ret = lckFile.tryLock();
+    //dump cache to disk.
+    zeno::getSession().globalComm->dumpFrameCache(frame, cacheLightCameraOnly, cacheMaterialOnly);
+}
+
 static int runner_start(std::string const &progJson, int sessionid, bool bZenCache, int cachenum, std::string cachedir, bool cacheautorm, bool cacheLightCameraOnly, bool cacheMaterialOnly, std::string zsg_path, std::string projectFps) {
     zeno::log_trace("runner got program JSON: {}", progJson);
     //MessageBox(0, "runner", "runner", MB_OK);           //convient to attach process by debugger, at windows.
@@ -109,7 +170,16 @@ static int runner_start(std::string const &progJson, int sessionid, bool bZenCac
         zeno::getSession().globalComm->frameCache("", 0);
     }
 
+    // ZENO_RUNNER_PIPELINE=1: frame output overlaps with evaluating the next frame,
+    // the packets are sent from here since the socket belongs to this thread
+    std::optional<zeno::FramePipeline<Packets>> pipeline;
+    if (zeno::envconfig::getBool("RUNNER_PIPELINE"))
+        pipeline.emplace(std::max(1, zeno::envconfig::getInt("RUNNER_PIPELINE_DEPTH", 2)), *session->globalStatus,
+                         [] (Packets &&packets) { sendPackets(packets); });
+
     auto onfail = [&] {
+        if (pipeline)
+            pipeline->flushAll();
         auto statJson = session->globalStatus->toJson();
         send_packet("{\"action\":\"reportStatus\"}", statJson.data(), statJson.size());
         return 1;
@@ -121,8 +191,6 @@ static int runner_start(std::string const &progJson, int sessionid, bool bZenCac
     if (session->globalStatus->failed())
         return onfail();
 
-    std::vector<char> buffer;
-
     session->globalComm->initFrameRange(graph->beginFrameNumber, graph->endFrameNumber);
     send_packet("{\"action\":\"frameRange\",\"key\":\""
                 + std::to_string(graph->beginFrameNumber)
@@ -151,31 +219,65 @@ static int runner_start(std::string const &progJson, int sessionid, bool bZenCac
 
         zeno::log_debug("end frame {}", frame);
 
+        if (pipeline) {
+            pipeline->flushReady();
+            if (bZenCache) {
+                pipeline->submit(frame, [=] {
+                    Packets packets;
+                    packets.emplace_back("{\"action\":\"newFrame\",\"key\":\"" + std::to_string(frame) + "\"}", std::vector<char>());
+                    dumpFrameCacheLocked(frame, cachedir, cacheLightCameraOnly, cacheMaterialOnly);
+                    packets.emplace_back("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", std::vector<char>());
+                    return packets;
+                });
+            } else {
+                // ToView adds clones, so evaluating the next frame won't touch these objects
+                auto viewObjs = session->globalComm->getViewObjects();
+                pipeline->submit(frame, [=, viewObjs = std::move(viewObjs)] {
+                    Packets packets;
+                    packets.emplace_back("{\"action\":\"newFrame\",\"key\":\"" + std::to_string(frame) + "\"}", std::vector<char>());
+                    for (auto const& [key, obj] : viewObjs) {
+                        std::vector<char> buf;
+                        if (zeno::encodeObject(obj.get(), buf))
+                            makeViewObjectPacket(key, std::move(buf), packets);
+                    }
+                    packets.emplace_back("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", std::vector<char>());
+                    return packets;
+                });
+            }
+            if (session->globalStatus->failed())
+                return onfail();
+            continue;
+        }
+
         send_packet("{\"action\":\"newFrame\",\"key\":\"" + std::to_string(frame) +"\"}", "", 0);
 
-        if (bZenCache) {
-            //construct cache lock.
-            std::string sLockFile = cachedir + "/" + zeno::iotags::sZencache_lockfile_prefix + std::to_string(frame) + ".lock";
-            QLockFile lckFile(QString::fromStdString(sLockFile));
-            bool ret = lckFile.tryLock();
-            //dump cache to disk.
-            session->globalComm->dumpFrameCache(frame, cacheLightCameraOnly, cacheMaterialOnly);
-        } else {
-            auto const& viewObjs = session->globalComm->getViewObjects();
-            zeno::log_debug("runner got {} view objects", viewObjs.size());
-            for (auto const& [key, obj] : viewObjs) {
-                if (zeno::encodeObject(obj.get(), buffer))
-                    send_packet("{\"action\":\"viewObject\",\"key\":\"" + key + "\"}",
-                        buffer.data(), buffer.size());
-                buffer.clear();
+        zeno::outputFrameCatched(frame, [&] {
+            if (bZenCache) {
+                dumpFrameCacheLocked(frame, cachedir, cacheLightCameraOnly, cacheMaterialOnly);
+            } else {
+                auto const& viewObjs = session->globalComm->getViewObjects();
+                zeno::log_debug("runner got {} view objects", viewObjs.size());
+                for (auto const& [key, obj] : viewObjs) {
+                    std::vector<char> buffer;
+                    if (zeno::encodeObject(obj.get(), buffer)) {
+                        Packets packets;
+                        makeViewObjectPacket(key, std::move(buffer), packets);
+                        sendPackets(packets);
+                    }
+                }
             }
-        }
+        }, *session->globalStatus);
 
         send_packet("{\"action\":\"finishFrame\",\"key\":\"" + std::to_string(frame) + "\"}", "", 0);
 
         if (session->globalStatus->failed())
             return onfail();
     }
+    if (pipeline) {
+        pipeline->flushAll();
+        if (session->globalStatus->failed())
+            return onfail();
+    }
     return 0;
 }
 
@@ -10,6 +10,8 @@
 #include <zeno/extra/GlobalComm.h>
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/funcs/ObjectCodec.h>
+#include <zeno/utils/mapped_file.h>
+#include <zeno/para/thread_pool.h>
 #ifdef ZENO_WITH_UnrealBridge
 #include "unrealhook.h"
 #endif
@@ -19,6 +21,9 @@
 #include <cassert>
 #include <vector>
 #include <string>
+#include <deque>
+#include <future>
+#include <filesystem>
 #include "launch/corelaunch.h"
 #include "settings/zsettings.h"
 #include "launch/ztcpserver.h"
@@ -44,7 +49,12 @@ struct PacketProc {
     std::string fcPath = {};
     int fcMax = 0;
 
+    // view objects are decoded on the thread pool while the following packets are
+    // still arriving, and added to GlobalComm in the order they were sent
+    std::deque<std::pair<std::string, std::future<std::shared_ptr<zeno::IObject>>>> pendingObjects;
+
     void onStart() {
+        pendingObjects.clear();
         globalCommNeedClean = 1;
         globalCommNeedNewFrame = 0;
         zeno::getSession().globalState->clearState();
@@ -53,6 +63,7 @@ struct PacketProc {
     }
 
     void onFinish() {
+        flushDecoded(true);
         clearGlobalIfNeeded();
         zeno::getSession().globalState->working = false;
     }
@@ -71,23 +82,63 @@ struct PacketProc {
         }
     }
 
-    bool processPacket(std::string const &action, std::string const &objKey, const char *buf, size_t len) {
+    // "viewObject" carries the encoded object, "viewObjectFile" the path of a file in
+    // shared memory holding it (written by the runner with ZENO_IPC_SHM=1)
+    void decodeAsync(std::string const &action, std::string const &objKey,
+                     std::shared_ptr<std::vector<char>> owner, size_t offset, size_t len) {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<zeno::IObject>>>();
+        pendingObjects.emplace_back(objKey, promise->get_future());
+        bool isFile = action == "viewObjectFile";
+        zeno::thread_pool::spawn([promise, owner = std::move(owner), offset, len, isFile] {
+            try {
+                const char *buf = owner->data() + offset;
+                if (!isFile) {
+                    promise->set_value(zeno::decodeObject(buf, len));
+                    return;
+                }
+                std::string path(buf, len);
+                std::shared_ptr<zeno::IObject> object;
+                {
+                    zeno::mapped_file file(path);
+                    if (file)
+                        object = zeno::decodeObject(file.data(), file.size());
+                }
+                std::error_code ec;
+                std::filesystem::remove(std::filesystem::u8path(path), ec);
+                promise->set_value(std::move(object));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
 
-        if (action == "viewObject") {
-            zeno::log_debug("decoding object");
-            auto object = zeno::decodeObject(buf, len);
-            //zeno::log_debug("object ident=[{}]", object->userData().get("ident"));
+    void flushDecoded(bool wait) {
+        while (!pendingObjects.empty()) {
+            auto &[objKey, future] = pendingObjects.front();
+            if (!wait && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                break;
+            std::shared_ptr<zeno::IObject> object;
+            try {
+                object = future.get();
+            } catch (std::exception const &e) {
+                zeno::log_warn("exception when decoding view object: {}", e.what());
+            }
             if (!object) {
                 zeno::log_warn("failed to decode view object");
-                return false;
-            }
+            } else {
 #ifdef ZENO_WITH_UnrealBridge
-            zeno::UnrealHook::fetchViewObject(objKey, object);
+                zeno::UnrealHook::fetchViewObject(objKey, object);
 #endif
-            clearGlobalIfNeeded();
-            zeno::getSession().globalComm->addViewObject(objKey, object);
+                clearGlobalIfNeeded();
+                zeno::getSession().globalComm->addViewObject(objKey, object);
+            }
+            pendingObjects.pop_front();
+        }
+    }
 
-        } else if (action == "newFrame") {
+    bool processPacket(std::string const &action, std::string const &objKey, const char *buf, size_t len) {
+
+        if (action == "newFrame") {
             globalCommNeedNewFrame = 1;
             clearGlobalIfNeeded();
 
@@ -162,7 +213,8 @@ struct PacketProc {
         return true;
     }
 
-    bool parsePacket(const char *buf, Header const &header) {
+    bool parsePacket(std::vector<char> &buffer, Header const &header) {
+        const char *buf = buffer.data();
         zeno::log_debug("viewDecodePacket: n={}", header.total_size);
         if (header.total_size < header.info_size) {
             zeno::log_warn("total_size < info_size");
@@ -197,6 +249,15 @@ struct PacketProc {
 
         zeno::log_debug("decoder got action=[{}] key=[{}] size={}", action, objKey, size);
 
+        if (action == "viewObject" || action == "viewObjectFile") {
+            auto owner = std::make_shared<std::vector<char>>(std::move(buffer));
+            decodeAsync(action, objKey, std::move(owner), header.info_size, size);
+            flushDecoded(false);
+            return true;
+        }
+
+        // everything else (newFrame, finishFrame, ...) must see the objects sent before it
+        flushDecoded(true);
         return processPacket(action, objKey, data, size);
     }
 
@@ -250,7 +311,7 @@ struct ViewDecodeData {
                 if (buffercurr >= header().total_size) {
                     buffercurr = 0;
                     zeno::log_debug("finish rx, parsing packet of size {}", header().total_size);
-                    packetProc.parsePacket(buffer.data(), header());
+                    packetProc.parsePacket(buffer, header());
                     phase = 0;
                 }
             } else if (phase == 0) {
@@ -335,4 +396,33 @@ void viewDecodeAppend(const char *buf, size_t n)
     zeno::log_debug("viewDecodeAppend n={}", n);
     viewDecodeData.append(buf, n);
 }
+
+std::filesystem::path viewSharedFileDir()
+{
+    std::error_code ec;
+    if (std::filesystem::is_directory("/dev/shm", ec))
+        return "/dev/shm";
+    return std::filesystem::temp_directory_path();
+}
+
+std::string viewSharedFileName(long long runnerPid, int index)
+{
+    return "zeno_ipc_" + std::to_string(runnerPid) + "_" + std::to_string(index) + ".zobj";
+}
+
+void viewDecodeRemoveSharedFiles(long long runnerPid)
+{
+    if (runnerPid <= 0)
+        return;
+    auto prefix = "zeno_ipc_" + std::to_string(runnerPid) + "_";
+    std::error_code ec;
+    for (auto const &entry: std::filesystem::directory_iterator(viewSharedFileDir(), ec)) {
+        auto name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) != 0)
+            continue;
+        std::error_code rmec;
+        if (std::filesystem::remove(entry.path(), rmec))
+            zeno::log_debug("removed unread shared object file {}", entry.path().string());
+    }
+}
 #endif
@@ -2,9 +2,20 @@
 
 #ifdef ZENO_MULTIPROCESS
 #include <cstddef>
+#include <filesystem>
+#include <string>
 
 void viewDecodeClear();
 void viewDecodeAppend(const char *buf, size_t n);
 void viewDecodeSetFrameCache(const char *path, int gcmax);
 void viewDecodeFinish();
+
+// ZENO_IPC_SHM: the runner writes view objects too big for the pipe to files in here,
+// named by sharedFileName; the editor removes each one after decoding it
+std::filesystem::path viewSharedFileDir();
+std::string viewSharedFileName(long long runnerPid, int index);
+// removes the files of a runner whose output has been read to the end, these were
+// never announced to the editor (runner killed, or reading was stopped) and nobody
+// else is going to remove them
+void viewDecodeRemoveSharedFiles(long long runnerPid);
 #endif
@@ -128,6 +128,7 @@ void ZTcpServer::startProc(const std::string& progJson, LAUNCH_PARAM param)
         zeno::log_warn("process failed to get started, giving up");
         return;
     }
+    m_runnerPid = m_proc->processId();
 
     m_proc->write(progJson.data(), progJson.size());
     m_proc->closeWriteChannel();
@@ -402,6 +403,8 @@ void ZTcpServer::onDisconnect()
     }*/
 
     viewDecodeFinish();
+    // everything the runner announced has been read and decoded by now
+    viewDecodeRemoveSharedFiles(m_runnerPid);
 }
 
 void ZTcpServer::onProcFinished(int exitCode, QProcess::ExitStatus exitStatus)
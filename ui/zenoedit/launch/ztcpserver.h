@@ -45,6 +45,7 @@ private:
     QLocalServer* m_optixServer;
     QVector<QLocalSocket*> m_optixSockets;
     std::unique_ptr<QProcess> m_proc;
+    qint64 m_runnerPid = 0;
 
     std::vector<std::unique_ptr<QProcess>> m_optixProcs;
     int m_port;
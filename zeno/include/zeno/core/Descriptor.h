@@ -33,6 +33,14 @@ struct Descriptor {
   std::vector<std::string> categories;
   std::string doc;
 
+  // filled in from the node class when it is registered, see defNode.h
+  bool hasNodeTraits = false;
+  // overrides preApply, i.e. decides itself which inputs to evaluate
+  bool lazyInputs = false;
+  // declares itself a pure function of its inputs which it never modifies,
+  // see INode::computeMemoKey
+  bool memoizable = false;
+
   ZENO_API Descriptor();
   ZENO_API Descriptor(
 	  std::vector<SocketDescriptor> const &inputs,
@@ -8,6 +8,7 @@
 #include <variant>
 #include <memory>
 #include <string>
+#include <mutex>
 #include <set>
 #include <any>
 #include <map>
@@ -21,11 +22,19 @@ struct INode;
 
 struct Context {
     std::set<std::string> visited;
+    std::mutex visitedMtx;  // guards visited when nodes are applied by the parallel scheduler
+    bool memoize = false;   // reuse outputs of nodes whose memo key did not change
 
     inline void mergeVisited(Context const &other) {
+        std::lock_guard lck(visitedMtx);
         visited.insert(other.visited.begin(), other.visited.end());
     }
 
+    inline bool markVisited(std::string const &id) {
+        std::lock_guard lck(visitedMtx);
+        return visited.insert(id).second;
+    }
+
     ZENO_API Context();
     ZENO_API Context(Context const &other);
     ZENO_API ~Context();
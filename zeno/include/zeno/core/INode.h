@@ -34,6 +34,15 @@ public:
     std::set<std::string> formulas;
     zany muted_output;
 
+    // memoization (ZENO_MEMOIZE=1) of nodes declaring `memoizable`: outputs are reused
+    // while the key computed from the parameters and upstream output versions stays
+    // the same; memoOutputs keeps the objects apply() produced, shared with the
+    // consumers that do not modify them, see preApply and requireInput
+    std::size_t memoKey = 0;
+    std::size_t outputVersion = 0;  // bumped whenever apply() actually runs
+    std::map<std::string, zany> memoOutputs;
+    mutable bool touchedGlobals = false;
+
     ZENO_API INode();
     ZENO_API virtual ~INode();
 
@@ -56,6 +65,9 @@ public:
 
     ZENO_API virtual void preApply();
 
+    // 0 if this node may not be memoized in its current state
+    ZENO_API std::size_t computeMemoKey() const;
+
     ZENO_API Graph *getThisGraph() const;
     ZENO_API Session *getThisSession() const;
     ZENO_API GlobalState *getGlobalState() const;
@@ -26,6 +26,7 @@ struct GlobalState;
 struct GlobalComm;
 struct GlobalStatus;
 struct EventCallbacks;
+struct GlobalProfiler;
 struct UserData;
 
 struct Session {
@@ -36,6 +37,7 @@ struct Session {
     std::unique_ptr<GlobalStatus> const globalStatus;
     std::unique_ptr<EventCallbacks> const eventCallbacks;
     std::unique_ptr<UserData> const m_userData;
+    std::unique_ptr<GlobalProfiler> const globalProfiler;
 
     ZENO_API Session();
     ZENO_API ~Session();
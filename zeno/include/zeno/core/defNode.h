@@ -1,9 +1,27 @@
 #pragma once
 
 #include <zeno/core/Session.h>
+#include <type_traits>
 
 namespace zeno {
 
+// nodes opt into memoization with `static constexpr bool memoizable = true;`,
+// they must not modify their input objects, which may be shared with a memo
+template <class T, class = void>
+struct is_memoizable_node : std::false_type {};
+
+template <class T>
+struct is_memoizable_node<T, std::void_t<decltype(T::memoizable)>> : std::bool_constant<T::memoizable> {};
+
+// record what the graph evaluator needs to know about a node class
+template <class T>
+Descriptor describeNodeClass(Descriptor desc) {
+    desc.hasNodeTraits = true;
+    desc.lazyInputs = !std::is_same_v<decltype(&T::preApply), void (INode::*)()>;
+    desc.memoizable = is_memoizable_node<T>::value;
+    return desc;
+}
+
 // deprecated
 //template <class F>
 //auto _defOverloadNodeClassHelper(F const &func, std::string const &name, std::vector<std::string> const &types) {
@@ -17,7 +35,7 @@ namespace zeno {
     static struct _Def##Class { \
         _Def##Class(::zeno::Descriptor const &desc) { \
             ::zeno::getSession().defNodeClass([] () -> std::unique_ptr<::zeno::INode> { \
-                return std::make_unique<Class>(); }, #Class, desc); \
+                return std::make_unique<Class>(); }, #Class, ::zeno::describeNodeClass<Class>(desc)); \
         } \
     } _def##Class
 
@@ -25,7 +43,7 @@ namespace zeno {
 template <class T>
 [[deprecated("use ZENO_DEFNODE(T)(...)")]]
 inline int defNodeClass(std::string const &id, Descriptor const &desc = {}) {
-    getSession().defNodeClass([] () -> std::unique_ptr<INode> { return std::make_unique<T>(); }, id, desc);
+    getSession().defNodeClass([] () -> std::unique_ptr<INode> { return std::make_unique<T>(); }, id, describeNodeClass<T>(desc));
     return 1;
 }
 
@@ -5,6 +5,7 @@
 #include <zeno/utils/safe_dynamic_cast.h>
 #include <zeno/funcs/ObjectCodec.h>
 #include <zeno/types/UserData.h>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -12,12 +13,15 @@ namespace zeno {
 
 struct DirtyChecker {
     std::set<std::string> dirts;
+    mutable std::mutex mtx;
 
     void taintThisNode(std::string ident) {
+        std::lock_guard lck(mtx);
         dirts.insert(std::move(ident));
     }
 
     bool amIDirty(std::string const &ident) const {
+        std::lock_guard lck(mtx);
         return dirts.find(ident) != dirts.end();
     }
 };
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <zeno/extra/GlobalStatus.h>
+#include <zeno/extra/GraphException.h>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <string>
+#include <deque>
+#include <mutex>
+
+namespace zeno {
+
+// errors while encoding / dumping a frame are reported like node errors, under
+// this name, so that the editor gets a reportStatus instead of a dead runner
+inline std::string frameOutputName(int frame) {
+    return "<output frame " + std::to_string(frame) + ">";
+}
+
+template <class Func>
+void outputFrameCatched(int frame, Func &&func, GlobalStatus &globalStatus) {
+    GlobalStatus status;
+    GraphException::catched([&] {
+        GraphException::translated(std::forward<Func>(func), frameOutputName(frame));
+    }, status);
+    // keep the first error if an earlier frame already failed
+    if (status.failed() && !globalStatus.failed())
+        globalStatus = std::move(status);
+}
+
+// frame N is prepared (encoded / written to zencache) on a background thread while
+// frame N+1 is being evaluated. The results are still sent from the thread owning
+// the pipeline and always in frame order; errors of either step go to globalStatus.
+template <class Result>
+struct FramePipeline {
+    std::size_t maxInFlight;
+    GlobalStatus &globalStatus;
+    std::function<void(Result &&)> send;
+    std::deque<std::pair<int, std::future<Result>>> inflight;
+    std::deque<std::packaged_task<Result()>> queue;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool quit = false;
+    std::thread worker;
+
+    FramePipeline(std::size_t maxInFlight, GlobalStatus &globalStatus, std::function<void(Result &&)> send)
+        : maxInFlight(std::max<std::size_t>(1, maxInFlight)), globalStatus(globalStatus)
+        , send(std::move(send)), worker([this] { workerLoop(); })
+    {}
+
+    FramePipeline(FramePipeline const &) = delete;
+    FramePipeline &operator=(FramePipeline const &) = delete;
+
+    ~FramePipeline() {
+        {
+            std::lock_guard lck(mtx);
+            quit = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::packaged_task<Result()> task;
+            {
+                std::unique_lock lck(mtx);
+                cv.wait(lck, [&] { return quit || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    template <class Func>
+    void submit(int frame, Func &&func) {
+        // bound the number of frames held in memory
+        while (inflight.size() >= maxInFlight)
+            sendOldest();
+        std::packaged_task<Result()> task(std::forward<Func>(func));
+        inflight.emplace_back(frame, task.get_future());
+        {
+            std::lock_guard lck(mtx);
+            queue.push_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    void sendOldest() {
+        int frame = inflight.front().first;
+        auto fut = std::move(inflight.front().second);
+        inflight.pop_front();
+        // the prepare exception, if any, is rethrown by get()
+        outputFrameCatched(frame, [&] {
+            send(fut.get());
+        }, globalStatus);
+    }
+
+    void flushReady() {
+        while (!inflight.empty() && inflight.front().second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            sendOldest();
+    }
+
+    void flushAll() {
+        while (!inflight.empty())
+            sendOldest();
+    }
+};
+
+}
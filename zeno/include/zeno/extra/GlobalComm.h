@@ -2,10 +2,15 @@
 
 #include <zeno/core/IObject.h>
 #include <zeno/utils/PolymorphicMap.h>
+#include <zeno/funcs/ObjectCodec.h>
 #include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <functional>
@@ -24,18 +29,41 @@ struct GlobalComm {
     struct FrameData {
         ViewObjects view_objects;
         FRAME_STATE frame_state = FRAME_UNFINISH;
+        std::size_t cacheBytes = 0;  // memory held while loaded back from disk
+        std::uint64_t lastUsed = 0;
+        bool loading = false;
     };
     std::vector<FrameData> m_frames;
     int m_maxPlayFrame = 0;
-    std::set<int> m_inCacheFrames;
+    std::set<int> m_inCacheFrames;  // frames loaded back from disk
+    std::size_t m_inCacheBytes = 0;
+    std::uint64_t m_useTick = 0;
+    std::uint64_t m_cacheEpoch = 0;  // bumped when frames are cleared, so that loads in flight are dropped
+    int m_lastRequestedFrame = -1;
     mutable std::mutex m_mtx;
+    std::condition_variable m_loadCv;
+
+    std::thread m_prefetchThread;
+    std::condition_variable m_prefetchCv;
+    std::deque<int> m_prefetchQueue;
+    bool m_prefetchStop = false;
 
     int beginFrameNumber = 0;
     int endFrameNumber = 0;
-    int maxCachedFrames = 1;
+    int maxCachedFrames = 1;  // 0 keeps every frame in memory, otherwise how many frames loaded back from cacheFramePath stay in memory
+    std::size_t maxCacheBytes = 0;  // optional LRU byte budget for the frames loaded back, 0 for none
+    int prefetchFrames = 2;  // frames loaded ahead in playback direction
     std::string cacheFramePath;
+    ObjectCodecOptions cacheCodec;  // how objects are encoded into zencache files
+
+    GlobalComm() = default;
+    GlobalComm(GlobalComm const &) = delete;
+    GlobalComm &operator=(GlobalComm const &) = delete;
+    ZENO_API ~GlobalComm();
 
     ZENO_API void frameCache(std::string const &path, int gcmax);
+    ZENO_API void setCacheCodec(ObjectCodecOptions const &options);
+    ZENO_API void setCacheBudget(std::size_t maxBytes, int prefetch);
     ZENO_API void initFrameRange(int beg, int end);
     ZENO_API void newFrame();
     ZENO_API void finishFrame();
@@ -61,7 +89,12 @@ struct GlobalComm {
     ZENO_API void removeCachePath();
 
 private:
-    ViewObjects const *_getViewObjects(const int frameid);
+    ViewObjects const *_getViewObjects(std::unique_lock<std::mutex> &lck, const int frameid,
+                                       std::vector<ViewObjects> &evicted, bool prefetch = false);
+    void _evictFrames(int keepFrameid, std::vector<ViewObjects> &evicted);
+    void _prefetchFrom(int frameid);
+    void _prefetchLoop();
+    void _resetFrameCache();
 };
 
 }
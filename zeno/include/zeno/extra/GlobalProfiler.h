@@ -0,0 +1,94 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <map>
+
+namespace zeno {
+
+struct INode;
+struct INodeClass;
+struct IObject;
+
+struct GlobalProfiler {
+    using ClockType = std::chrono::steady_clock;
+
+    struct Record {
+        std::string nodeName;
+        std::string nodeClass;
+        int frameid = 0;
+        int threadid = 0;
+        int64_t beginUs = 0;     // since the profiler was enabled
+        int64_t wallUs = 0;      // including the time spent waiting for inputs
+        int64_t waitUs = 0;      // time spent in requireInput (evaluating upstream nodes)
+        std::size_t outputBytes = 0;  // memory held by the output objects
+        std::size_t outputVerts = 0;  // summed over PrimitiveObject outputs
+        std::size_t outputFaces = 0;  // tris + quads + polys
+    };
+
+    // measures one INode::doApply, nested scopes track the upstream nodes
+    struct NodeScope {
+        GlobalProfiler *profiler = nullptr;
+        INode *node = nullptr;
+        NodeScope *parent = nullptr;
+        ClockType::time_point beg;
+        int64_t waitUs = 0;
+
+        ZENO_API NodeScope(GlobalProfiler *profiler, INode *node);
+        ZENO_API ~NodeScope();
+
+        NodeScope(NodeScope const &) = delete;
+        NodeScope &operator=(NodeScope const &) = delete;
+    };
+
+    // accounts the enclosed time as waiting time of the innermost NodeScope
+    struct WaitScope {
+        NodeScope *owner = nullptr;
+        ClockType::time_point beg;
+
+        ZENO_API WaitScope();
+        ZENO_API ~WaitScope();
+
+        WaitScope(WaitScope const &) = delete;
+        WaitScope &operator=(WaitScope const &) = delete;
+    };
+
+private:
+    std::atomic<bool> m_enabled{false};
+    ClockType::time_point m_epoch = ClockType::now();
+    std::vector<Record> m_records;
+    std::map<INodeClass const *, std::string> m_classNames;
+    mutable std::mutex m_mtx;
+    std::string m_dumpPrefix;
+
+    std::string classNameOf(INode *node);
+    void addRecord(Record &&rec);
+
+public:
+    ZENO_API GlobalProfiler();
+    ZENO_API ~GlobalProfiler();
+
+    GlobalProfiler(GlobalProfiler const &) = delete;
+    GlobalProfiler &operator=(GlobalProfiler const &) = delete;
+
+    bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    ZENO_API void setEnabled(bool enabled);
+    ZENO_API void clear();
+    ZENO_API std::vector<Record> getRecords() const;
+
+    // chrome://tracing or https://ui.perfetto.dev compatible trace-event JSON
+    ZENO_API std::string toChromeTrace() const;
+    ZENO_API std::string toCSV() const;
+    ZENO_API bool dumpChromeTrace(std::string const &path) const;
+    ZENO_API bool dumpCSV(std::string const &path) const;
+};
+
+}
@@ -7,7 +7,14 @@
 
 namespace zeno {
 
+struct ObjectCodecOptions {
+    bool compress = false;  // lossless block compression of primitive attributes
+    int positionBits = 0;   // quantize vertex positions to N bits within the bbox (lossy, implies compress)
+};
+
 ZENO_API std::shared_ptr<IObject> decodeObject(const char *buf, size_t len);
 ZENO_API bool encodeObject(IObject const *object, std::vector<char> &buf);
+// also applies to nested objects (list elements, user data); decodeObject detects it
+ZENO_API bool encodeObject(IObject const *object, std::vector<char> &buf, ObjectCodecOptions const &options);
 
 }
@@ -8,4 +8,13 @@ namespace zeno {
 ZENO_API bool objectGetBoundingBox(IObject *ptr, vec3f &bmin, vec3f &bmax);
 ZENO_API bool objectGetFocusCenterRadius(IObject *ptr, vec3f &center, float &radius);
 
+struct ObjectMemoryStats {
+    std::size_t bytes = 0;  // attribute arrays only, small objects count as zero
+    std::size_t verts = 0;
+    std::size_t faces = 0;  // tris + quads + polys
+};
+
+// accumulates into stats, recursing into lists and dicts
+ZENO_API void objectGetMemoryStats(IObject *ptr, ObjectMemoryStats &stats);
+
 }
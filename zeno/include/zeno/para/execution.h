@@ -2,6 +2,8 @@
 
 #ifdef ZENO_PARALLEL_STL
 #include <execution>
+#else
+#include <zeno/para/thread_pool.h>
 #endif
 
 namespace zeno {
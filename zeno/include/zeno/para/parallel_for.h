@@ -3,11 +3,15 @@
 #include <zeno/para/execution.h>
 #include <zeno/para/counter_iterator.h>
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
 
 namespace zeno {
 
+#ifdef ZENO_PARALLEL_STL
+
 template <class Index, class Func>
-void parallel_for(Index first, Index last, Func func) {
+void parallel_for(Index first, Index last, Func func, std::size_t grain = 0) {
     std::for_each(ZENO_PAR counter_iterator<Index>(first), counter_iterator<Index>(last), func);
 }
 
@@ -21,4 +25,34 @@ void parallel_for_each(It first, It last, Func func) {
     std::for_each(ZENO_PAR_UNSEQ first, last, func);
 }
 
+#else
+
+template <class Index, class Func>
+void parallel_for(Index first, Index last, Func func, std::size_t grain = 0) {
+    parallel_for_range(first, last, [&func] (Index b, Index e) {
+        for (Index i = b; i != e; ++i) {
+            func(i);
+        }
+    }, grain);
+}
+
+template <class Index, class Func>
+void parallel_for(Index count, Func func) {
+    parallel_for(Index{}, count, std::move(func));
+}
+
+template <class It, class Func>
+void parallel_for_each(It first, It last, Func func) {
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                  typename std::iterator_traits<It>::iterator_category>) {
+        parallel_for_range(std::size_t{}, (std::size_t)(last - first), [&func, first] (std::size_t b, std::size_t e) {
+            std::for_each(first + b, first + e, func);
+        });
+    } else {
+        std::for_each(first, last, func);
+    }
+}
+
+#endif
+
 }
@@ -10,7 +10,20 @@ namespace zeno {
 template <class ...Tasks>
 void parallel_invoke(Tasks &&...tasks) {
     std::array<std::function<void()>, sizeof...(Tasks)> tmp{std::forward<Tasks>(tasks)...};
+#ifdef ZENO_PARALLEL_STL
     std::for_each(ZENO_PAR tmp.begin(), tmp.end(), [] (auto &&f) { std::move(f)(); });
+#elif defined(ZENO_PARALLEL_POOL)
+    fork_join fj;
+    fj.run_and_join([&] {
+        for (std::size_t i = 1; i < tmp.size(); i++) {
+            fj.fork([&f = tmp[i]] { std::move(f)(); });
+        }
+        if (tmp.size())
+            std::move(tmp[0])();
+    });
+#else
+    std::for_each(tmp.begin(), tmp.end(), [] (auto &&f) { std::move(f)(); });
+#endif
 }
 
 //inline void parallel_invoke(std::initializer_list<std::function<void()> tasks) {
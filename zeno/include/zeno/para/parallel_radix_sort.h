@@ -0,0 +1,78 @@
+#pragma once
+
+#include <zeno/para/parallel_for.h>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <vector>
+
+namespace zeno {
+
+// stable LSD radix sort of unsigned integer keys, vals are permuted along;
+// 8 bit digits, passes where all keys share the same digit are skipped.
+// the chunking only depends on n, so the result is always the same
+template <class Key, class Val>
+void parallel_radix_sort(std::vector<Key> &keys, std::vector<Val> &vals) {
+    static_assert(std::is_unsigned_v<Key>, "radix sort keys must be unsigned");
+    std::size_t n = keys.size();
+    if (n <= 1) return;
+    std::size_t nchunks = std::min<std::size_t>(256, (n + 16383) / 16384);
+    std::size_t grain = (n + nchunks - 1) / nchunks;
+    nchunks = (n + grain - 1) / grain;
+
+    std::vector<Key> chunkAnd(nchunks), chunkOr(nchunks);
+    parallel_for(nchunks, [&] (std::size_t c) {
+        std::size_t b = c * grain, e = std::min(b + grain, n);
+        Key a = keys[b], o = keys[b];
+        for (std::size_t i = b + 1; i < e; i++) {
+            a &= keys[i];
+            o |= keys[i];
+        }
+        chunkAnd[c] = a;
+        chunkOr[c] = o;
+    });
+    Key allAnd = chunkAnd[0], allOr = chunkOr[0];
+    for (std::size_t c = 1; c < nchunks; c++) {
+        allAnd &= chunkAnd[c];
+        allOr |= chunkOr[c];
+    }
+    // bits set in some keys but not in others
+    Key diff = allAnd ^ allOr;
+
+    std::vector<Key> tmpKeys(n);
+    std::vector<Val> tmpVals(n);
+    std::vector<std::size_t> hist(nchunks * 256);
+    for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8) {
+        if (!((diff >> shift) & 0xff))
+            continue;
+        parallel_for(nchunks, [&] (std::size_t c) {
+            std::size_t *h = hist.data() + c * 256;
+            std::fill(h, h + 256, 0);
+            std::size_t b = c * grain, e = std::min(b + grain, n);
+            for (std::size_t i = b; i < e; i++)
+                h[(keys[i] >> shift) & 0xff]++;
+        });
+        // digit major, chunk minor, which keeps equal digits in input order
+        std::size_t acc = 0;
+        for (std::size_t d = 0; d < 256; d++) {
+            for (std::size_t c = 0; c < nchunks; c++) {
+                std::size_t cnt = hist[c * 256 + d];
+                hist[c * 256 + d] = acc;
+                acc += cnt;
+            }
+        }
+        parallel_for(nchunks, [&] (std::size_t c) {
+            std::size_t *h = hist.data() + c * 256;
+            std::size_t b = c * grain, e = std::min(b + grain, n);
+            for (std::size_t i = b; i < e; i++) {
+                std::size_t dst = h[(keys[i] >> shift) & 0xff]++;
+                tmpKeys[dst] = keys[i];
+                tmpVals[dst] = std::move(vals[i]);
+            }
+        });
+        keys.swap(tmpKeys);
+        vals.swap(tmpVals);
+    }
+}
+
+}
@@ -6,20 +6,76 @@
 #include <zeno/utils/vec.h>
 #include <numeric>
 #include <limits>
+#include <iterator>
+#include <vector>
 #include <tuple>
 
 namespace zeno {
 
+#ifdef ZENO_PARALLEL_STL
+
 template <class Index, class Value, class Reduce, class Transform>
-Value parallel_reduce(Index first, Index last, Value initVal, Reduce reduceFn, Transform transformFn) {
+Value parallel_reduce(Index first, Index last, Value initVal, Reduce reduceFn, Transform transformFn, std::size_t grain = 0) {
     return std::transform_reduce(ZENO_PAR counter_iterator<Index>(first), counter_iterator<Index>(last),
             initVal, reduceFn, transformFn);
 }
 
+#else
+
+// partial results are combined in chunk order, so the result does not depend
+// on the number of threads nor on which thread ran which chunk
+template <class Index, class Value, class Reduce, class Transform>
+Value parallel_reduce(Index first, Index last, Value initVal, Reduce reduceFn, Transform transformFn, std::size_t grain = 0) {
+    if (!(first < last)) return initVal;
+    std::size_t n = last - first;
+    grain = para_details::deterministic_grain(n, grain);
+    std::size_t nchunks = (n + grain - 1) / grain;
+    if (nchunks == 1) {
+        Value val = initVal;
+        for (Index i = first; i != last; ++i)
+            val = reduceFn(val, transformFn(i));
+        return val;
+    }
+    std::vector<Value> partials(nchunks, initVal);
+    parallel_for_chunks(first, last, grain, [&] (std::size_t c, Index b, Index e) {
+        Value val = transformFn(b);
+        for (Index i = b + 1; i != e; ++i)
+            val = reduceFn(val, transformFn(i));
+        partials[c] = std::move(val);
+    });
+    Value val = initVal;
+    for (auto &part: partials)
+        val = reduceFn(val, std::move(part));
+    return val;
+}
+
+#endif
+
+namespace para_details {
+
+template <class It, class Value, class Reduce, class Transform>
+Value parallel_reduce_iter(It first, It last, Value initVal, Reduce reduceFn, Transform transformFn) {
+#ifdef ZENO_PARALLEL_STL
+    return std::transform_reduce(ZENO_PAR_UNSEQ first, last, initVal, reduceFn, transformFn);
+#else
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                  typename std::iterator_traits<It>::iterator_category>) {
+        return parallel_reduce(std::size_t{}, (std::size_t)(last - first), std::move(initVal), reduceFn,
+                               [&transformFn, first] (std::size_t i) {
+            return transformFn(first[i]);
+        });
+    } else {
+        return std::transform_reduce(first, last, initVal, reduceFn, transformFn);
+    }
+#endif
+}
+
+}
+
 template <class It, class Transform = identity>
 auto parallel_reduce_min(It first, It last, Transform transformFn = {}) {
     if (first == last) return std::decay_t<decltype(*first)>();
-    return std::transform_reduce(ZENO_PAR_UNSEQ first, last, *first, [] (auto &&x, auto &&y) {
+    return para_details::parallel_reduce_iter(first, last, *first, [] (auto &&x, auto &&y) {
         return zeno::min(x, y);
     }, transformFn);
 }
@@ -27,7 +83,7 @@ auto parallel_reduce_min(It first, It last, Transform transformFn = {}) {
 template <class It, class Transform = identity>
 auto parallel_reduce_max(It first, It last, Transform transformFn = {}) {
     if (first == last) return std::decay_t<decltype(*first)>();
-    return std::transform_reduce(ZENO_PAR_UNSEQ first, last, *first, [] (auto &&x, auto &&y) {
+    return para_details::parallel_reduce_iter(first, last, *first, [] (auto &&x, auto &&y) {
         return zeno::max(x, y);
     }, transformFn);
 }
@@ -35,7 +91,7 @@ auto parallel_reduce_max(It first, It last, Transform transformFn = {}) {
 template <class It, class Transform = identity>
 auto parallel_reduce_minmax(It first, It last, Transform transformFn = {}) {
     if (first == last) return std::make_pair(std::decay_t<decltype(*first)>(), std::decay_t<decltype(*first)>());
-    return std::transform_reduce(ZENO_PAR_UNSEQ first, last, std::make_pair(*first, *first), [] (auto &&x, auto &&y) {
+    return para_details::parallel_reduce_iter(first, last, std::make_pair(*first, *first), [] (auto &&x, auto &&y) {
         return std::make_pair(zeno::min(x.first, y.first), zeno::max(x.second, y.second));
     }, [transformFn] (auto const &val) {
         return std::make_pair(val, val);
@@ -44,7 +100,7 @@ auto parallel_reduce_minmax(It first, It last, Transform transformFn = {}) {
 
 template <class It, class Transform = identity>
 auto parallel_reduce_sum(It first, It last, Transform transformFn = {}) {
-    return std::transform_reduce(ZENO_PAR_UNSEQ first, last, std::decay_t<decltype(transformFn(*first))>(), [] (auto &&x, auto &&y) {
+    return para_details::parallel_reduce_iter(first, last, std::decay_t<decltype(transformFn(*first))>(), [] (auto &&x, auto &&y) {
         return x + y;
     }, transformFn);
 }
@@ -6,10 +6,13 @@
 #include <zeno/utils/vec.h>
 #include <numeric>
 #include <limits>
+#include <vector>
 #include <tuple>
 
 namespace zeno {
 
+#ifdef ZENO_PARALLEL_STL
+
 template <class Index, class OutputIt, class Value, class Reduce, class Transform>
 OutputIt parallel_inclusive_scan(Index first, Index last, OutputIt dest,
                     Value initVal, Reduce reduceFn, Transform transformFn) {
@@ -48,4 +51,86 @@ auto parallel_exclusive_scan_sum(It first, It last, OutputIt dest, Transform tra
         return std::decay_t<decltype(transformFn(*first))>();
 }
 
+#else
+
+namespace para_details {
+
+// two passes over fixed chunks: local inclusive scans written to dest, then
+// the (serially scanned) chunk totals are folded in; dest must be readable
+template <class OutputIt, class Value, class Reduce, class Transform>
+Value chunked_scan(std::size_t n, OutputIt dest, Value initVal,
+                   Reduce reduceFn, Transform transformFn, bool exclusive) {
+    if (!n) return initVal;
+    std::size_t grain = deterministic_grain(n, 0);
+    std::size_t nchunks = (n + grain - 1) / grain;
+    std::vector<Value> offsets(nchunks + 1, initVal);
+    parallel_for_chunks(std::size_t{}, n, grain, [&] (std::size_t c, std::size_t b, std::size_t e) {
+        Value val = transformFn(b);
+        dest[b] = val;
+        for (std::size_t i = b + 1; i != e; ++i) {
+            val = reduceFn(val, transformFn(i));
+            dest[i] = val;
+        }
+        offsets[c + 1] = std::move(val);
+    });
+    for (std::size_t c = 0; c < nchunks; c++)
+        offsets[c + 1] = reduceFn(offsets[c], offsets[c + 1]);
+    parallel_for_chunks(std::size_t{}, n, grain, [&] (std::size_t c, std::size_t b, std::size_t e) {
+        Value const &off = offsets[c];
+        if (exclusive) {
+            for (std::size_t i = e - 1; i != b; --i)
+                dest[i] = reduceFn(off, dest[i - 1]);
+            dest[b] = off;
+        } else {
+            for (std::size_t i = b; i != e; ++i)
+                dest[i] = reduceFn(off, dest[i]);
+        }
+    });
+    return offsets[nchunks];
+}
+
+}
+
+template <class Index, class OutputIt, class Value, class Reduce, class Transform>
+OutputIt parallel_inclusive_scan(Index first, Index last, OutputIt dest,
+                    Value initVal, Reduce reduceFn, Transform transformFn) {
+    std::size_t n = first < last ? last - first : 0;
+    para_details::chunked_scan(n, dest, initVal, reduceFn, [&transformFn, first] (std::size_t i) {
+        return transformFn(first + (Index)i);
+    }, false);
+    return dest + n;
+}
+
+template <class It, class OutputIt, class Transform = identity>
+OutputIt parallel_inclusive_scan_sum(It first, It last, OutputIt dest, Transform transformFn = {}) {
+    std::size_t n = last - first;
+    para_details::chunked_scan(n, dest, std::decay_t<decltype(transformFn(*first))>(), [] (auto &&x, auto &&y) {
+        return x + y;
+    }, [&transformFn, first] (std::size_t i) {
+        return transformFn(first[i]);
+    }, false);
+    return dest + n;
+}
+
+template <class Index, class OutputIt, class Value, class Reduce, class Transform>
+Value parallel_exclusive_scan(Index first, Index last, OutputIt dest,
+                    Value initVal, Reduce reduceFn, Transform transformFn) {
+    std::size_t n = first < last ? last - first : 0;
+    return para_details::chunked_scan(n, dest, initVal, reduceFn, [&transformFn, first] (std::size_t i) {
+        return transformFn(first + (Index)i);
+    }, true);
+}
+
+template <class It, class OutputIt, class Transform = identity>
+auto parallel_exclusive_scan_sum(It first, It last, OutputIt dest, Transform transformFn = {}) {
+    std::size_t n = last - first;
+    return para_details::chunked_scan(n, dest, std::decay_t<decltype(transformFn(*first))>(), [] (auto &&x, auto &&y) {
+        return x + y;
+    }, [&transformFn, first] (std::size_t i) {
+        return transformFn(first[i]);
+    }, true);
+}
+
+#endif
+
 }
@@ -3,12 +3,45 @@
 #include <zeno/para/execution.h>
 #include <zeno/para/counter_iterator.h>
 #include <algorithm>
+#include <vector>
 
 namespace zeno {
 
+#ifdef ZENO_PARALLEL_STL
+
 template <class It, class Func>
 void parallel_sort(It first, It last, Func func) {
     std::sort(ZENO_PAR_UNSEQ first, last, func);
 }
 
+#else
+
+// sort fixed-size runs concurrently, then merge neighbouring runs pairwise
+template <class It, class Func>
+void parallel_sort(It first, It last, Func func, std::size_t grain = 0) {
+    std::size_t n = last - first;
+    if (!grain) grain = std::max<std::size_t>(4096, para_details::default_grain(n));
+    if (!para_details::use_pool || n <= grain || thread_pool::concurrency() <= 1) {
+        std::sort(first, last, func);
+        return;
+    }
+    parallel_for_chunks(std::size_t{}, n, grain, [&] (std::size_t, std::size_t b, std::size_t e) {
+        std::sort(first + b, first + e, func);
+    });
+    for (std::size_t width = grain; width < n; width *= 2) {
+        std::size_t npairs = (n + 2 * width - 1) / (2 * width);
+        parallel_for_range(std::size_t{}, npairs, [&] (std::size_t pb, std::size_t pe) {
+            for (std::size_t p = pb; p != pe; ++p) {
+                std::size_t b = p * 2 * width;
+                std::size_t m = std::min(b + width, n);
+                std::size_t e = std::min(b + 2 * width, n);
+                if (m < e)
+                    std::inplace_merge(first + b, first + m, first + e, func);
+            }
+        }, 1);
+    }
+}
+
+#endif
+
 }
@@ -19,9 +19,22 @@ struct task_group {
     }
 
     void run() {
+#ifdef ZENO_PARALLEL_STL
         std::for_each(ZENO_PAR m_tasks.begin(), m_tasks.end(), [&] (auto &&f) {
             std::move(f)();
         });
+#elif defined(ZENO_PARALLEL_POOL)
+        fork_join fj;
+        fj.run_and_join([&] {
+            for (auto &f: m_tasks) {
+                fj.fork([&f] { std::move(f)(); });
+            }
+        });
+#else
+        std::for_each(m_tasks.begin(), m_tasks.end(), [&] (auto &&f) {
+            std::move(f)();
+        });
+#endif
     }
 };
 
@@ -1,6 +1,6 @@
 #pragma once
 
-#ifdef ZENO_PARALLEL_STL
+#if defined(ZENO_PARALLEL_STL) || defined(ZENO_PARALLEL_POOL)
 
 #include <zeno/para/execution.h>
 #include <thread>
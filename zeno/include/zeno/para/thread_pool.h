@@ -0,0 +1,149 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace zeno {
+
+// built-in work-stealing backend, used by zeno/para with ZENO_PARALLEL_POOL
+struct thread_pool {
+    // number of threads that may run tasks, including the calling one
+    // (ZENO_NUM_THREADS overrides std::thread::hardware_concurrency)
+    ZENO_API static std::size_t concurrency();
+
+    // push to the current worker's deque (or the shared queue when called from outside),
+    // group is the counter of the fork_join the task belongs to
+    ZENO_API static void spawn(std::function<void()> task, std::atomic<std::size_t> const *group = nullptr);
+
+    // decrement counter, waking up threads waiting for it when it drops to zero
+    ZENO_API static void finish(std::atomic<std::size_t> &counter);
+
+    // help with the tasks spawned for counter until it drops to zero, then block;
+    // other tasks are never run here, so the caller may hold locks
+    ZENO_API static void wait(std::atomic<std::size_t> &counter);
+};
+
+struct fork_join {
+private:
+    std::atomic<std::size_t> m_pending{0};
+    std::exception_ptr m_eptr;
+    std::mutex m_eptr_mtx;
+
+    void set_exception(std::exception_ptr eptr) {
+        std::lock_guard lck(m_eptr_mtx);
+        if (!m_eptr)
+            m_eptr = std::move(eptr);
+    }
+
+public:
+    fork_join() = default;
+    fork_join(fork_join const &) = delete;
+    fork_join &operator=(fork_join const &) = delete;
+
+    ~fork_join() {
+        thread_pool::wait(m_pending);
+    }
+
+    template <class Func>
+    void fork(Func func) {
+        ++m_pending;
+        thread_pool::spawn([this, func = std::move(func)] () mutable {
+            try {
+                func();
+            } catch (...) {
+                set_exception(std::current_exception());
+            }
+            thread_pool::finish(m_pending);
+        }, &m_pending);
+    }
+
+    // run func on the calling thread, then wait for everything forked so far
+    template <class Func>
+    void run_and_join(Func &&func) {
+        try {
+            std::forward<Func>(func)();
+        } catch (...) {
+            set_exception(std::current_exception());
+        }
+        join();
+    }
+
+    void join() {
+        thread_pool::wait(m_pending);
+        if (m_eptr) {
+            auto eptr = std::move(m_eptr);
+            m_eptr = nullptr;
+            std::rethrow_exception(eptr);
+        }
+    }
+};
+
+namespace para_details {
+
+// zeno/para spreads work over the pool with ZENO_PARALLEL_POOL (the default),
+// building with it OFF makes parallel_for & co. serial; the graph scheduler
+// uses the pool either way
+#ifdef ZENO_PARALLEL_POOL
+inline constexpr bool use_pool = true;
+#else
+inline constexpr bool use_pool = false;
+#endif
+
+// reductions and scans always cut the range into the same chunks regardless
+// of the number of threads, so that results are bitwise reproducible
+inline constexpr std::size_t deterministic_chunks = 256;
+
+inline std::size_t default_grain(std::size_t n) {
+    return std::max<std::size_t>(1, n / (thread_pool::concurrency() * 8));
+}
+
+inline std::size_t deterministic_grain(std::size_t n, std::size_t grain) {
+    if (grain) return grain;
+    return std::max<std::size_t>(1024, (n + deterministic_chunks - 1) / deterministic_chunks);
+}
+
+}
+
+// func(b, e) is called on disjoint sub-ranges no smaller than grain (0 for auto)
+template <class Index, class Func>
+void parallel_for_range(Index first, Index last, Func func, std::size_t grain = 0) {
+    if (!(first < last)) return;
+    std::size_t n = last - first;
+    if (!grain) grain = para_details::default_grain(n);
+    if (!para_details::use_pool || n <= grain || thread_pool::concurrency() <= 1) {
+        func(first, last);
+        return;
+    }
+    fork_join fj;
+    auto split = [&] (auto &self, Index b, Index e) -> void {
+        // halve repeatedly, so that thieves always grab the biggest pieces
+        while ((std::size_t)(e - b) > grain) {
+            Index mid = b + (Index)((e - b) / 2);
+            fj.fork([&self, mid, e] { self(self, mid, e); });
+            e = mid;
+        }
+        func(b, e);
+    };
+    fj.run_and_join([&] { split(split, first, last); });
+}
+
+// func(chunkid, b, e) over fixed chunks of grain elements, chunkid in [0, nchunks)
+template <class Index, class Func>
+void parallel_for_chunks(Index first, Index last, std::size_t grain, Func func) {
+    if (!(first < last)) return;
+    std::size_t n = last - first;
+    std::size_t nchunks = (n + grain - 1) / grain;
+    parallel_for_range((std::size_t)0, nchunks, [&] (std::size_t cb, std::size_t ce) {
+        for (std::size_t c = cb; c != ce; ++c) {
+            Index b = first + (Index)(c * grain);
+            Index e = c + 1 == nchunks ? last : first + (Index)((c + 1) * grain);
+            func(c, b, e);
+        }
+    }, 1);
+}
+
+}
@@ -3,8 +3,14 @@
 #include <zeno/utils/vec.h>
 #include <zeno/utils/Error.h>
 #include <zeno/utils/type_traits.h>
+#include <zeno/utils/AttrKey.h>
+#include <algorithm>
+#include <iterator>
 #include <variant>
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
 #include <map>
 
 namespace zeno {
@@ -51,8 +57,349 @@ struct AttrVector {
 
     inline static const std::string kpos = "pos"; 
 
+    // attribute arrays, shared copy-on-write between copies of an AttrVector.
+    // an array is flagged once this vector hands out a mutable reference to
+    // it (non-const attr, find, operator[] or iteration):
+    //  - the first mutable lookup of an array still shared with another copy
+    //    duplicates it for this vector, under a lock so that lookups from
+    //    parallel loops are safe; the array is never swapped again until the
+    //    next seal(), so references handed out in between stay valid
+    //  - copying shares the unflagged arrays and duplicates the flagged ones,
+    //    which may still be written through references handed out earlier
+    //  - seal() clears the flags, the caller promises no mutable reference into
+    //    the arrays is alive anymore; the graph seals node outputs after apply
+    // const lookups never duplicate anything, non-const iteration does hand out
+    // mutable references and so unshares every array it visits: walk a const
+    // AttrMap or peek_all() to only read. changing the set of arrays (assign,
+    // erase, clear, resize) is not synchronised, same as std::map.
+    struct AttrMap {
+        using value_type = std::pair<const std::string, AttrVectorVariant>;
+
+    private:
+        struct Slot {
+            std::shared_ptr<value_type> owner;
+            // owner.get(), for lookups racing the first mutable lookup
+            std::atomic<value_type *> ptr{nullptr};
+            std::atomic<bool> mut{false};
+
+            void reset(std::shared_ptr<value_type> p, bool m) {
+                ptr.store(p.get(), std::memory_order_relaxed);
+                owner = std::move(p);
+                mut.store(m, std::memory_order_relaxed);
+            }
+
+            value_type &get() const {
+                return *ptr.load(std::memory_order_acquire);
+            }
+        };
+
+        using map_type = std::map<std::string, Slot>;
+        map_type m_map;
+        // the slots of m_map sorted by interned name, serves AttrKey lookups
+        // with integer compares only; updated whenever m_map changes shape
+        std::vector<std::pair<uint32_t, Slot *>> m_index;
+        // arrays swapped out by _own, kept until seal() for const lookups
+        // that may still be reading them
+        std::vector<std::shared_ptr<value_type>> m_retired;
+        std::mutex m_mtx;
+
+        Slot &_insert(std::string const &key) {
+            auto [it, fresh] = m_map.try_emplace(key);
+            if (fresh) {
+                uint32_t id = AttrKey::intern(key);
+                auto pos = std::lower_bound(m_index.begin(), m_index.end(), id, [] (auto const &e, uint32_t id) {
+                    return e.first < id;
+                });
+                m_index.emplace(pos, id, &it->second);
+            }
+            return it->second;
+        }
+
+        Slot *_lookup(AttrKey key) const {
+            auto it = std::lower_bound(m_index.begin(), m_index.end(), key.id, [] (auto const &e, uint32_t id) {
+                return e.first < id;
+            });
+            return it != m_index.end() && it->first == key.id ? it->second : nullptr;
+        }
+
+        value_type &_own(Slot &s) {
+            if (s.mut.load(std::memory_order_acquire))
+                return *s.ptr.load(std::memory_order_relaxed);
+            std::lock_guard lck(m_mtx);
+            if (!s.mut.load(std::memory_order_relaxed)) {
+                if (s.owner.use_count() > 1) {
+                    auto p = std::make_shared<value_type>(*s.owner);
+                    s.ptr.store(p.get(), std::memory_order_release);
+                    m_retired.push_back(std::exchange(s.owner, std::move(p)));
+                } else {
+                    // the other copy may have just released it after reading
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                }
+                s.mut.store(true, std::memory_order_release);
+            }
+            return *s.ptr.load(std::memory_order_relaxed);
+        }
+
+        void _copy(AttrMap const &that) {
+            for (auto const &[key, s]: that.m_map) {
+                auto &d = _insert(key);
+                if (s.mut.load(std::memory_order_relaxed))
+                    d.reset(std::make_shared<value_type>(s.get()), false);
+                else
+                    d.reset(s.owner, false);
+            }
+        }
+
+    public:
+        AttrMap() = default;
+
+        AttrMap(AttrMap const &that) {
+            _copy(that);
+        }
+
+        AttrMap(AttrMap &&that) noexcept
+            : m_map(std::move(that.m_map)), m_index(std::move(that.m_index)), m_retired(std::move(that.m_retired)) {
+            that.m_map.clear();
+            that.m_index.clear();
+        }
+
+        AttrMap &operator=(AttrMap const &that) {
+            if (this != &that) {
+                clear();
+                _copy(that);
+            }
+            return *this;
+        }
+
+        AttrMap &operator=(AttrMap &&that) noexcept {
+            if (this != &that) {
+                m_map = std::move(that.m_map);
+                m_index = std::move(that.m_index);
+                m_retired = std::move(that.m_retired);
+                that.m_map.clear();
+                that.m_index.clear();
+            }
+            return *this;
+        }
+
+        template <bool Const>
+        struct Iterator {
+            using base_type = std::conditional_t<Const, typename map_type::const_iterator, typename map_type::iterator>;
+            using map_pointer = std::conditional_t<Const, AttrMap const *, AttrMap *>;
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = AttrMap::value_type;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, value_type const &, value_type &>;
+            using pointer = std::conditional_t<Const, value_type const *, value_type *>;
+
+            map_pointer map = nullptr;
+            base_type it;
+
+            Iterator() = default;
+            Iterator(map_pointer map, base_type it) : map(map), it(it) {}
+
+            template <bool C = Const, std::enable_if_t<C, int> = 0>
+            Iterator(Iterator<false> const &that) : map(that.map), it(that.it) {}
+
+            reference operator*() const {
+                if constexpr (Const)
+                    return it->second.get();
+                else
+                    return map->_own(it->second);
+            }
+
+            pointer operator->() const {
+                return &**this;
+            }
+
+            Iterator &operator++() {
+                ++it;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto old = *this;
+                ++it;
+                return old;
+            }
+
+            Iterator &operator--() {
+                --it;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                auto old = *this;
+                --it;
+                return old;
+            }
+
+            bool operator==(Iterator const &that) const {
+                return it == that.it;
+            }
+
+            bool operator!=(Iterator const &that) const {
+                return it != that.it;
+            }
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        iterator begin() {
+            return {this, m_map.begin()};
+        }
+
+        iterator end() {
+            return {this, m_map.end()};
+        }
+
+        const_iterator begin() const {
+            return {this, m_map.begin()};
+        }
+
+        const_iterator end() const {
+            return {this, m_map.end()};
+        }
+
+        iterator find(std::string const &key) {
+            return {this, m_map.find(key)};
+        }
+
+        const_iterator find(std::string const &key) const {
+            return {this, m_map.find(key)};
+        }
+
+        AttrVectorVariant &operator[](std::string const &key) {
+            auto &s = _insert(key);
+            if (!s.owner)
+                s.reset(std::make_shared<value_type>(key, AttrVectorVariant{}), false);
+            return _own(s).second;
+        }
+
+        // replace an array without copying the old one
+        void assign(std::string const &key, AttrVectorVariant &&val) {
+            _insert(key).reset(std::make_shared<value_type>(key, std::move(val)), false);
+        }
+
+        size_t erase(std::string const &key) {
+            auto it = m_map.find(key);
+            if (it == m_map.end())
+                return 0;
+            auto slot = &it->second;
+            m_index.erase(std::find_if(m_index.begin(), m_index.end(), [&] (auto const &e) {
+                return e.second == slot;
+            }));
+            m_map.erase(it);
+            return 1;
+        }
+
+        void clear() {
+            m_map.clear();
+            m_index.clear();
+            m_retired.clear();
+        }
+
+        size_t size() const {
+            return m_map.size();
+        }
+
+        bool empty() const {
+            return m_map.empty();
+        }
+
+        size_t count(std::string const &key) const {
+            return m_map.count(key);
+        }
+
+        // no mutable reference into the arrays is alive anymore, later copies
+        // may share all of them again
+        void seal() {
+            for (auto &[key, s]: m_map)
+                s.mut.store(false, std::memory_order_relaxed);
+            m_retired.clear();
+        }
+
+        // read-only lookup, never duplicates an array
+        AttrVectorVariant const *peek(std::string const &key) const {
+            auto it = m_map.find(key);
+            return it != m_map.end() ? &it->second.get().second : nullptr;
+        }
+
+        AttrVectorVariant const *peek(AttrKey key) const {
+            auto s = _lookup(key);
+            return s ? &s->get().second : nullptr;
+        }
+
+        // lookup for write access, see _own
+        AttrVectorVariant *get(AttrKey key) {
+            auto s = _lookup(key);
+            return s ? &_own(*s).second : nullptr;
+        }
+
+        // read-only view of all arrays in key order, never duplicates an array
+        auto peek_all() const {
+            std::vector<std::pair<std::string const *, AttrVectorVariant const *>> res;
+            res.reserve(m_map.size());
+            for (auto const &[key, s]: m_map)
+                res.emplace_back(&key, &s.get().second);
+            return res;
+        }
+
+        // arrays already of size n are left alone, a shared array is replaced by
+        // a resized copy instead of being duplicated first
+        void resize_all(size_t n) {
+            for (auto &[key, s]: m_map) {
+                std::visit([&, &key = key, &s = s] (auto const &arr) {
+                    if (arr.size() == n)
+                        return;
+                    using V = std::decay_t<decltype(arr)>;
+                    if (s.mut.load(std::memory_order_relaxed) || s.owner.use_count() == 1) {
+                        std::get<V>(s.owner->second).resize(n);
+                        return;
+                    }
+                    V res;
+                    res.reserve(n);
+                    res.assign(arr.begin(), arr.begin() + std::min(n, arr.size()));
+                    res.resize(n);
+                    s.reset(std::make_shared<value_type>(key, std::move(res)), false);
+                }, s.owner->second);
+            }
+        }
+
+        // capacity hints, shared arrays are not duplicated for them
+        void reserve_all(size_t n) {
+            for (auto &[key, s]: m_map) {
+                if (s.mut.load(std::memory_order_relaxed) || s.owner.use_count() == 1)
+                    std::visit([&] (auto &arr) { arr.reserve(n); }, s.owner->second);
+            }
+        }
+
+        void shrink_all() {
+            for (auto &[key, s]: m_map) {
+                if (s.mut.load(std::memory_order_relaxed) || s.owner.use_count() == 1)
+                    std::visit([&] (auto &arr) { arr.shrink_to_fit(); }, s.owner->second);
+            }
+        }
+
+        void clear_all() {
+            for (auto &[key, s]: m_map) {
+                if (s.mut.load(std::memory_order_relaxed) || s.owner.use_count() == 1) {
+                    std::visit([&] (auto &arr) { arr.clear(); }, s.owner->second);
+                } else {
+                    s.reset(std::make_shared<value_type>(key, std::visit([] (auto const &arr) -> AttrVectorVariant {
+                        return std::decay_t<decltype(arr)>();
+                    }, s.owner->second)), false);
+                }
+            }
+        }
+    };
+
+    // the base array (pos, or the topology indices) is a plain std::vector
+    // exposed by reference everywhere, it is deep-copied with the AttrVector;
+    // only the arrays in attrs are shared copy-on-write
     BaseVector values;
-    std::map<std::string, AttrVectorVariant> attrs;
+    AttrMap attrs;
 
     AttrVector() = default;
     AttrVector(std::vector<ValT> const &values_) : values(values_) {}
@@ -106,9 +453,7 @@ struct AttrVector {
     //}
 
     void update() {
-        for (auto &[key, val] : attrs) {
-            std::visit([&](auto &val) { val.resize(this->size()); }, val);
-        }
+        attrs.resize_all(size());
     }
 
     decltype(auto) operator[](size_t idx) const {
@@ -141,15 +486,15 @@ struct AttrVector {
             f(values);
             return;
         }
-        auto it = attrs.find(name);
-        if (it == attrs.end())
+        auto arr = attrs.peek(name);
+        if (!arr)
             throw makeError<KeyError>(name, "attribute name of primitive");
         std::visit([&] (auto &arr) {
             using T = std::decay_t<decltype(arr[0])>;
             if constexpr (variant_contains<T, Accept>::value) {
                 f(arr);
             }
-        }, it->second);
+        }, *arr);
     }
 
     template <class Accept = std::variant<vec3f, float>, class F>
@@ -173,14 +518,14 @@ struct AttrVector {
 
     template <class Accept = std::variant<vec3f, float>, class F>
     void foreach_attr(F &&f) const {
-        for (auto const &[key, arr]: attrs) {
-            auto const &k = key;
+        for (auto const &[key, arr]: attrs.peek_all()) {
+            auto const &k = *key;
             std::visit([&] (auto &arr) {
                 using T = std::decay_t<decltype(arr[0])>;
                 if constexpr (variant_contains<T, Accept>::value) {
                     f(k, arr);
                 }
-            }, arr);
+            }, *arr);
         }
     }
 
@@ -200,14 +545,14 @@ struct AttrVector {
     template <class Accept = std::variant<vec3f, float>, class F>
     void forall_attr(F &&f) const {
         f(kpos, values);
-        for (auto const &[key, arr]: attrs) {
-            auto const &k = key;
+        for (auto const &[key, arr]: attrs.peek_all()) {
+            auto const &k = *key;
             std::visit([&] (auto &arr) {
                 using T = std::decay_t<decltype(arr[0])>;
                 if constexpr (variant_contains<T, Accept>::value) {
                     f(k, arr);
                 }
-            }, arr);
+            }, *arr);
         }
     }
 
@@ -304,14 +649,13 @@ struct AttrVector {
         // base
         dim += type_dim<value_type>();
         // attr
-        for (auto& [key, arr] : attrs) {
-            auto const& k = key;
+        for (auto& [key, arr] : attrs.peek_all()) {
             std::visit([&](auto& arr) {
                 using T = std::decay_t<decltype(arr[0])>;
                 if constexpr (variant_contains<T, AttrAcceptAll>::value) {
                     dim += type_dim<T>();
                 }
-            }, arr);
+            }, *arr);
         }
         return dim;
     }
@@ -328,8 +672,7 @@ struct AttrVector {
         attrIndex++;
         // attr
         // attr is std::map, it's sorted, so here attrIndex++ is right.
-        for (auto& [key, arr] : attrs) {
-            auto const& k = key;
+        for (auto& [key, arr] : attrs.peek_all()) {
             std::visit([&](auto& arr) {
                 using T = std::decay_t<decltype(arr[0])>;
                 if constexpr (variant_contains<T, AttrAcceptAll>::value) {
@@ -339,7 +682,7 @@ struct AttrVector {
                     }
                     dim += current_dim;
                 }
-            }, arr);
+            }, *arr);
             if (index < dim) {
                 break;
             }
@@ -378,7 +721,7 @@ struct AttrVector {
     template <class T>
     auto &add_attr(std::string const &name) {
         if (!attr_is<T>(name))
-            attrs[name] = std::vector<T>(size());
+            attrs.assign(name, std::vector<T>(size()));
         return attr<T>(name);
     }
 
@@ -386,7 +729,7 @@ struct AttrVector {
     template <class T>
     auto &add_attr(std::string const &name, T const &val) {
         if (!attr_is<T>(name))
-            attrs[name] = std::vector<T>(size(), val);
+            attrs.assign(name, std::vector<T>(size(), val));
         return attr<T>(name);
     }
 
@@ -437,10 +780,10 @@ struct AttrVector {
         //attr<vec3f>("clr").emplace_back(val)
         //attr<vec3f>("pos").emplace_back(val)<---this will resize "clr" to zero first and then push_back to "pos"
         //_ensure_update();
-        auto it = attrs.find(name);
-        if (it == attrs.end())
+        auto arr = attrs.peek(name);
+        if (!arr)
             throw makeError<KeyError>(name, "attribute name of primitive");
-        return it->second;
+        return *arr;
     }
 
     // deprecated:
@@ -452,9 +795,118 @@ struct AttrVector {
         return it->second;
     }
 
+    // lookups by interned key, resolve the key once outside the loops
+    template <class T>
+    auto const &attr(AttrKey key) const {
+        if (key.is_pos()) {
+            if constexpr (!std::is_same_v<T, ValT>) {
+                throw makeError<TypeError>(typeid(T), typeid(ValT), "type of primitive attribute pos");
+            } else {
+                return values;
+            }
+        }
+        auto arr = attrs.peek(key);
+        if (!arr)
+            throw makeError<KeyError>(key.name(), "attribute name of primitive");
+        if (!std::holds_alternative<std::vector<T>>(*arr))
+            throw makeError<TypeError>(typeid(T), std::visit([&] (auto const &t) -> std::type_info const & { return typeid(std::decay_t<decltype(t[0])>); }, *arr), "type of primitive attribute " + key.name());
+        return std::get<std::vector<T>>(*arr);
+    }
+
+    template <class T>
+    auto &attr(AttrKey key) {
+        if (key.is_pos()) {
+            if constexpr (!std::is_same_v<T, ValT>) {
+                throw makeError<TypeError>(typeid(T), typeid(ValT), "type of primitive attribute pos");
+            } else {
+                return values;
+            }
+        }
+        auto arr = attrs.get(key);
+        if (!arr)
+            throw makeError<KeyError>(key.name(), "attribute name of primitive");
+        if (!std::holds_alternative<std::vector<T>>(*arr))
+            throw makeError<TypeError>(typeid(T), std::visit([&] (auto const &t) -> std::type_info const & { return typeid(std::decay_t<decltype(t[0])>); }, *arr), "type of primitive attribute " + key.name());
+        return std::get<std::vector<T>>(*arr);
+    }
+
+    template <class T>
+    auto const &attr(AttrHandle<T> key) const {
+        return attr<T>(AttrKey(key));
+    }
+
+    template <class T>
+    auto &attr(AttrHandle<T> key) {
+        return attr<T>(AttrKey(key));
+    }
+
+    template <class T>
+    auto &add_attr(AttrKey key) {
+        if (!attr_is<T>(key))
+            attrs.assign(key.name(), std::vector<T>(size()));
+        return attr<T>(key);
+    }
+
+    template <class T>
+    auto &add_attr(AttrHandle<T> key) {
+        return add_attr<T>(AttrKey(key));
+    }
+
+    template <class Accept = std::variant<vec3f, float>, class F>
+    void attr_visit(AttrKey key, F const &f) const {
+        if (key.is_pos()) {
+            f(values);
+            return;
+        }
+        auto arr = attrs.peek(key);
+        if (!arr)
+            throw makeError<KeyError>(key.name(), "attribute name of primitive");
+        std::visit([&] (auto &arr) {
+            using T = std::decay_t<decltype(arr[0])>;
+            if constexpr (variant_contains<T, Accept>::value) {
+                f(arr);
+            }
+        }, *arr);
+    }
+
+    template <class Accept = std::variant<vec3f, float>, class F>
+    void attr_visit(AttrKey key, F const &f) {
+        if constexpr (variant_contains<ValT, Accept>::value) {
+            if (key.is_pos()) {
+                f(values);
+                return;
+            }
+        }
+        auto arr = attrs.get(key);
+        if (!arr)
+            throw makeError<KeyError>(key.name(), "attribute name of primitive");
+        std::visit([&] (auto &arr) {
+            using T = std::decay_t<decltype(arr[0])>;
+            if constexpr (variant_contains<T, Accept>::value) {
+                f(arr);
+            }
+        }, *arr);
+    }
+
+    bool has_attr(AttrKey key) const {
+        return key.is_pos() || attrs.peek(key);
+    }
+
+    template <class T>
+    bool attr_is(AttrKey key) const {
+        if (key.is_pos()) return std::is_same_v<T, ValT>;
+        auto arr = attrs.peek(key);
+        return arr && std::holds_alternative<std::vector<T>>(*arr);
+    }
+
+    void erase_attr(AttrKey key) {
+        if (!key.is_pos())
+            attrs.erase(key.name());
+    }
+
     bool has_attr(std::string const &name) const {
         if (name == "pos") return true;
-        return attrs.find(name) != attrs.end();
+        return attrs.count(name) != 0;
     }
 
     void erase_attr(std::string const &name) {
@@ -464,8 +916,8 @@ struct AttrVector {
     template <class T>
     bool attr_is(std::string const &name) const {
         if (name == "pos") return std::is_same_v<T, ValT>;
-        auto it = attrs.find(name);
-        return it != attrs.end() && std::holds_alternative<std::vector<T>>(it->second);
+        auto arr = attrs.peek(name);
+        return arr && std::holds_alternative<std::vector<T>>(*arr);
     }
 
     void clear_attrs() {
@@ -478,30 +930,27 @@ struct AttrVector {
 
     void reserve(size_t size) {
         values.reserve(size);
-        for (auto &[key, val] : attrs) {
-            std::visit([&](auto &val) { val.reserve(size); }, val);
-        }
+        attrs.reserve_all(size);
     }
 
     void shrink_to_fit() {
         values.shrink_to_fit();
-        for (auto &[key, val] : attrs) {
-            std::visit([&](auto &val) { val.shrink_to_fit(); }, val);
-        }
+        attrs.shrink_all();
     }
 
     void resize(size_t size) {
         values.resize(size);
-        for (auto &[key, val] : attrs) {
-            std::visit([&](auto &val) { val.resize(size); }, val);
-        }
+        attrs.resize_all(size);
     }
 
     void clear() {
         values.clear();
-        for (auto &[key, val] : attrs) {
-            std::visit([&](auto &val) { val.clear(); }, val);
-        }
+        attrs.clear_all();
+    }
+
+    // see AttrMap::seal
+    void seal() {
+        attrs.seal();
     }
 };
 
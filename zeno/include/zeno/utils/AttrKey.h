@@ -0,0 +1,59 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace zeno {
+
+// interned attribute name: a process-wide symbol table maps each distinct
+// name to a small integer, so that keys compare and look up as integers.
+// resolve it once (e.g. as a static) and pass it to attr<T>() in hot code
+struct AttrKey {
+    uint32_t id = 0;
+
+    AttrKey() = default;
+
+    explicit AttrKey(std::string_view name) : id(intern(name)) {}
+
+    std::string const &name() const {
+        return name_of(id);
+    }
+
+    bool is_pos() const {
+        return id == 0;
+    }
+
+    bool operator==(AttrKey const &that) const {
+        return id == that.id;
+    }
+
+    bool operator!=(AttrKey const &that) const {
+        return id != that.id;
+    }
+
+    bool operator<(AttrKey const &that) const {
+        return id < that.id;
+    }
+
+    // "pos" is always interned as id 0
+    ZENO_API static uint32_t intern(std::string_view name);
+    ZENO_API static std::string const &name_of(uint32_t id);
+};
+
+// an AttrKey that also fixes the element type, e.g.
+//   static const AttrHandle<float> kDen("den");
+//   auto &den = prim->verts.attr(kDen);
+template <class T>
+struct AttrHandle : AttrKey {
+    using value_type = T;
+
+    AttrHandle() = default;
+
+    explicit AttrHandle(std::string_view name) : AttrKey(name) {}
+
+    explicit AttrHandle(AttrKey key) : AttrKey(key) {}
+};
+
+}
@@ -11,6 +11,7 @@
 #include <utility>
 #include <zeno/PrimitiveObject.h>
 #include <zeno/core/Descriptor.h>
+#include <zeno/core/defNode.h>
 #include <zeno/types/AttrVector.h>
 #include <zeno/types/UserData.h>
 #include <zeno/types/CurveObject.h>
@@ -497,7 +498,7 @@ namespace zeno {
             zeno::getSession().defNodeClass([]() -> std::unique_ptr<INode> {   \
                 return std::make_unique<CLS>();                                \
             },                                                                 \
-                                            #CLS, ParamType::GetDescriptor()); \
+                                            #CLS, ::zeno::describeNodeClass<CLS>(ParamType::GetDescriptor())); \
         }                                                                      \
     } AutoStaticRegisterInstance_Do_not_use;
 
@@ -523,7 +524,7 @@ namespace zeno {
             zeno::getSession().defNodeClass([]() -> std::unique_ptr<INode> {   \
                 return std::make_unique<CLS>();                                \
             },                                                                 \
-                                            #CLS, ParamType::GetDescriptor()); \
+                                            #CLS, ::zeno::describeNodeClass<CLS>(ParamType::GetDescriptor())); \
         }                                                                      \
     } AutoStaticRegisterInstance_Do_not_use;
 
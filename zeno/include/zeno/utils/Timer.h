@@ -3,6 +3,7 @@
 #include <chrono>
 #include <string>
 #include <vector>
+#include <mutex>
 #include <cassert>
 
 namespace zeno {
@@ -20,8 +21,9 @@ public:
     };
 
 private:
-    static Timer *current;
+    static thread_local Timer *current;
     static std::vector<Record> records;
+    static std::mutex records_mtx;
 
     Timer *parent = nullptr;
     ClockType::time_point beg;
@@ -35,7 +37,10 @@ public:
     Timer(std::string_view tag_) : Timer(std::move(tag_), ClockType::now()) {}
     ~Timer() { _destroy(ClockType::now()); }
 
-    static auto const &getRecords() { return records; }
+    static std::vector<Record> getRecords() {
+        std::lock_guard lck(records_mtx);
+        return records;
+    }
     static std::string getLog();
 };
 
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <cstddef>
+#include <string>
+
+namespace zeno {
+
+// read-only memory mapping of a whole file, pages are loaded on first access
+// and belong to the page cache instead of the process heap
+struct mapped_file {
+private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    void close();
+
+public:
+    mapped_file() = default;
+    ZENO_API explicit mapped_file(std::string const &path);
+    ZENO_API ~mapped_file();
+
+    mapped_file(mapped_file const &) = delete;
+    mapped_file &operator=(mapped_file const &) = delete;
+
+    bool is_open() const {
+        return m_data != nullptr;
+    }
+
+    explicit operator bool() const {
+        return is_open();
+    }
+
+    const char *data() const {
+        return m_data;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <zeno/utils/api.h>
+#include <zeno/utils/vec.h>
+#include <vector>
+
+namespace zeno {
+
+// ear clipping triangulation of (roughly planar) polygons, which are projected
+// onto the plane of their Newell normal. candidate ears are only tested against
+// the reflex vertices found through a uniform grid, so big n-gons stay near
+// linear. the scratch buffers are kept between calls, use one per thread
+struct PolygonTriangulator {
+    // triangulate the loop pos[loop[0]], ..., pos[loop[n - 1]] into exactly
+    // n - 2 triangles, written to out as corner indices 0 .. n - 1 of the loop.
+    // convex loops give the same fan as before, degenerate loops (collinear or
+    // repeated points, self intersections) still give n - 2 triangles
+    ZENO_API void triangulate(vec3f const *pos, int const *loop, int n, vec3i *out);
+
+    // triangulate an outer loop with holes, bridging each hole into the outer
+    // loop first; appends triangles of vertex indices to out. winding of the
+    // holes does not matter, holes outside of the outer loop are ignored
+    ZENO_API void triangulate(vec3f const *pos, std::vector<int> const &outer,
+                              std::vector<std::vector<int>> const &holes, std::vector<vec3i> &out);
+
+private:
+    struct Node {
+        double x, y;
+        int idx;
+        int prev, next;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<char> m_removed;
+    std::vector<int> m_cellStart;
+    std::vector<int> m_cellNodes;
+    std::vector<int> m_cellCursor;
+    struct Candidate {
+        double key;
+        int node;
+        int stamp;
+    };
+    std::vector<Candidate> m_heap;
+    std::vector<int> m_stamp;
+    double m_gridX = 0, m_gridY = 0, m_gridInvDx = 0;
+    int m_gridNx = 0, m_gridNy = 0;
+
+    void project(vec3f const *pos, int const *loop, int n, int &u, int &v, bool &flip) const;
+    int addLoop(vec3f const *pos, int const *loop, int n, int u, int v, bool flip, bool cornerIdx, bool ccw);
+    int findHoleBridge(int hole, int outer) const;
+    int splitPolygon(int a, int b);
+    bool locallyInside(int a, int b) const;
+    void buildGrid();
+    bool isEar(int ear) const;
+    template <class Emit>
+    void earClip(int start, int remaining, Emit const &emit);
+};
+
+// triangulate the polygon verts[poly[0]], ..., verts[poly[n - 1]] by ear clipping,
+// triangles are written as vertex indices
+ZENO_API void polygonDecompose(std::vector<vec3f> &verts, std::vector<int> &poly,
+                               std::vector<vec3i> &triangles);
+
+}
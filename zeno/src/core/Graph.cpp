@@ -7,14 +7,20 @@
 #include <zeno/core/Descriptor.h>
 #include <zeno/types/NumericObject.h>
 #include <zeno/types/StringObject.h>
+#include <zeno/types/ListObject.h>
 #include <zeno/extra/GraphException.h>
 #include <zeno/funcs/LiterialConverter.h>
 #include <zeno/extra/GlobalStatus.h>
 #include <zeno/extra/SubnetNode.h>
 #include <zeno/extra/DirtyChecker.h>
+#include <zeno/extra/GlobalProfiler.h>
 #include <zeno/utils/Error.h>
+#include <zeno/utils/envconfig.h>
 #include <zeno/utils/log.h>
+#include <zeno/para/thread_pool.h>
 #include <iostream>
+#include <atomic>
+#include <mutex>
 
 namespace zeno {
 
@@ -23,6 +29,7 @@ ZENO_API Context::~Context() = default;
 
 ZENO_API Context::Context(Context const &other)
     : visited(other.visited)
+    , memoize(other.memoize)
 {}
 
 ZENO_API Graph::Graph() = default;
@@ -75,12 +82,12 @@ ZENO_API void Graph::completeNode(std::string const &id) {
 }
 
 ZENO_API bool Graph::applyNode(std::string const &id) {
-    if (ctx->visited.find(id) != ctx->visited.end()) {
+    if (!ctx->markVisited(id)) {
         return false;
     }
-    ctx->visited.insert(id);
     auto node = safe_at(nodes, id, "node name").get();
     GraphException::translated([&] {
+        GlobalProfiler::NodeScope _(session->globalProfiler.get(), node);
         node->doApply();
     }, node->myname);
     if (dirtyChecker && dirtyChecker->amIDirty(id)) {
@@ -89,6 +96,237 @@ ZENO_API bool Graph::applyNode(std::string const &id) {
     return false;
 }
 
+namespace {
+
+// nodes overriding preApply (control flow, ONCE, caches) evaluate their inputs
+// lazily, so they must stay serial; so do classes registered without going
+// through defNode.h. loop and function heads (BeginFor, FuncBegin, ...) have a
+// plain apply but are driven by their partner node, and PortalOut reaches
+// other nodes behind the graph's back
+bool isSerialPoint(INode *node) {
+    if (!node->nodeClass || !node->nodeClass->desc)
+        return true;
+    auto desc = node->nodeClass->desc.get();
+    if (!desc->hasNodeTraits || desc->lazyInputs)
+        return true;
+    for (auto const &cate: desc->categories) {
+        if (cate == "control" || cate == "lifecycle")
+            return true;
+    }
+    auto &classes = node->graph->session->nodeClasses;
+    if (auto it = classes.find("PortalOut"); it != classes.end() && it->second.get() == node->nodeClass)
+        return true;
+    return false;
+}
+
+// nodes may modify their input objects in place and pass them on as outputs,
+// so which object a node is going to touch is only known once its producers
+// have been applied. every object keeps the nodes that will receive it, ordered
+// by when the serial evaluator would apply them, and only the first of them
+// may run: nodes sharing an object (directly, through a list or passed along
+// in place) keep the serial order. when the first is a node that does not run
+// here, the rest are left to the serial evaluation that follows
+struct ParallelScheduler {
+    Graph *graph;
+
+    std::map<INode *, int> rank;  // position in the serial evaluation order
+    std::map<INode *, std::vector<INode *>> consumers;
+    std::map<INode *, int> pending;
+    std::vector<INode *> ready;
+
+    std::mutex mtx;
+    std::map<IObject *, std::set<std::pair<int, INode *>>> receivers;
+    std::map<INode *, std::vector<IObject *>> received;
+    std::vector<INode *> blocked;
+
+    std::atomic<bool> failed{false};
+    fork_join fj;
+
+    explicit ParallelScheduler(Graph *graph) : graph(graph) {}
+
+    INode *sourceOf(std::pair<std::string, std::string> const &bound) const {
+        auto it = graph->nodes.find(bound.first);
+        return it != graph->nodes.end() ? it->second.get() : nullptr;
+    }
+
+    bool isTainted(INode *node, std::map<INode *, bool> &tainted) const {
+        if (auto it = tainted.find(node); it != tainted.end())
+            return it->second;
+        tainted[node] = false;  // break cycles, if any
+        bool res = isSerialPoint(node);
+        for (auto const &[ds, bound]: node->inputBounds) {
+            if (auto src = sourceOf(bound); src && isTainted(src, tainted))
+                res = true;
+        }
+        tainted[node] = res;
+        return res;
+    }
+
+    // same order as applyNodes and preApply walk the inputs; nodes behind lazy
+    // inputs get an approximate position, they never run here anyway
+    void rankNode(INode *node, std::set<INode *> &visiting) {
+        if (rank.count(node) || !visiting.insert(node).second)
+            return;
+        for (auto const &[ds, bound]: node->inputBounds) {
+            if (auto src = sourceOf(bound))
+                rankNode(src, visiting);
+        }
+        rank.try_emplace(node, (int)rank.size());
+    }
+
+    // only nodes that the serial evaluator would have applied anyway, and that
+    // does not depend on any serial point, are eligible for running ahead
+    void build(std::set<std::string> const &ids) {
+        std::map<INode *, bool> tainted;
+        std::set<INode *> mustRun;
+        std::vector<INode *> stack;
+        std::set<INode *> visiting;
+        for (auto const &id: ids) {
+            if (auto it = graph->nodes.find(id); it != graph->nodes.end()) {
+                stack.push_back(it->second.get());
+                rankNode(it->second.get(), visiting);
+            }
+        }
+        while (!stack.empty()) {
+            auto node = stack.back();
+            stack.pop_back();
+            if (!mustRun.insert(node).second)
+                continue;
+            if (isSerialPoint(node))
+                continue;
+            for (auto const &[ds, bound]: node->inputBounds) {
+                if (auto src = sourceOf(bound))
+                    stack.push_back(src);
+            }
+        }
+
+        for (auto node: mustRun) {
+            if (isTainted(node, tainted))
+                continue;
+            pending.try_emplace(node, 0);
+        }
+        // serial nodes are consumers too, they hold back later receivers of
+        // the objects they will get
+        for (auto const &[node, r]: rank) {
+            std::set<INode *> srcs;
+            for (auto const &[ds, bound]: node->inputBounds) {
+                if (auto src = sourceOf(bound))
+                    srcs.insert(src);
+            }
+            for (auto src: srcs) {
+                consumers[src].push_back(node);
+                if (auto it = pending.find(node); it != pending.end())
+                    it->second++;
+            }
+        }
+        for (auto const &[node, npending]: pending) {
+            if (!npending)
+                ready.push_back(node);
+        }
+    }
+
+    static void collectObject(IObject *obj, std::vector<IObject *> &objs) {
+        if (!obj)
+            return;
+        objs.push_back(obj);
+        if (auto lst = dynamic_cast<ListObject *>(obj)) {
+            for (auto const &elm: lst->arr)
+                collectObject(elm.get(), objs);
+        }
+    }
+
+    // the objects dst is going to receive from src, call with mtx held
+    void deliver(INode *src, INode *dst) {
+        std::vector<IObject *> objs;
+        for (auto const &[ds, bound]: dst->inputBounds) {
+            if (sourceOf(bound) != src)
+                continue;
+            if (src->muted_output) {
+                collectObject(src->muted_output.get(), objs);
+            } else if (auto it = src->outputs.find(bound.second); it != src->outputs.end()) {
+                collectObject(it->second.get(), objs);
+            }
+        }
+        auto &dstObjs = received[dst];
+        for (auto obj: objs) {
+            receivers[obj].emplace(rank.at(dst), dst);
+            dstObjs.push_back(obj);
+        }
+    }
+
+    // call with mtx held
+    bool isFirstReceiver(INode *node) {
+        for (auto obj: received[node]) {
+            if (receivers.at(obj).begin()->second != node)
+                return false;
+        }
+        return true;
+    }
+
+    void schedule(std::vector<INode *> const &nodes) {
+        for (auto node: nodes) {
+            fj.fork([this, node] { runNode(node); });
+        }
+    }
+
+    void runNode(INode *node) {
+        if (failed)
+            return;
+        bool dirty = false;
+        try {
+            dirty = graph->applyNode(node->myname);
+        } catch (...) {
+            failed = true;
+            throw;
+        }
+        std::vector<INode *> runnable;
+        {
+            std::lock_guard lck(mtx);
+            // hand the outputs on before letting go of the inputs, an object
+            // passed along in place stays with the consumers that come first
+            auto it = consumers.find(node);
+            if (it != consumers.end()) {
+                for (auto dst: it->second) {
+                    deliver(node, dst);
+                    if (dirty)
+                        graph->getDirtyChecker().taintThisNode(dst->myname);
+                    if (auto pit = pending.find(dst); pit != pending.end() && !--pit->second)
+                        blocked.push_back(dst);
+                }
+            }
+            for (auto obj: received[node]) {
+                auto &rs = receivers.at(obj);
+                rs.erase({rank.at(node), node});
+                if (rs.empty())
+                    receivers.erase(obj);
+            }
+            received.erase(node);
+            for (auto bit = blocked.begin(); bit != blocked.end();) {
+                if (isFirstReceiver(*bit)) {
+                    runnable.push_back(*bit);
+                    bit = blocked.erase(bit);
+                } else {
+                    ++bit;
+                }
+            }
+        }
+        schedule(runnable);
+    }
+
+    void run() {
+        if (pending.empty())
+            return;
+        log_debug("parallel scheduler: {} nodes on {} threads", pending.size(), thread_pool::concurrency());
+        graph->getDirtyChecker();  // create it up front, workers may taint concurrently
+        // nodes without inputs receive nothing
+        fj.run_and_join([&] {
+            schedule(ready);
+        });
+    }
+};
+
+}
+
 ZENO_API void Graph::applyNodes(std::set<std::string> const &ids) {
     ctx = std::make_unique<Context>();
 
@@ -96,6 +334,20 @@ ZENO_API void Graph::applyNodes(std::set<std::string> const &ids) {
         ctx = nullptr;
     }};
 
+    // opt-in: ZENO_MEMOIZE=1 skips nodes whose inputs did not change since the
+    // last time they were applied (e.g. frame-independent work in runnermain)
+    ctx->memoize = envconfig::getBool("MEMOIZE");
+
+    // opt-in: ZENO_PARALLEL_GRAPH=1 runs independent branches on the zeno/para
+    // thread pool (sized by ZENO_NUM_THREADS)
+    if (envconfig::getBool("PARALLEL_GRAPH")) {
+        ParallelScheduler sched(this);
+        sched.build(ids);
+        sched.run();
+    }
+
+    // serial points and everything downstream of them are left to the usual
+    // depth-first evaluation, nodes already applied above are skipped
     for (auto const &id: ids) {
         applyNode(id);
     }
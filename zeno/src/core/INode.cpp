@@ -5,8 +5,11 @@
 #include <zeno/types/DummyObject.h>
 #include <zeno/types/NumericObject.h>
 #include <zeno/types/StringObject.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/ListObject.h>
 #include <zeno/extra/GlobalState.h>
 #include <zeno/extra/DirtyChecker.h>
+#include <zeno/extra/GlobalProfiler.h>
 #include <zeno/extra/TempNode.h>
 #include <zeno/utils/Error.h>
 #ifdef ZENO_BENCHMARKING
@@ -14,10 +17,63 @@
 #endif
 #include <zeno/utils/safe_at.h>
 #include <zeno/utils/logger.h>
+#include <zeno/utils/filesystem.h>
 #include <zeno/extra/GlobalState.h>
+#include <atomic>
+#include <utility>
 
 namespace zeno {
 
+namespace {
+
+struct MemoHasher {
+    std::size_t h = 14695981039346656037ull;
+
+    void bytes(void const *p, std::size_t n) {
+        auto c = static_cast<unsigned char const *>(p);
+        for (std::size_t i = 0; i < n; i++) {
+            h ^= c[i];
+            h *= 1099511628211ull;
+        }
+    }
+
+    template <class T>
+    void value(T const &t) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        bytes(&t, sizeof(t));
+    }
+
+    void string(std::string const &s) {
+        value(s.size());
+        bytes(s.data(), s.size());
+    }
+};
+
+// references into attribute arrays taken by apply() are dead once it returns,
+// let copies of the outputs share the arrays again
+void sealObject(IObject *obj) {
+    if (auto prim = dynamic_cast<PrimitiveObject *>(obj)) {
+        prim->seal();
+    } else if (auto lst = dynamic_cast<ListObject *>(obj)) {
+        for (auto const &elm: lst->arr)
+            sealObject(elm.get());
+    }
+}
+
+// memoizable nodes promise not to modify their inputs, so they get the objects
+// kept by an upstream memo as they are, other nodes get copies of them
+bool readsInputsOnly(INode const *node) {
+    auto desc = node->nodeClass ? node->nodeClass->desc.get() : nullptr;
+    return desc && desc->memoizable && node->graph->ctx && node->graph->ctx->memoize;
+}
+
+std::size_t nextOutputVersion() {
+    static std::atomic<std::size_t> counter{0};
+    return ++counter;
+}
+
+}
+
 ZENO_API INode::INode() = default;
 ZENO_API INode::~INode() = default;
 
@@ -26,10 +82,12 @@ ZENO_API Graph *INode::getThisGraph() const {
 }
 
 ZENO_API Session *INode::getThisSession() const {
+    touchedGlobals = true;
     return graph->session;
 }
 
 ZENO_API GlobalState *INode::getGlobalState() const {
+    touchedGlobals = true;
     return graph->session->globalState.get();
 }
 
@@ -73,6 +131,16 @@ ZENO_API void INode::preApply() {
         requireInput(ds);
     }
 
+    std::size_t key = graph->ctx && graph->ctx->memoize ? computeMemoKey() : 0;
+    if (key && key == memoKey) {
+        // shared with the consumers, requireInput copies them for the nodes
+        // that may modify their inputs in-place
+        log_debug("==> reuse {}", myname);
+        outputs = memoOutputs;
+        return;
+    }
+
+    touchedGlobals = false;
     log_debug("==> enter {}", myname);
     {
 #ifdef ZENO_BENCHMARKING
@@ -81,6 +149,98 @@ ZENO_API void INode::preApply() {
         apply();
     }
     log_debug("==> leave {}", myname);
+    outputVersion = nextOutputVersion();
+    for (auto const &[id, obj]: outputs) {
+        sealObject(obj.get());
+    }
+
+    // an input passed through may be kept by the upstream memo, it must not
+    // reach a consumer that modifies it, nor be kept twice
+    if (readsInputsOnly(this)) {
+        for (auto &[id, obj]: outputs) {
+            for (auto const &[ds, in]: inputs) {
+                if (obj && obj == in) {
+                    if (auto copy = obj->clone())
+                        obj = std::move(copy);
+                    break;
+                }
+            }
+        }
+    }
+
+    // nodes reading the frame number, session or global state are time dependent
+    memoKey = 0;
+    memoOutputs.clear();
+    if (key && !touchedGlobals) {
+        memoOutputs = outputs;
+        memoKey = key;
+    }
+}
+
+ZENO_API std::size_t INode::computeMemoKey() const {
+    auto desc = nodeClass ? nodeClass->desc.get() : nullptr;
+    if (!desc || !desc->memoizable)
+        return 0;
+    if (!kframes.empty() || !formulas.empty())
+        return 0;
+    if (graph->dirtyChecker && graph->dirtyChecker->amIDirty(myname))
+        return 0;
+
+    MemoHasher hasher;
+    hasher.value(nodeClass);
+    for (auto const &[id, obj]: inputs) {
+        hasher.string(id);
+        if (auto it = inputBounds.find(id); it != inputBounds.end()) {
+            // upstream outputs are identified by the version of their producer
+            auto const &[sn, ss] = it->second;
+            auto node = safe_at(graph->nodes, sn, "node name").get();
+            if (!node->outputVersion)
+                return 0;
+            hasher.value(node);
+            hasher.string(ss);
+            hasher.value(node->outputVersion);
+        } else if (!obj) {
+            hasher.value(0);
+        } else if (auto num = dynamic_cast<NumericObject const *>(obj.get())) {
+            hasher.value(num->value.index());
+            std::visit([&] (auto const &val) {
+                hasher.value(val);
+            }, num->value);
+        } else if (auto str = dynamic_cast<StringObject const *>(obj.get())) {
+            hasher.string(str->get());
+        } else {
+            // an object not coming from a link, whose content we cannot hash
+            return 0;
+        }
+    }
+
+    // files read by the node take part in the key, files written forbid caching
+    auto hashPath = [&] (std::string const &type, std::string const &id) {
+        if (type == "writepath")
+            return false;
+        if (type == "readpath") {
+            auto it = inputs.find(id);
+            auto str = it != inputs.end() ? dynamic_cast<StringObject const *>(it->second.get()) : nullptr;
+            if (str) {
+                std::error_code ec;
+                auto path = fs::u8path(str->get());
+                auto mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+                auto size = ec ? 0 : fs::file_size(path, ec);
+                hasher.value(mtime);
+                hasher.value(size);
+            }
+        }
+        return true;
+    };
+    for (auto const &sock: desc->inputs) {
+        if (!hashPath(sock.type, sock.name))
+            return 0;
+    }
+    for (auto const &param: desc->params) {
+        if (!hashPath(param.type, param.name + ':'))
+            return 0;
+    }
+    return hasher.h ? hasher.h : 1;
 }
 
 ZENO_API bool INode::requireInput(std::string const &ds) {
@@ -88,11 +248,25 @@ ZENO_API bool INode::requireInput(std::string const &ds) {
     if (it == inputBounds.end())
         return false;
     auto [sn, ss] = it->second;
+    GlobalProfiler::WaitScope _;
     if (graph->applyNode(sn)) {
         auto &dc = graph->getDirtyChecker();
         dc.taintThisNode(myname);
     }
     auto ref = graph->getNodeOutput(sn, ss);
+    if (ref && !readsInputsOnly(this)) {
+        auto src = safe_at(graph->nodes, sn, "node name").get();
+        if (auto it = src->memoOutputs.find(ss); src->memoKey && it != src->memoOutputs.end() && it->second == ref) {
+            // only these consumers pay for copying the positions and topology, the
+            // attribute arrays stay shared until written; objects that cannot be
+            // copied are handed out and the producer is recomputed next time
+            // (consumers of one object never run concurrently)
+            if (auto copy = ref->clone())
+                ref = std::move(copy);
+            else
+                src->memoKey = 0;
+        }
+    }
     inputs[ds] = ref;
     return true;
 }
@@ -1,7 +1,11 @@
 #include <zeno/extra/GlobalComm.h>
 #include <zeno/extra/GlobalState.h>
 #include <zeno/funcs/ObjectCodec.h>
+#include <zeno/funcs/ObjectGeometryInfo.h>
 #include <zeno/utils/log.h>
+#include <zeno/utils/mapped_file.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/para/parallel_for.h>
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
@@ -18,88 +22,73 @@
 
 namespace zeno {
 
-std::vector<std::filesystem::path> cachepath(3);
 std::unordered_set<std::string> lightCameraNodes({
     "CameraEval", "CameraNode", "CihouMayaCameraFov", "ExtractCameraData", "GetAlembicCamera","MakeCamera",
     "LightNode", "BindLight", "ProceduralSky", "HDRSky",
     });
 std::string matlNode = "ShaderFinalize";
 
-static void toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects &objs, bool cacheLightCameraOnly, bool cacheMaterialOnly) {
+static void toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects &objs, bool cacheLightCameraOnly, bool cacheMaterialOnly, ObjectCodecOptions const &codec) {
     if (cachedir.empty()) return;
     std::filesystem::path dir = std::filesystem::u8path(cachedir + "/" + std::to_string(1000000 + frameid).substr(1));
     if (!std::filesystem::exists(dir) && !std::filesystem::create_directories(dir))
     {
         log_critical("can not create path: {}", dir);
     }
-    std::vector<std::vector<char>> bufCaches(3);
-    std::vector<std::vector<size_t>> poses(3);
-    std::vector<std::string> keys(3);
+    // encode every object into its own buffer concurrently, offsets follow by prefix sum
+    struct Entry {
+        int cate;
+        std::string const *key;
+        IObject const *obj;
+        std::vector<char> buf;
+        bool ok = false;
+    };
+    std::vector<Entry> entries;
     for (auto const &[key, obj]: objs) {
 
-        size_t bufsize =0;
         std::string nodeName = key.substr(key.find("-") + 1, key.find(":") - key.find("-") -1);
-        if (cacheLightCameraOnly && (lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj)))
-        {
-            bufsize = bufCaches[0].size();
-            if (encodeObject(obj.get(), bufCaches[0]))
-            {
-                keys[0].push_back('\a');
-                keys[0].append(key);
-                poses[0].push_back(bufsize);
-            }
-        }
-        if (cacheMaterialOnly && (matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj)))
-        {
-            bufsize = bufCaches[1].size();
-            if (encodeObject(obj.get(), bufCaches[1]))
-            {
-                keys[1].push_back('\a');
-                keys[1].append(key);
-                poses[1].push_back(bufsize);
-            }
-        }
+        bool isLightCamera = lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj);
+        bool isMaterial = matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj);
+        if (cacheLightCameraOnly && isLightCamera)
+            entries.push_back({0, &key, obj.get(), {}, false});
+        if (cacheMaterialOnly && isMaterial)
+            entries.push_back({1, &key, obj.get(), {}, false});
         if (!cacheLightCameraOnly && !cacheMaterialOnly)
-        {
-            if (lightCameraNodes.count(nodeName) || obj->userData().get2<int>("isL", 0) || std::dynamic_pointer_cast<CameraObject>(obj)) {
-                bufsize = bufCaches[0].size();
-                if (encodeObject(obj.get(), bufCaches[0]))
-                {
-                    keys[0].push_back('\a');
-                    keys[0].append(key);
-                    poses[0].push_back(bufsize);
-                }
-            } else if (matlNode == nodeName || std::dynamic_pointer_cast<MaterialObject>(obj)) {
-                bufsize = bufCaches[1].size();
-                if (encodeObject(obj.get(), bufCaches[1]))
-                {
-                    keys[1].push_back('\a');
-                    keys[1].append(key);
-                    poses[1].push_back(bufsize);
-                }
-            } else {
-                bufsize = bufCaches[2].size();
-                if (encodeObject(obj.get(), bufCaches[2]))
-                {
-                    keys[2].push_back('\a');
-                    keys[2].append(key);
-                    poses[2].push_back(bufsize);
-                }
-            }
-        }
+            entries.push_back({isLightCamera ? 0 : isMaterial ? 1 : 2, &key, obj.get(), {}, false});
+    }
+    parallel_for((size_t)0, entries.size(), [&] (size_t i) {
+        entries[i].ok = encodeObject(entries[i].obj, entries[i].buf, codec);
+    }, 1);
+
+    std::vector<size_t> dataSizes(3);
+    std::vector<std::vector<size_t>> poses(3);
+    std::vector<std::vector<Entry const *>> blobs(3);
+    std::vector<std::string> keys(3);
+    for (auto const &ent: entries) {
+        if (!ent.ok)
+            continue;
+        int i = ent.cate;
+        keys[i].push_back('\a');
+        keys[i].append(*ent.key);
+        poses[i].push_back(dataSizes[i]);
+        blobs[i].push_back(&ent);
+        dataSizes[i] += ent.buf.size();
     }
-    cachepath[0] = dir / "lightCameraObj.zencache";
-    cachepath[1] = dir / "materialObj.zencache";
-    cachepath[2] = dir / "normalObj.zencache";
+    // local paths, toDisk may run on the runner's I/O thread concurrently with fromDisk
+    std::filesystem::path cachepath[3] = {
+        dir / "lightCameraObj.zencache",
+        dir / "materialObj.zencache",
+        dir / "normalObj.zencache",
+    };
     size_t currentFrameSize = 0;
     for (int i = 0; i < 3; i++)
     {
-        if (poses[i].size() == 0 && (cacheLightCameraOnly && i != 0 || cacheMaterialOnly && i != 1))
+        if (poses[i].size() == 0 && ((cacheLightCameraOnly && i != 0) || (cacheMaterialOnly && i != 1)))
             continue;
         keys[i].push_back('\a');
         keys[i] = "ZENCACHE" + std::to_string(poses[i].size()) + keys[i];
-        poses[i].push_back(bufCaches[i].size());
-        currentFrameSize += keys[i].size() + poses[i].size() * sizeof(size_t) + bufCaches[i].size();
+        poses[i].push_back(dataSizes[i]);
+        currentFrameSize += keys[i].size() + poses[i].size() * sizeof(size_t) + dataSizes[i];
     }
     size_t freeSpace = 0;
     #ifdef __linux__
@@ -126,14 +115,29 @@ static void toDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects &o
     }
     for (int i = 0; i < 3; i++)
     {
-        if (poses[i].size() == 0 && (cacheLightCameraOnly && i != 0 || cacheMaterialOnly && i != 1))
+        if (poses[i].size() == 0 && ((cacheLightCameraOnly && i != 0) || (cacheMaterialOnly && i != 1)))
             continue;
         log_critical("dump cache to disk {}", cachepath[i]);
-        std::ofstream ofs(cachepath[i], std::ios::binary);
-        std::ostreambuf_iterator<char> oit(ofs);
-        std::copy(keys[i].begin(), keys[i].end(), oit);
-        std::copy_n((const char *)poses[i].data(), poses[i].size() * sizeof(size_t), oit);
-        std::copy(bufCaches[i].begin(), bufCaches[i].end(), oit);
+        // write aside and rename over the old file: a reader may have the old one
+        // mapped, truncating it in place would fault (SIGBUS) on its next access
+        auto tmppath = cachepath[i];
+        tmppath += ".tmp";
+        std::ofstream ofs(tmppath, std::ios::binary);
+        ofs.write(keys[i].data(), keys[i].size());
+        ofs.write((const char *)poses[i].data(), poses[i].size() * sizeof(size_t));
+        for (auto const *ent: blobs[i])
+            ofs.write(ent->buf.data(), ent->buf.size());
+        ofs.close();
+        std::error_code ec;
+        if (!ofs)
+            log_error("cannot write zeno cache file {}", tmppath);
+        else
+            std::filesystem::rename(tmppath, cachepath[i], ec);
+        if (!ofs || ec) {
+            if (ec)
+                log_error("cannot replace zeno cache file {}: {}", cachepath[i], ec.message());
+            std::filesystem::remove(tmppath, ec);
+        }
     }
     objs.clear();
 }
@@ -142,10 +146,12 @@ static bool fromDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects
     if (cachedir.empty())
         return false;
     objs.clear();
-    cachepath[2] = std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "normalObj.zencache";
-    cachepath[1] = std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "materialObj.zencache";
-    cachepath[0] = std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "lightCameraObj.zencache";
-    for (auto path : cachepath)
+    std::filesystem::path cachepath[3] = {
+        std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "lightCameraObj.zencache",
+        std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "materialObj.zencache",
+        std::filesystem::u8path(cachedir) / std::to_string(1000000 + frameid).substr(1) / "normalObj.zencache",
+    };
+    for (auto const &path : cachepath)
     {
         if (!std::filesystem::exists(path))
         {
@@ -153,53 +159,78 @@ static bool fromDisk(std::string cachedir, int frameid, GlobalComm::ViewObjects
         }
         log_critical("load cache from disk {}", path);
 
-        auto szBuffer = std::filesystem::file_size(path);
-        std::vector<char> dat(szBuffer);
-        FILE *fp = fopen(path.string().c_str(), "rb");
-        if (!fp) {
+        // decode straight from the mapped pages instead of reading into a heap copy first;
+        // attributes are still copied out, the copy-on-write sharing of AttrVector is
+        // between std::vectors and cannot alias pages that go away with the mapping
+        mapped_file file(path.u8string());
+        if (!file) {
             log_error("zeno cache file does not exist");
             return false;
         }
-        size_t ret = fread(&dat[0], 1, szBuffer, fp);
-        assert(ret == szBuffer);
-        fclose(fp);
-        fp = nullptr;
+        const char *dat = file.data();
+        size_t datsize = file.size();
 
-        if (dat.size() <= 8 || std::string(dat.data(), 8) != "ZENCACHE") {
+        if (datsize <= 8 || std::string_view(dat, 8) != "ZENCACHE") {
             log_error("zeno cache file broken (1)");
             return false;
         }
-        size_t pos = std::find(dat.begin() + 8, dat.end(), '\a') - dat.begin();
-        if (pos == dat.size()) {
+        size_t pos = std::find(dat + 8, dat + datsize, '\a') - dat;
+        if (pos == datsize) {
             log_error("zeno cache file broken (2)");
             return false;
         }
-        size_t keyscount = std::stoi(std::string(dat.data() + 8, pos - 8));
+        size_t keyscount = std::stoi(std::string(dat + 8, pos - 8));
         pos = pos + 1;
         std::vector<std::string> keys;
         for (int k = 0; k < keyscount; k++) {
-            size_t newpos = std::find(dat.begin() + pos, dat.end(), '\a') - dat.begin();
-            if (newpos == dat.size()) {
+            size_t newpos = std::find(dat + pos, dat + datsize, '\a') - dat;
+            if (newpos == datsize) {
                 log_error("zeno cache file broken (3.{})", k);
                 return false;
             }
-            keys.emplace_back(dat.data() + pos, newpos - pos);
+            keys.emplace_back(dat + pos, newpos - pos);
             pos = newpos + 1;
         }
         std::vector<size_t> poses(keyscount + 1);
-        std::copy_n(dat.data() + pos, (keyscount + 1) * sizeof(size_t), (char *)poses.data());
+        if ((keyscount + 1) * sizeof(size_t) > datsize - pos) {
+            log_error("zeno cache file broken (4)");
+            return false;
+        }
+        std::copy_n(dat + pos, (keyscount + 1) * sizeof(size_t), (char *)poses.data());
         pos += (keyscount + 1) * sizeof(size_t);
-        for (int k = 0; k < keyscount; k++) {
-            if (poses[k] > dat.size() - pos || poses[k + 1] < poses[k]) {
+        // the last offset is the total size of the blobs, a shorter file was cut
+        // off while being written and its missing pages must not be touched
+        if (pos > datsize || poses[keyscount] > datsize - pos) {
+            log_error("zeno cache file broken (5), expect {} bytes, got {}", pos + poses[keyscount], datsize);
+            return false;
+        }
+        std::vector<std::shared_ptr<IObject>> decoded(keyscount);
+        parallel_for((size_t)0, keyscount, [&] (size_t k) {
+            if (poses[k] > datsize - pos || poses[k + 1] < poses[k] || poses[k + 1] > datsize - pos) {
                 log_error("zeno cache file broken (4.{})", k);
+                return;
             }
-            const char *p = dat.data() + pos + poses[k];
-            objs.try_emplace(keys[k], decodeObject(p, poses[k + 1] - poses[k]));
+            const char *p = dat + pos + poses[k];
+            decoded[k] = decodeObject(p, poses[k + 1] - poses[k]);
+        }, 1);
+        for (size_t k = 0; k < keyscount; k++) {
+            if (decoded[k])
+                objs.try_emplace(keys[k], std::move(decoded[k]));
         }
     }
     return true;
 }
 
+ZENO_API GlobalComm::~GlobalComm() {
+    {
+        std::lock_guard lck(m_mtx);
+        m_prefetchStop = true;
+    }
+    m_prefetchCv.notify_all();
+    if (m_prefetchThread.joinable())
+        m_prefetchThread.join();
+}
+
 ZENO_API void GlobalComm::newFrame() {
     std::lock_guard lck(m_mtx);
     log_debug("GlobalComm::newFrame {}", m_frames.size());
@@ -215,12 +246,22 @@ ZENO_API void GlobalComm::finishFrame() {
 }
 
 ZENO_API void GlobalComm::dumpFrameCache(int frameid, bool cacheLightCameraOnly, bool cacheMaterialOnly) {
-    std::lock_guard lck(m_mtx);
-    int frameIdx = frameid - beginFrameNumber;
-    if (frameIdx >= 0 && frameIdx < m_frames.size()) {
-        log_debug("dumping frame {}", frameid);
-        toDisk(cacheFramePath, frameid, m_frames[frameIdx].view_objects, cacheLightCameraOnly, cacheMaterialOnly);
+    // take the objects out and encode them unlocked, so that the next frame can
+    // keep adding view objects while this one is being written
+    ViewObjects objs;
+    std::string cachedir;
+    ObjectCodecOptions codec;
+    {
+        std::lock_guard lck(m_mtx);
+        int frameIdx = frameid - beginFrameNumber;
+        if (cacheFramePath.empty() || frameIdx < 0 || frameIdx >= m_frames.size())
+            return;
+        std::swap(objs, m_frames[frameIdx].view_objects);
+        cachedir = cacheFramePath;
+        codec = cacheCodec;
     }
+    log_debug("dumping frame {}", frameid);
+    toDisk(cachedir, frameid, objs, cacheLightCameraOnly, cacheMaterialOnly, codec);
 }
 
 ZENO_API void GlobalComm::addViewObject(std::string const &key, std::shared_ptr<IObject> object) {
@@ -230,20 +271,30 @@ ZENO_API void GlobalComm::addViewObject(std::string const &key, std::shared_ptr<
     m_frames.back().view_objects.try_emplace(key, std::move(object));
 }
 
+void GlobalComm::_resetFrameCache() {
+    m_inCacheFrames.clear();
+    m_inCacheBytes = 0;
+    m_prefetchQueue.clear();
+    m_lastRequestedFrame = -1;
+    ++m_cacheEpoch;
+    m_loadCv.notify_all();
+}
+
 ZENO_API void GlobalComm::clearState() {
     std::lock_guard lck(m_mtx);
     m_frames.clear();
-    m_inCacheFrames.clear();
+    _resetFrameCache();
     m_maxPlayFrame = 0;
     maxCachedFrames = 1;
     cacheFramePath = {};
+    cacheCodec = {};
 }
 
 ZENO_API void GlobalComm::clearFrameState()
 {
     std::lock_guard lck(m_mtx);
     m_frames.clear();
-    m_inCacheFrames.clear();
+    _resetFrameCache();
     m_maxPlayFrame = 0;
 }
 
@@ -251,6 +302,26 @@ ZENO_API void GlobalComm::frameCache(std::string const &path, int gcmax) {
     std::lock_guard lck(m_mtx);
     cacheFramePath = path;
     maxCachedFrames = gcmax;
+    // ZENO_CACHE_COMPRESS=1 compresses primitive attributes losslessly,
+    // ZENO_CACHE_POSITION_BITS=16 additionally quantizes positions in the bbox
+    cacheCodec.compress = envconfig::getBool("CACHE_COMPRESS");
+    cacheCodec.positionBits = envconfig::getInt("CACHE_POSITION_BITS");
+    // gcmax frames loaded back from disk stay in memory, ZENO_CACHE_MEMORY_MB
+    // additionally bounds their size; ZENO_CACHE_PREFETCH is the number of
+    // frames read ahead while playing, on top of gcmax
+    maxCacheBytes = std::size_t(std::max(envconfig::getInt("CACHE_MEMORY_MB", 0), 0)) << 20;
+    prefetchFrames = std::max(envconfig::getInt("CACHE_PREFETCH", 2), 0);
+}
+
+ZENO_API void GlobalComm::setCacheBudget(std::size_t maxBytes, int prefetch) {
+    std::lock_guard lck(m_mtx);
+    maxCacheBytes = maxBytes;
+    prefetchFrames = std::max(prefetch, 0);
+}
+
+ZENO_API void GlobalComm::setCacheCodec(ObjectCodecOptions const &options) {
+    std::lock_guard lck(m_mtx);
+    cacheCodec = options;
 }
 
 ZENO_API void GlobalComm::initFrameRange(int beg, int end) {
@@ -281,38 +352,132 @@ ZENO_API std::pair<int, int> GlobalComm::frameRange() {
 }
 
 ZENO_API GlobalComm::ViewObjects const *GlobalComm::getViewObjects(const int frameid) {
-    std::lock_guard lck(m_mtx);
-    return _getViewObjects(frameid);
+    std::vector<ViewObjects> evicted;  // destroyed after unlocking
+    std::unique_lock lck(m_mtx);
+    return _getViewObjects(lck, frameid, evicted);
 }
 
-GlobalComm::ViewObjects const* GlobalComm::_getViewObjects(const int frameid) {
-    int frameIdx = frameid - beginFrameNumber;
-    if (frameIdx < 0 || frameIdx >= m_frames.size())
+// called and returns with lck held, but never holds it while reading from disk
+GlobalComm::ViewObjects const* GlobalComm::_getViewObjects(std::unique_lock<std::mutex> &lck, const int frameid,
+                                                           std::vector<ViewObjects> &evicted, bool prefetch) {
+    auto inRange = [&] {
+        int frameIdx = frameid - beginFrameNumber;
+        return frameIdx >= 0 && frameIdx < m_frames.size();
+    };
+    if (!inRange())
         return nullptr;
-    if (maxCachedFrames != 0) {
-        // load back one gc:
-        if (!m_inCacheFrames.count(frameid)) {  // notinmem then cacheit
-            bool ret = fromDisk(cacheFramePath, frameid, m_frames[frameIdx].view_objects);
-            if (!ret)
+    if (maxCachedFrames == 0)
+        return &m_frames[frameid - beginFrameNumber].view_objects;
+    if (!prefetch)
+        _prefetchFrom(frameid);
+
+    // wait if the prefetcher (or another viewer) is loading this frame already
+    while (!m_inCacheFrames.count(frameid)) {
+        if (!m_frames[frameid - beginFrameNumber].loading) {
+            m_frames[frameid - beginFrameNumber].loading = true;
+            auto epoch = m_cacheEpoch;
+            auto cachedir = cacheFramePath;
+            lck.unlock();
+            ViewObjects objs;
+            bool ret = fromDisk(cachedir, frameid, objs);
+            ObjectMemoryStats stats;
+            for (auto const &[key, obj]: objs)
+                objectGetMemoryStats(obj.get(), stats);
+            lck.lock();
+            m_loadCv.notify_all();
+            if (epoch != m_cacheEpoch || !inRange()) {
+                evicted.push_back(std::move(objs));
                 return nullptr;
-
+            }
+            auto &frame = m_frames[frameid - beginFrameNumber];
+            frame.loading = false;
+            if (!ret) {
+                evicted.push_back(std::move(objs));
+                return nullptr;
+            }
+            evicted.push_back(std::move(frame.view_objects));
+            frame.view_objects = std::move(objs);
+            frame.cacheBytes = stats.bytes;
+            m_inCacheBytes += stats.bytes;
             m_inCacheFrames.insert(frameid);
-            // and dump one as balance:
-            if (m_inCacheFrames.size() && m_inCacheFrames.size() > maxCachedFrames) { // notindisk then dumpit
-                for (int i: m_inCacheFrames) {
-                    if (i != frameid) {
-                        // seems that objs will not be modified when load_objects called later.
-                        // so, there is no need to dump.
-                        //toDisk(cacheFramePath, i, m_frames[i - beginFrameNumber].view_objects);
-                        m_frames[i - beginFrameNumber].view_objects.clear();
-                        m_inCacheFrames.erase(i);
-                        break;
-                    }
-                }
+            break;
+        }
+        m_loadCv.wait(lck);
+        if (!inRange())
+            return nullptr;
+    }
+    auto &frame = m_frames[frameid - beginFrameNumber];
+    frame.lastUsed = ++m_useTick;
+    _evictFrames(frameid, evicted);
+    return &frame.view_objects;
+}
+
+// drop least recently used frames until at most maxCachedFrames (plus the ones
+// read ahead) are left and the byte budget, if any, is kept; the frame being
+// asked for and the one last shown are kept, so one frame may exceed the budget
+void GlobalComm::_evictFrames(int keepFrameid, std::vector<ViewObjects> &evicted) {
+    auto maxFrames = (std::size_t)std::max(maxCachedFrames, 1) + prefetchFrames;
+    while (m_inCacheFrames.size() > maxFrames || (maxCacheBytes && m_inCacheBytes > maxCacheBytes)) {
+        int victim = -1;
+        std::uint64_t oldest = 0;
+        for (int i: m_inCacheFrames) {
+            if (i == keepFrameid || i == m_lastRequestedFrame)
+                continue;
+            auto &frame = m_frames[i - beginFrameNumber];
+            if (victim == -1 || frame.lastUsed < oldest) {
+                victim = i;
+                oldest = frame.lastUsed;
             }
         }
+        if (victim == -1)
+            break;
+        // seems that objs will not be modified when load_objects called later.
+        // so, there is no need to dump.
+        auto &frame = m_frames[victim - beginFrameNumber];
+        evicted.push_back(std::move(frame.view_objects));
+        frame.view_objects.clear();
+        m_inCacheBytes -= frame.cacheBytes;
+        frame.cacheBytes = 0;
+        m_inCacheFrames.erase(victim);
+    }
+}
+
+// queue the next frames in the direction the viewer is moving
+void GlobalComm::_prefetchFrom(int frameid) {
+    int dir = m_lastRequestedFrame == -1 || frameid >= m_lastRequestedFrame ? 1 : -1;
+    m_lastRequestedFrame = frameid;
+    m_prefetchQueue.clear();
+    for (int k = 1; k <= prefetchFrames; k++) {
+        int next = frameid + dir * k;
+        int nextIdx = next - beginFrameNumber;
+        if (nextIdx < 0 || nextIdx >= m_frames.size() || m_frames[nextIdx].frame_state != FRAME_COMPLETED)
+            break;
+        if (!m_inCacheFrames.count(next) && !m_frames[nextIdx].loading)
+            m_prefetchQueue.push_back(next);
+    }
+    if (m_prefetchQueue.empty())
+        return;
+    if (!m_prefetchThread.joinable())
+        m_prefetchThread = std::thread([this] { _prefetchLoop(); });
+    m_prefetchCv.notify_one();
+}
+
+void GlobalComm::_prefetchLoop() {
+    std::unique_lock lck(m_mtx);
+    while (true) {
+        m_prefetchCv.wait(lck, [&] { return m_prefetchStop || !m_prefetchQueue.empty(); });
+        if (m_prefetchStop)
+            return;
+        int frameid = m_prefetchQueue.front();
+        m_prefetchQueue.pop_front();
+        std::vector<ViewObjects> evicted;
+        _getViewObjects(lck, frameid, evicted, true);
+        if (!evicted.empty()) {
+            lck.unlock();
+            evicted.clear();
+            lck.lock();
+        }
     }
-    return &m_frames[frameIdx].view_objects;
 }
 
 ZENO_API GlobalComm::ViewObjects const &GlobalComm::getViewObjects() {
@@ -328,7 +493,8 @@ ZENO_API bool GlobalComm::load_objects(
     if (!callback)
         return false;
 
-    std::lock_guard lck(m_mtx);
+    std::vector<ViewObjects> evicted;  // destroyed after unlocking
+    std::unique_lock lck(m_mtx);
 
     int frame = frameid;
     frame -= beginFrameNumber;
@@ -340,7 +506,7 @@ ZENO_API bool GlobalComm::load_objects(
 
     isFrameValid = true;
     bool inserted = false;
-    auto const* viewObjs = _getViewObjects(frameid);
+    auto const* viewObjs = _getViewObjects(lck, frameid, evicted);
     if (viewObjs) {
         zeno::log_trace("load_objects: {} objects at frame {}", viewObjs->size(), frameid);
         inserted = callback(viewObjs->m_curr);
@@ -0,0 +1,209 @@
+#include <zeno/extra/GlobalProfiler.h>
+#include <zeno/extra/GlobalState.h>
+#include <zeno/funcs/ObjectGeometryInfo.h>
+#include <zeno/core/Session.h>
+#include <zeno/core/Graph.h>
+#include <zeno/core/INode.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/utils/log.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <fstream>
+
+namespace zeno {
+
+namespace {
+
+thread_local GlobalProfiler::NodeScope *tls_current = nullptr;
+
+int currentThreadIndex() {
+    static std::atomic<int> counter{0};
+    thread_local int index = counter++;
+    return index;
+}
+
+int64_t elapsedUs(GlobalProfiler::ClockType::time_point beg, GlobalProfiler::ClockType::time_point end) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - beg).count();
+}
+
+std::string csvEscape(std::string const &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos)
+        return s;
+    std::string res = "\"";
+    for (char c: s) {
+        if (c == '"') res += '"';
+        res += c;
+    }
+    res += '"';
+    return res;
+}
+
+bool writeFile(std::string const &path, std::string const &content) {
+    std::ofstream ofs(path, std::ios::binary);
+    if (!ofs) {
+        log_error("failed to open file for write: {}", path);
+        return false;
+    }
+    ofs << content;
+    return true;
+}
+
+}
+
+ZENO_API GlobalProfiler::NodeScope::NodeScope(GlobalProfiler *profiler, INode *node) {
+    if (!profiler || !profiler->isEnabled())
+        return;
+    this->profiler = profiler;
+    this->node = node;
+    parent = tls_current;
+    tls_current = this;
+    beg = ClockType::now();
+}
+
+ZENO_API GlobalProfiler::NodeScope::~NodeScope() {
+    if (!profiler)
+        return;
+    auto end = ClockType::now();
+    tls_current = parent;
+
+    Record rec;
+    rec.nodeName = node->myname;
+    rec.nodeClass = profiler->classNameOf(node);
+    rec.frameid = node->getGlobalState()->frameid;
+    rec.threadid = currentThreadIndex();
+    rec.beginUs = elapsedUs(profiler->m_epoch, beg);
+    rec.wallUs = elapsedUs(beg, end);
+    rec.waitUs = waitUs;
+    ObjectMemoryStats stats;
+    for (auto const &[key, obj]: node->outputs) {
+        objectGetMemoryStats(obj.get(), stats);
+    }
+    rec.outputBytes = stats.bytes;
+    rec.outputVerts = stats.verts;
+    rec.outputFaces = stats.faces;
+    profiler->addRecord(std::move(rec));
+}
+
+ZENO_API GlobalProfiler::WaitScope::WaitScope() : owner(tls_current) {
+    if (owner)
+        beg = ClockType::now();
+}
+
+ZENO_API GlobalProfiler::WaitScope::~WaitScope() {
+    if (owner)
+        owner->waitUs += elapsedUs(beg, ClockType::now());
+}
+
+ZENO_API GlobalProfiler::GlobalProfiler() {
+    // ZENO_PROFILE=/path/prefix profiles the whole session and writes
+    // prefix.json (chrome trace) and prefix.csv when the session ends
+    m_dumpPrefix = envconfig::getStr("PROFILE");
+    if (!m_dumpPrefix.empty())
+        setEnabled(true);
+}
+
+ZENO_API GlobalProfiler::~GlobalProfiler() {
+    if (!m_dumpPrefix.empty()) {
+        dumpChromeTrace(m_dumpPrefix + ".json");
+        dumpCSV(m_dumpPrefix + ".csv");
+    }
+}
+
+ZENO_API void GlobalProfiler::setEnabled(bool enabled) {
+    std::lock_guard lck(m_mtx);
+    if (enabled && !m_enabled && m_records.empty())
+        m_epoch = ClockType::now();
+    m_enabled = enabled;
+}
+
+ZENO_API void GlobalProfiler::clear() {
+    std::lock_guard lck(m_mtx);
+    m_records.clear();
+    m_epoch = ClockType::now();
+}
+
+ZENO_API std::vector<GlobalProfiler::Record> GlobalProfiler::getRecords() const {
+    std::lock_guard lck(m_mtx);
+    return m_records;
+}
+
+std::string GlobalProfiler::classNameOf(INode *node) {
+    std::lock_guard lck(m_mtx);
+    auto cls = node->nodeClass;
+    if (auto it = m_classNames.find(cls); it != m_classNames.end())
+        return it->second;
+    std::string name = "Subnet";
+    for (auto const &[key, val]: node->getThisSession()->nodeClasses) {
+        if (val.get() == cls) {
+            name = key;
+            break;
+        }
+    }
+    m_classNames.emplace(cls, name);
+    return name;
+}
+
+void GlobalProfiler::addRecord(Record &&rec) {
+    std::lock_guard lck(m_mtx);
+    m_records.push_back(std::move(rec));
+}
+
+ZENO_API std::string GlobalProfiler::toChromeTrace() const {
+    auto records = getRecords();
+
+    rapidjson::Document doc(rapidjson::kObjectType);
+    auto &alloc = doc.GetAllocator();
+    rapidjson::Value events(rapidjson::kArrayType);
+    for (auto const &rec: records) {
+        rapidjson::Value ev(rapidjson::kObjectType);
+        ev.AddMember("name", rapidjson::Value(rec.nodeName.c_str(), alloc), alloc);
+        ev.AddMember("cat", rapidjson::Value(rec.nodeClass.c_str(), alloc), alloc);
+        ev.AddMember("ph", "X", alloc);
+        ev.AddMember("ts", rec.beginUs, alloc);
+        ev.AddMember("dur", rec.wallUs, alloc);
+        ev.AddMember("pid", 0, alloc);
+        ev.AddMember("tid", rec.threadid, alloc);
+        rapidjson::Value args(rapidjson::kObjectType);
+        args.AddMember("frame", rec.frameid, alloc);
+        args.AddMember("wait_us", rec.waitUs, alloc);
+        args.AddMember("self_us", rec.wallUs - rec.waitUs, alloc);
+        args.AddMember("output_bytes", (uint64_t)rec.outputBytes, alloc);
+        args.AddMember("output_verts", (uint64_t)rec.outputVerts, alloc);
+        args.AddMember("output_faces", (uint64_t)rec.outputFaces, alloc);
+        ev.AddMember("args", args, alloc);
+        events.PushBack(ev, alloc);
+    }
+    doc.AddMember("traceEvents", events, alloc);
+    doc.AddMember("displayTimeUnit", "ms", alloc);
+
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer writer(buf);
+    doc.Accept(writer);
+    return {buf.GetString(), buf.GetLength()};
+}
+
+ZENO_API std::string GlobalProfiler::toCSV() const {
+    auto records = getRecords();
+
+    std::string res = "node,class,frame,thread,begin_us,wall_us,wait_us,self_us,output_bytes,output_verts,output_faces\n";
+    for (auto const &rec: records) {
+        res += csvEscape(rec.nodeName) + ',' + csvEscape(rec.nodeClass)
+            + ',' + std::to_string(rec.frameid) + ',' + std::to_string(rec.threadid)
+            + ',' + std::to_string(rec.beginUs) + ',' + std::to_string(rec.wallUs)
+            + ',' + std::to_string(rec.waitUs) + ',' + std::to_string(rec.wallUs - rec.waitUs)
+            + ',' + std::to_string(rec.outputBytes) + ',' + std::to_string(rec.outputVerts)
+            + ',' + std::to_string(rec.outputFaces) + '\n';
+    }
+    return res;
+}
+
+ZENO_API bool GlobalProfiler::dumpChromeTrace(std::string const &path) const {
+    return writeFile(path, toChromeTrace());
+}
+
+ZENO_API bool GlobalProfiler::dumpCSV(std::string const &path) const {
+    return writeFile(path, toCSV());
+}
+
+}
@@ -10,6 +10,7 @@
 #include <zeno/utils/cppdemangle.h>
 #include <zeno/types/UserData.h>
 #include <zeno/utils/log.h>
+#include <zeno/utils/scope_exit.h>
 #include <algorithm>
 #include <cstring>
 
@@ -36,6 +37,21 @@ struct ObjectHeader {
 
 namespace _implObjectCodec {
 
+static thread_local ObjectCodecOptions const *tls_encodeOptions = nullptr;
+
+ObjectCodecOptions const *currentEncodeOptions();
+ObjectCodecOptions const *currentEncodeOptions() {
+    return tls_encodeOptions;
+}
+
+// end of the buffer the current object is decoded from, for decoders that
+// check lengths read from the data against it
+static thread_local const char *tls_decodeEnd = nullptr;
+
+const char *currentDecodeEnd();
+const char *currentDecodeEnd() {
+    return tls_decodeEnd;
+}
 
 #define _PER_OBJECT_TYPE(TypeName, ...) \
 std::shared_ptr<TypeName> decode##TypeName(const char *it); \
@@ -54,6 +70,8 @@ static std::shared_ptr<IObject> _decodeObjectImpl(const char *buf, size_t len) {
     }
     auto &header = *(ObjectHeader *)buf;
     auto it = buf + sizeof(ObjectHeader);
+    auto oldEnd = std::exchange(tls_decodeEnd, buf + len);
+    scope_exit restoreEnd{[&] { tls_decodeEnd = oldEnd; }};
 
     if (0) {
 
@@ -146,4 +164,12 @@ bool encodeObject(IObject const *object, std::vector<char> &buf) {
     return true;
 }
 
+bool encodeObject(IObject const *object, std::vector<char> &buf, ObjectCodecOptions const &options) {
+    auto old = std::exchange(tls_encodeOptions, &options);
+    scope_exit restore{[&] {
+        tls_encodeOptions = old;
+    }};
+    return encodeObject(object, buf);
+}
+
 }
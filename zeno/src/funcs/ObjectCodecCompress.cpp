@@ -0,0 +1,143 @@
+#include <zeno/funcs/ObjectCodec.h>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+namespace zeno {
+
+namespace _implObjectCodec {
+
+// LZ4-style block format: sequences of
+//   token (literal length << 4 | match length - 4), [extra literal length bytes],
+//   literals, offset (u16 le), [extra match length bytes]
+// the last sequence carries literals only
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kHashLog = 16;
+constexpr size_t kMaxOffset = 65535;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchFindLimit = 12;
+
+inline uint32_t read32(uint8_t const *p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline size_t hash32(uint32_t v) {
+    return (v * 2654435761u) >> (32 - kHashLog);
+}
+
+void writeLength(std::vector<char> &dst, size_t len) {
+    while (len >= 255) {
+        dst.push_back((char)255);
+        len -= 255;
+    }
+    dst.push_back((char)len);
+}
+
+bool readLength(uint8_t const *src, size_t n, size_t &ip, size_t &len) {
+    uint8_t b;
+    do {
+        if (ip >= n)
+            return false;
+        b = src[ip++];
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+}
+
+void compressBlock(const char *src_, size_t n, std::vector<char> &dst);
+void compressBlock(const char *src_, size_t n, std::vector<char> &dst) {
+    auto src = reinterpret_cast<uint8_t const *>(src_);
+    size_t anchor = 0;
+
+    auto emit = [&] (size_t litEnd, size_t matchLen, size_t offset) {
+        size_t litLen = litEnd - anchor;
+        uint8_t token = (uint8_t)(std::min<size_t>(litLen, 15) << 4);
+        if (matchLen)
+            token |= (uint8_t)std::min<size_t>(matchLen - kMinMatch, 15);
+        dst.push_back((char)token);
+        if (litLen >= 15)
+            writeLength(dst, litLen - 15);
+        dst.insert(dst.end(), src_ + anchor, src_ + litEnd);
+        if (matchLen) {
+            dst.push_back((char)(offset & 0xff));
+            dst.push_back((char)(offset >> 8));
+            if (matchLen - kMinMatch >= 15)
+                writeLength(dst, matchLen - kMinMatch - 15);
+        }
+    };
+
+    if (n >= kMatchFindLimit) {
+        std::vector<uint32_t> table(std::size_t(1) << kHashLog, 0);
+        size_t limit = n - kMatchFindLimit;
+        size_t ip = 1;
+        while (ip < limit) {
+            uint32_t seq = read32(src + ip);
+            auto &slot = table[hash32(seq)];
+            size_t cand = slot;
+            slot = (uint32_t)ip;
+            if (cand < ip && ip - cand <= kMaxOffset && read32(src + cand) == seq) {
+                size_t len = kMinMatch;
+                size_t maxLen = n - kLastLiterals - ip;
+                while (len < maxLen && src[cand + len] == src[ip + len])
+                    len++;
+                emit(ip, len, ip - cand);
+                ip += len;
+                anchor = ip;
+            } else {
+                // skip faster through incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+            }
+        }
+    }
+    emit(n, 0, 0);
+}
+
+bool decompressBlock(const char *src_, size_t n, char *dst, size_t rawsize);
+bool decompressBlock(const char *src_, size_t n, char *dst, size_t rawsize) {
+    auto src = reinterpret_cast<uint8_t const *>(src_);
+    size_t ip = 0, op = 0;
+    while (ip < n) {
+        uint8_t token = src[ip++];
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !readLength(src, n, ip, litLen))
+            return false;
+        if (litLen > n - ip || litLen > rawsize - op)
+            return false;
+        std::memcpy(dst + op, src + ip, litLen);
+        ip += litLen;
+        op += litLen;
+        if (ip == n)
+            break;
+
+        if (n - ip < 2)
+            return false;
+        size_t offset = src[ip] | (size_t)src[ip + 1] << 8;
+        ip += 2;
+        size_t matchLen = token & 15;
+        if (matchLen == 15 && !readLength(src, n, ip, matchLen))
+            return false;
+        matchLen += kMinMatch;
+        if (!offset || offset > op || matchLen > rawsize - op)
+            return false;
+        if (offset >= matchLen) {
+            std::memcpy(dst + op, dst + op - offset, matchLen);
+        } else {
+            for (size_t i = 0; i < matchLen; i++)
+                dst[op + i] = dst[op - offset + i];
+        }
+        op += matchLen;
+    }
+    return op == rawsize;
+}
+
+}
+
+}
@@ -6,10 +6,18 @@
 //#include <zeno/utils/zeno_p.h>
 #include <algorithm>
 #include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <limits>
 namespace zeno {
 
 namespace _implObjectCodec {
 
+void compressBlock(const char *src, size_t n, std::vector<char> &dst);
+bool decompressBlock(const char *src, size_t n, char *dst, size_t rawsize);
+ObjectCodecOptions const *currentEncodeOptions();
+const char *currentDecodeEnd();
+
 namespace {
 
 struct AttributeHeader {
@@ -24,30 +32,292 @@ struct AttrVectorHeader {
     size_t nattrs;
 };
 
-template <class T0, class It>
-void decodeAttrVector(AttrVector<T0> &arr, It &it) {
+template <class T0>
+bool decodeAttrVector(AttrVector<T0> &arr, const char *&it, const char *end) {
     AttrVectorHeader header;
+    if ((size_t)(end - it) < sizeof(header))
+        return false;
     std::copy_n(it, sizeof(header), (char *)&header);
     it += sizeof(header);
-    arr.values.reserve(header.size);
-    std::copy_n((T0 const *)it, header.size, std::back_inserter(arr.values));
+    if (header.size > (size_t)(end - it) / sizeof(T0))
+        return false;
+    arr.values.assign((T0 const *)it, (T0 const *)it + header.size);
     it += sizeof(T0) * header.size;
 
-    for (int a = 0; a < header.nattrs; a++) {
+    for (size_t a = 0; a < header.nattrs; a++) {
         AttributeHeader h;
+        if ((size_t)(end - it) < sizeof(h))
+            return false;
         std::copy_n(it, sizeof(h), (char *)&h);
         it += sizeof(h);
-        std::string key{h.name, h.namelen};
+        if (h.type >= std::variant_size_v<AttrAcceptAll>)
+            return false;
+        std::string key{h.name, std::min(h.namelen, sizeof(h.name))};
+        bool ok = true;
         index_switch<std::variant_size_v<AttrAcceptAll>>((size_t)h.type, [&] (auto type) {
             using T = std::variant_alternative_t<type.value, AttrAcceptAll>;
+            if (h.size > (size_t)(end - it) / sizeof(T)) {
+                ok = false;
+                return;
+            }
             auto &attr = arr.template add_attr<T>(key);
-            attr.clear();
-            attr.reserve(h.size);
-            std::copy_n((T const *)it, h.size, std::back_inserter(attr));
+            attr.assign((T const *)it, (T const *)it + h.size);
             it += sizeof(T) * h.size;
         });
+        if (!ok)
+            return false;
+        if (h.size != header.size)
+            log_warn("primitive attribute {} has {} elements, resized to {}", key, h.size, header.size);
     }
+    // pads or truncates attributes written with a different length, like before
     arr.update();
+    return true;
+}
+
+// compressed primitives start with this in place of the first AttrVectorHeader
+constexpr size_t kCompressedMarker = ~(size_t)0;
+constexpr size_t kCompressedVersion = 1;
+
+enum class BlockCodec : uint8_t {
+    Raw = 0,
+    Shuffle = 1,       // byte planes of 4-byte components, for floats
+    DeltaShuffle = 2,  // zigzag delta against the previous element, for int topology
+    Quantize = 3,      // positions as N-bit integers within the bbox, then byte planes
+};
+
+struct BlockHeader {
+    uint8_t codec;
+    uint8_t lz;
+    uint8_t bits;
+    uint8_t padding = 0;
+    uint32_t dim;
+    uint64_t count;
+    uint64_t nbytes;
+    float bmin[3];
+    float bmax[3];
+};
+
+// all AttrAcceptAll types are made of 4-byte components
+void shuffleBytes(const char *src, size_t nwords, char *dst) {
+    for (size_t w = 0; w < nwords; w++)
+        for (size_t b = 0; b < 4; b++)
+            dst[b * nwords + w] = src[w * 4 + b];
+}
+
+void unshuffleBytes(const char *src, size_t nwords, char *dst) {
+    for (size_t w = 0; w < nwords; w++)
+        for (size_t b = 0; b < 4; b++)
+            dst[w * 4 + b] = src[b * nwords + w];
+}
+
+template <class T>
+void encodeBlock(T const *data, size_t count, bool isPos, int positionBits, std::vector<char> &out) {
+    BlockHeader h{};
+    h.dim = sizeof(T) / 4;
+    h.count = count;
+    size_t nwords = count * h.dim;
+    std::vector<uint32_t> words(nwords);
+    std::memcpy(words.data(), data, nwords * 4);
+
+    if constexpr (std::is_same_v<T, vec3f>) {
+        if (isPos && positionBits > 0 && count) {
+            h.codec = (uint8_t)BlockCodec::Quantize;
+            h.bits = (uint8_t)std::clamp(positionBits, 1, 31);
+            vec3f bmin = data[0], bmax = data[0];
+            for (size_t i = 1; i < count; i++) {
+                bmin = zeno::min(bmin, data[i]);
+                bmax = zeno::max(bmax, data[i]);
+            }
+            float scale = float((1u << h.bits) - 1);
+            for (int c = 0; c < 3; c++) {
+                h.bmin[c] = bmin[c];
+                h.bmax[c] = bmax[c];
+            }
+            for (size_t i = 0; i < count; i++) {
+                for (int c = 0; c < 3; c++) {
+                    float ext = bmax[c] - bmin[c];
+                    float t = ext > 0 ? (data[i][c] - bmin[c]) / ext : 0.f;
+                    words[i * 3 + c] = (uint32_t)std::lround(std::clamp(t, 0.f, 1.f) * scale);
+                }
+            }
+        }
+    }
+    if (!h.codec) {
+        if constexpr (std::is_same_v<T, int> || std::is_same_v<T, vec2i> || std::is_same_v<T, vec3i> || std::is_same_v<T, vec4i>) {
+            // integer vectors: consecutive faces share vertex indices
+            h.codec = (uint8_t)BlockCodec::DeltaShuffle;
+            for (size_t i = nwords; i-- > h.dim;) {
+                uint32_t d = words[i] - words[i - h.dim];
+                words[i] = (d << 1) ^ (0u - (d >> 31));
+            }
+            for (size_t i = 0; i < std::min<size_t>(h.dim, nwords); i++) {
+                uint32_t d = words[i];
+                words[i] = (d << 1) ^ (0u - (d >> 31));
+            }
+        } else {
+            h.codec = (uint8_t)BlockCodec::Shuffle;
+        }
+    }
+
+    std::vector<char> planes(nwords * 4);
+    shuffleBytes((const char *)words.data(), nwords, planes.data());
+    std::vector<char> packed;
+    packed.reserve(planes.size() / 2);
+    compressBlock(planes.data(), planes.size(), packed);
+    if (packed.size() < planes.size()) {
+        h.lz = 1;
+        h.nbytes = packed.size();
+    } else {
+        h.lz = 0;
+        h.nbytes = planes.size();
+    }
+    out.insert(out.end(), (char const *)&h, (char const *)(&h + 1));
+    auto const &payload = h.lz ? packed : planes;
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool readChecked(const char *&it, const char *end, void *dst, size_t n) {
+    if ((size_t)(end - it) < n)
+        return false;
+    std::memcpy(dst, it, n);
+    it += n;
+    return true;
+}
+
+template <class T>
+bool decodeBlock(const char *&it, const char *end, std::vector<T> &arr) {
+    BlockHeader h;
+    if (!readChecked(it, end, &h, sizeof(h))) {
+        log_error("compressed primitive block header is truncated");
+        return false;
+    }
+    if (h.dim * 4 != sizeof(T)) {
+        log_error("compressed primitive block has mismatched element size");
+        return false;
+    }
+    if (h.nbytes > (size_t)(end - it)) {
+        log_error("compressed primitive block is truncated");
+        return false;
+    }
+    // an LZ sequence byte expands to at most 255 output bytes
+    if (h.count > std::numeric_limits<size_t>::max() / sizeof(T)
+        || h.count * sizeof(T) / 255 > h.nbytes + 1) {
+        log_error("compressed primitive block has bad element count");
+        return false;
+    }
+    if ((BlockCodec)h.codec == BlockCodec::Quantize && (h.dim != 3 || h.bits < 1 || h.bits > 31)) {
+        log_error("compressed primitive block has bad quantization");
+        return false;
+    }
+    size_t nwords = h.count * h.dim;
+    std::vector<char> planes;
+    const char *src = it;
+    if (h.lz) {
+        planes.resize(nwords * 4);
+        if (!decompressBlock(it, h.nbytes, planes.data(), planes.size())) {
+            log_error("compressed primitive block is broken");
+            return false;
+        }
+        src = planes.data();
+    } else if (h.nbytes != nwords * 4) {
+        log_error("compressed primitive block has bad size");
+        return false;
+    }
+    it += h.nbytes;
+
+    std::vector<uint32_t> words(nwords);
+    unshuffleBytes(src, nwords, (char *)words.data());
+    arr.resize(h.count);
+    switch ((BlockCodec)h.codec) {
+    case BlockCodec::Raw:
+    case BlockCodec::Shuffle:
+        break;
+    case BlockCodec::DeltaShuffle:
+        for (size_t i = 0; i < nwords; i++) {
+            uint32_t z = words[i];
+            words[i] = (z >> 1) ^ (0u - (z & 1));
+            if (i >= h.dim)
+                words[i] += words[i - h.dim];
+        }
+        break;
+    case BlockCodec::Quantize: {
+        float scale = float((1u << h.bits) - 1);
+        float *out = reinterpret_cast<float *>(arr.data());
+        for (size_t i = 0; i < nwords; i++) {
+            int c = i % 3;
+            out[i] = h.bmin[c] + (h.bmax[c] - h.bmin[c]) * (float(words[i]) / scale);
+        }
+        return true;
+    }
+    default:
+        log_error("unknown compressed primitive block codec {}", (int)h.codec);
+        return false;
+    }
+    std::memcpy(arr.data(), words.data(), nwords * 4);
+    return true;
+}
+
+template <class T0>
+void encodeAttrVectorCompressed(AttrVector<T0> const &arr, bool isVerts, int positionBits, std::vector<char> &out) {
+    AttrVectorHeader header;
+    header.size = arr.size();
+    header.nattrs = arr.template num_attrs<AttrAcceptAll>();
+    out.insert(out.end(), (char const *)&header, (char const *)(&header + 1));
+    encodeBlock(arr.data(), arr.size(), isVerts, positionBits, out);
+
+    arr.template foreach_attr<AttrAcceptAll>([&] (auto const &key, auto const &attr) {
+        using T = std::decay_t<decltype(attr[0])>;
+        uint32_t type = variant_index<AttrAcceptAll, T>::value;
+        uint32_t namelen = key.size();
+        out.insert(out.end(), (char const *)&type, (char const *)(&type + 1));
+        out.insert(out.end(), (char const *)&namelen, (char const *)(&namelen + 1));
+        out.insert(out.end(), key.begin(), key.end());
+        encodeBlock(attr.data(), attr.size(), false, 0, out);
+    });
+}
+
+template <class T0>
+bool decodeAttrVectorCompressed(AttrVector<T0> &arr, const char *&it, const char *end) {
+    AttrVectorHeader header;
+    if (!readChecked(it, end, &header, sizeof(header))) {
+        log_error("compressed primitive is truncated");
+        return false;
+    }
+    if (!decodeBlock(it, end, arr.values))
+        return false;
+    if (arr.values.size() != header.size) {
+        log_error("compressed primitive block does not match its array size");
+        return false;
+    }
+
+    for (size_t a = 0; a < header.nattrs; a++) {
+        uint32_t type, namelen;
+        if (!readChecked(it, end, &type, sizeof(type)) || !readChecked(it, end, &namelen, sizeof(namelen))
+            || namelen > (size_t)(end - it)) {
+            log_error("compressed primitive attribute header is truncated");
+            return false;
+        }
+        if (type >= std::variant_size_v<AttrAcceptAll>) {
+            log_error("compressed primitive attribute has unknown type {}", type);
+            return false;
+        }
+        std::string key{it, namelen};
+        it += namelen;
+        bool ok = true;
+        index_switch<std::variant_size_v<AttrAcceptAll>>((size_t)type, [&] (auto type) {
+            using T = std::variant_alternative_t<type.value, AttrAcceptAll>;
+            std::vector<T> attr;
+            ok = decodeBlock(it, end, attr);
+            if (ok && attr.size() != header.size)
+                log_warn("compressed primitive attribute {} has {} elements, resized to {}", key, attr.size(), header.size);
+            if (ok)
+                arr.attrs.assign(key, std::move(attr));
+        });
+        if (!ok)
+            return false;
+    }
+    arr.update();
+    return true;
 }
 
 template <class T0, class It>
@@ -72,18 +342,90 @@ void encodeAttrVector(AttrVector<T0> const &arr, It &it) {
 
 }
 
+static std::shared_ptr<PrimitiveObject> decodePrimitiveObjectCompressed(const char *it, const char *end) {
+    auto obj = std::make_shared<PrimitiveObject>();
+    it += sizeof(AttrVectorHeader);
+    bool ok = decodeAttrVectorCompressed(obj->verts, it, end)
+        && decodeAttrVectorCompressed(obj->points, it, end)
+        && decodeAttrVectorCompressed(obj->lines, it, end)
+        && decodeAttrVectorCompressed(obj->tris, it, end)
+        && decodeAttrVectorCompressed(obj->quads, it, end)
+        && decodeAttrVectorCompressed(obj->loops, it, end)
+        && decodeAttrVectorCompressed(obj->polys, it, end)
+        && decodeAttrVectorCompressed(obj->edges, it, end)
+        && decodeAttrVectorCompressed(obj->uvs, it, end);
+    if (!ok)
+        return nullptr;
+    if (it == end) {
+        log_error("compressed primitive is truncated");
+        return nullptr;
+    }
+    if (*it++ == '1') {
+        obj->mtl = std::make_shared<MaterialObject>();
+        obj->mtl->deserialize(it);
+    }
+    return obj;
+}
+
+static bool encodePrimitiveObjectCompressed(PrimitiveObject const *obj, int positionBits, std::back_insert_iterator<std::vector<char>> it) {
+    std::vector<char> out;
+    AttrVectorHeader marker;
+    marker.size = kCompressedMarker;
+    marker.nattrs = kCompressedVersion;
+    out.insert(out.end(), (char const *)&marker, (char const *)(&marker + 1));
+    encodeAttrVectorCompressed(obj->verts, true, positionBits, out);
+    encodeAttrVectorCompressed(obj->points, false, 0, out);
+    encodeAttrVectorCompressed(obj->lines, false, 0, out);
+    encodeAttrVectorCompressed(obj->tris, false, 0, out);
+    encodeAttrVectorCompressed(obj->quads, false, 0, out);
+    encodeAttrVectorCompressed(obj->loops, false, 0, out);
+    encodeAttrVectorCompressed(obj->polys, false, 0, out);
+    encodeAttrVectorCompressed(obj->edges, false, 0, out);
+    encodeAttrVectorCompressed(obj->uvs, false, 0, out);
+    it = std::copy(out.begin(), out.end(), it);
+    if (obj->mtl) {
+        *it++ = '1';
+        for (char c: obj->mtl->serialize())
+            *it++ = c;
+    } else {
+        *it++ = '0';
+    }
+    return true;
+}
+
 std::shared_ptr<PrimitiveObject> decodePrimitiveObject(const char *it);
 std::shared_ptr<PrimitiveObject> decodePrimitiveObject(const char *it) {
+    // every length and count read from the data is checked against the input
+    // before anything is allocated or copied
+    auto end = currentDecodeEnd();
+    AttrVectorHeader first;
+    if (!end || (size_t)(end - it) < sizeof(first)) {
+        log_error("primitive is truncated");
+        return nullptr;
+    }
+    std::memcpy(&first, it, sizeof(first));
+    if (first.size == kCompressedMarker) {
+        if (first.nattrs != kCompressedVersion) {
+            log_error("unsupported compressed primitive version {}", first.nattrs);
+            return nullptr;
+        }
+        return decodePrimitiveObjectCompressed(it, end);
+    }
+
     auto obj = std::make_shared<PrimitiveObject>();
-    decodeAttrVector(obj->verts, it);
-    decodeAttrVector(obj->points, it);
-    decodeAttrVector(obj->lines, it);
-    decodeAttrVector(obj->tris, it);
-    decodeAttrVector(obj->quads, it);
-    decodeAttrVector(obj->loops, it);
-    decodeAttrVector(obj->polys, it);
-    decodeAttrVector(obj->edges, it);
-    decodeAttrVector(obj->uvs, it);
+    bool ok = decodeAttrVector(obj->verts, it, end)
+        && decodeAttrVector(obj->points, it, end)
+        && decodeAttrVector(obj->lines, it, end)
+        && decodeAttrVector(obj->tris, it, end)
+        && decodeAttrVector(obj->quads, it, end)
+        && decodeAttrVector(obj->loops, it, end)
+        && decodeAttrVector(obj->polys, it, end)
+        && decodeAttrVector(obj->edges, it, end)
+        && decodeAttrVector(obj->uvs, it, end);
+    if (!ok || it == end) {
+        log_error("primitive is truncated or corrupted");
+        return nullptr;
+    }
     if (*it++ == '1') {
         obj->mtl = std::make_shared<MaterialObject>();
         obj->mtl->deserialize(it);
@@ -93,6 +435,9 @@ std::shared_ptr<PrimitiveObject> decodePrimitiveObject(const char *it) {
 
 bool encodePrimitiveObject(PrimitiveObject const *obj, std::back_insert_iterator<std::vector<char>> it);
 bool encodePrimitiveObject(PrimitiveObject const *obj, std::back_insert_iterator<std::vector<char>> it) {
+    if (auto opts = currentEncodeOptions(); opts && (opts->compress || opts->positionBits > 0))
+        return encodePrimitiveObjectCompressed(obj, opts->positionBits, it);
+
     encodeAttrVector(obj->verts, it);
     encodeAttrVector(obj->points, it);
     encodeAttrVector(obj->lines, it);
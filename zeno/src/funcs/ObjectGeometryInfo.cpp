@@ -1,6 +1,8 @@
 #include <zeno/funcs/ObjectGeometryInfo.h>
 #include <zeno/types/PrimitiveObject.h>
 #include <zeno/funcs/PrimitiveTools.h>
+#include <zeno/types/ListObject.h>
+#include <zeno/types/DictObject.h>
 #include <zeno/types/UserData.h>
 
 namespace zeno {
@@ -35,4 +37,41 @@ ZENO_API bool objectGetFocusCenterRadius(IObject *ptr, vec3f &center, float &rad
     return true;
 }
 
+namespace {
+
+template <class T>
+std::size_t attrVectorBytes(AttrVector<T> const &arr) {
+    std::size_t bytes = arr.values.size() * sizeof(T);
+    arr.template foreach_attr<AttrAcceptAll>([&] (auto const &key, auto const &val) {
+        bytes += val.size() * sizeof(val[0]);
+    });
+    return bytes;
+}
+
+}
+
+ZENO_API void objectGetMemoryStats(IObject *ptr, ObjectMemoryStats &stats) {
+    if (!ptr)
+        return;
+    if (auto prim = dynamic_cast<PrimitiveObject *>(ptr)) {
+        stats.bytes += attrVectorBytes(prim->verts);
+        stats.bytes += attrVectorBytes(prim->points);
+        stats.bytes += attrVectorBytes(prim->lines);
+        stats.bytes += attrVectorBytes(prim->tris);
+        stats.bytes += attrVectorBytes(prim->quads);
+        stats.bytes += attrVectorBytes(prim->loops);
+        stats.bytes += attrVectorBytes(prim->polys);
+        stats.bytes += attrVectorBytes(prim->edges);
+        stats.bytes += attrVectorBytes(prim->uvs);
+        stats.verts += prim->verts.size();
+        stats.faces += prim->tris.size() + prim->quads.size() + prim->polys.size();
+    } else if (auto lst = dynamic_cast<ListObject *>(ptr)) {
+        for (auto const &elm: lst->arr)
+            objectGetMemoryStats(elm.get(), stats);
+    } else if (auto dct = dynamic_cast<DictObject *>(ptr)) {
+        for (auto const &[key, elm]: dct->lut)
+            objectGetMemoryStats(elm.get(), stats);
+    }
+}
+
 }
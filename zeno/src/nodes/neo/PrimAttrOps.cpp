@@ -14,7 +14,7 @@ struct PrimFillAttr : INode {
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
         auto value = get_input<NumericObject>("value");
-        auto attr = get_input2<std::string>("attr");
+        AttrKey attr(get_input2<std::string>("attr"));
         auto type = get_input2<std::string>("type");
         std::visit([&] (auto ty) {
             using T = decltype(ty);
@@ -71,16 +71,16 @@ ZENDEFNODE(PrimFillColor, {
 struct PrimFloatAttrToInt : INode {
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
-        auto attr = get_input2<std::string>("attr");
-        auto attrOut = get_input2<std::string>("attrOut");
-        auto &inArr = prim->verts.attr<float>(attr);
+        AttrKey attr(get_input2<std::string>("attr"));
+        AttrKey attrOut(get_input2<std::string>("attrOut"));
+        auto &inArr = std::as_const(prim->verts).attr<float>(attr);
         auto factor = get_input2<float>("divisor");
         if (attrOut == attr) {
             std::vector<int> outArr(inArr.size());
             parallel_for(inArr.size(), [&] (size_t i) {
                 outArr[i] = std::rint(inArr[i] * factor);
             });
-            prim->verts.attrs.erase(attrOut);
+            prim->verts.erase_attr(attrOut);
             prim->verts.add_attr<int>(attrOut) = std::move(outArr);
         } else {
             auto &outArr = prim->verts.add_attr<int>(attrOut);
@@ -110,9 +110,9 @@ ZENDEFNODE(PrimFloatAttrToInt, {
 struct PrimIntAttrToFloat : INode {
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
-        auto attr = get_input2<std::string>("attr");
-        auto attrOut = get_input2<std::string>("attrOut");
-        auto &inArr = prim->verts.attr<int>(attr);
+        AttrKey attr(get_input2<std::string>("attr"));
+        AttrKey attrOut(get_input2<std::string>("attrOut"));
+        auto &inArr = std::as_const(prim->verts).attr<int>(attr);
         auto factor = get_input2<float>("divisor");
         if (factor) factor = 1.0f / factor;
         if (attrOut == attr) {
@@ -120,7 +120,7 @@ struct PrimIntAttrToFloat : INode {
             parallel_for(inArr.size(), [&] (size_t i) {
                 outArr[i] = float(inArr[i]) * factor;
             });
-            prim->verts.attrs.erase(attrOut);
+            prim->verts.erase_attr(attrOut);
             prim->verts.add_attr<float>(attrOut) = std::move(outArr);
         } else {
             auto &outArr = prim->verts.add_attr<float>(attrOut);
@@ -156,7 +156,7 @@ struct PrimAttrInterp : INode {
         auto facAttr = get_input2<std::string>("facAttr");
         auto facAcc = functor_variant(facAttr.empty() ? 1 : 0,
                                       [&, &facAttr = facAttr] {
-                                          auto &facArr = prim->verts.attr<float>(facAttr);
+                                          auto &facArr = std::as_const(prim->verts).attr<float>(facAttr);
                                           return [&] (size_t i) {
                                               return facArr[i];
                                           };
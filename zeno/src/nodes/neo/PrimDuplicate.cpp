@@ -169,6 +169,8 @@ ZENO_API std::shared_ptr<PrimitiveObject> primDuplicate(PrimitiveObject *parsPri
 namespace {
 
 struct PrimDuplicate : INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto parsPrim = get_input<PrimitiveObject>("parsPrim");
         auto meshPrim = get_input<PrimitiveObject>("meshPrim");
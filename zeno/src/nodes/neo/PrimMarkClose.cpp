@@ -1,14 +1,135 @@
 #include <zeno/zeno.h>
 #include <zeno/types/PrimitiveObject.h>
-#include <zeno/types/PrimitiveUtils.h>
+#include <zeno/funcs/PrimitiveUtils.h>
 #include <zeno/types/StringObject.h>
 #include <zeno/types/NumericObject.h>
-#include <zeno/utils/tuple_hash.h>
 #include <zeno/para/parallel_for.h>
+#include <zeno/para/parallel_reduce.h>
+#include <zeno/para/parallel_scan.h>
+#include <zeno/para/parallel_radix_sort.h>
 #include <zeno/utils/log.h>
-#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 namespace zeno {
+
+// tag every point with the id of its cluster, clusters are the connected parts
+// of the "closer than distance" graph; ids are compact and numbered in the
+// order of the lowest point index of each cluster. returns the cluster count
+ZENO_API int primMarkClose(PrimitiveObject *prim, std::string tagAttr, float distance) {
+    auto const &pos = prim->verts.values;
+    int n = pos.size();
+    auto &tag = prim->verts.add_attr<int>(tagAttr);
+    if (!n)
+        return 0;
+
+    // bin the points into cells of size distance, sorted by cell key
+    auto bbox = parallel_reduce_minmax(pos.begin(), pos.end());
+    vec3f bmin = bbox.first, bmax = bbox.second;
+    float dx = std::max(distance, std::max({bmax[0] - bmin[0], bmax[1] - bmin[1], bmax[2] - bmin[2]}) * (1.f / (1 << 20)));
+    if (!(dx > 0))
+        dx = 1;
+    float invdx = 1 / dx;
+    // cells beyond 2^21 are merged into the last one, which only costs speed
+    auto cellOf = [&] (vec3f const &p) {
+        return zeno::min(toint(floor((p - bmin) * invdx)), vec3i((1 << 21) - 1));
+    };
+    auto keyOf = [] (vec3i const &c) {
+        return (uint64_t)c[0] << 42 | (uint64_t)c[1] << 21 | (uint64_t)c[2];
+    };
+    std::vector<uint64_t> keys(n);
+    std::vector<int> order(n);
+    parallel_for(n, [&] (int i) {
+        keys[i] = keyOf(cellOf(pos[i]));
+        order[i] = i;
+    });
+    parallel_radix_sort(keys, order);
+
+    std::vector<int> cellId(n);
+    int ncells = parallel_exclusive_scan(0, n, cellId.begin(), 0, std::plus<int>(), [&] (int k) {
+        return k == 0 || keys[k] != keys[k - 1] ? 1 : 0;
+    });
+    std::vector<uint64_t> cellKey(ncells);
+    std::vector<int> cellStart(ncells + 1);
+    parallel_for(n, [&] (int k) {
+        if (k == 0 || keys[k] != keys[k - 1]) {
+            cellKey[cellId[k]] = keys[k];
+            cellStart[cellId[k]] = k;
+        }
+    });
+    cellStart[ncells] = n;
+
+    // lock-free union-find, roots are always linked to the smaller index so
+    // every cluster ends up rooted at its lowest point whatever the order was
+    std::vector<std::atomic<int>> parent(n);
+    parallel_for(n, [&] (int i) {
+        parent[i].store(i, std::memory_order_relaxed);
+    });
+    auto find = [&] (int x) {
+        while (true) {
+            int p = parent[x].load(std::memory_order_relaxed);
+            if (p == x)
+                return x;
+            int gp = parent[p].load(std::memory_order_relaxed);
+            if (gp != p)
+                parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    };
+    auto unite = [&] (int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return;
+            if (a < b)
+                std::swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+                return;
+        }
+    };
+
+    // every pair is found from the point with the lower index, in the 27 cells around it
+    float dist2 = distance * distance;
+    parallel_for(ncells, [&] (int c) {
+        vec3i xyz((int)(cellKey[c] >> 42), (int)(cellKey[c] >> 21 & 0x1fffff), (int)(cellKey[c] & 0x1fffff));
+        for (int oz = -1; oz <= 1; oz++) for (int oy = -1; oy <= 1; oy++) for (int ox = -1; ox <= 1; ox++) {
+            vec3i nxyz = xyz + vec3i(ox, oy, oz);
+            if (nxyz[0] < 0 || nxyz[1] < 0 || nxyz[2] < 0 || nxyz[0] >= (1 << 21) || nxyz[1] >= (1 << 21) || nxyz[2] >= (1 << 21))
+                continue;
+            auto it = std::lower_bound(cellKey.begin(), cellKey.end(), keyOf(nxyz));
+            if (it == cellKey.end() || *it != keyOf(nxyz))
+                continue;
+            int nc = it - cellKey.begin();
+            for (int a = cellStart[c]; a < cellStart[c + 1]; a++) {
+                int i = order[a];
+                for (int b = cellStart[nc]; b < cellStart[nc + 1]; b++) {
+                    int j = order[b];
+                    if (i < j && lengthSquared(pos[i] - pos[j]) <= dist2)
+                        unite(i, j);
+                }
+            }
+        }
+    });
+
+    // number the roots in index order
+    std::vector<int> root(n);
+    parallel_for(n, [&] (int i) {
+        root[i] = find(i);
+    });
+    std::vector<int> rootId(n);
+    int nclusters = parallel_exclusive_scan(0, n, rootId.begin(), 0, std::plus<int>(), [&] (int i) {
+        return root[i] == i ? 1 : 0;
+    });
+    parallel_for(n, [&] (int i) {
+        tag[i] = rootId[root[i]];
+    });
+    return nclusters;
+}
+
 namespace {
 
 struct PrimMarkClose : INode {
@@ -17,28 +138,8 @@ struct PrimMarkClose : INode {
         auto tagAttr = get_input<StringObject>("tagAttr")->get();
         float distance = get_input<NumericObject>("distance")->get<float>();
 
-        float factor = 1.0f / distance;
-        std::unordered_multimap<vec3i, int, tuple_hash, tuple_equal> lut;
-        lut.reserve(prim->verts.size());
-        for (int i = 0; i < prim->verts.size(); i++) {
-            vec3f pos = prim->verts[i];
-            vec3i posi = vec3i(floor(pos * factor));
-            lut.emplace(posi, i);
-        }
-
-        auto &tag = prim->verts.add_attr<int>(tagAttr);
-        if (lut.size()) {
-            int cnt = 0;
-            auto last_key = lut.begin()->first;
-            for (auto const &[key, idx]: lut) {
-                if (!tuple_equal{}(last_key, key)) {
-                    ++cnt;
-                    last_key = key;
-                }
-                tag[idx] = cnt;
-            }
-            zeno::log_info("PrimMarkClose: collapse from {} to {}", prim->verts.size(), cnt + 1);
-        }
+        int cnt = primMarkClose(prim.get(), tagAttr, distance);
+        zeno::log_info("PrimMarkClose: collapse from {} to {}", prim->verts.size(), cnt);
 
         set_output("prim", std::move(prim));
     }
@@ -59,6 +160,80 @@ ZENDEFNODE(PrimMarkClose, {
     {"primitive"},
 });
 
+// times primMarkClose on a user prim, optionally checking it against the O(n^2)
+// pairwise clustering; the regression test is projects/PBD/test/test_PrimMarkClose.cpp
+struct PrimMarkCloseBenchmark : INode {
+    virtual void apply() override {
+        auto prim = get_input<PrimitiveObject>("prim");
+        float distance = get_input2<float>("distance");
+        int iterations = std::max(get_input2<int>("iterations"), 1);
+
+        using clock = std::chrono::steady_clock;
+        auto test = std::make_shared<PrimitiveObject>(*prim);
+        auto t0 = clock::now();
+        int cnt = 0;
+        for (int it = 0; it < iterations; it++)
+            cnt = primMarkClose(test.get(), "weld", distance);
+        float ms = std::chrono::duration<float, std::milli>(clock::now() - t0).count() / iterations;
+
+        bool ok = true;
+        float refMs = 0;
+        if (get_input2<bool>("bruteForce")) {
+            auto const &pos = prim->verts.values;
+            int n = pos.size();
+            std::vector<int> found(n);
+            for (int i = 0; i < n; i++)
+                found[i] = i;
+            auto find = [&] (int i) {
+                while (i != found[i])
+                    i = found[i] = found[found[i]];
+                return i;
+            };
+            t0 = clock::now();
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    if (lengthSquared(pos[i] - pos[j]) <= distance * distance) {
+                        int a = find(i), b = find(j);
+                        found[std::max(a, b)] = std::min(a, b);
+                    }
+                }
+            }
+            refMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+            // both number the clusters in order of their lowest point
+            std::vector<int> refTag(n);
+            int refCnt = 0;
+            for (int i = 0; i < n; i++)
+                refTag[i] = find(i) == i ? refCnt++ : refTag[find(i)];
+            ok = refCnt == cnt && refTag == test->verts.attr<int>("weld");
+            if (!ok)
+                log_error("PrimMarkCloseBenchmark: {} clusters, brute force gives {}", cnt, refCnt);
+        }
+        log_info("PrimMarkCloseBenchmark: {} points, {} clusters, {} ms (brute force {} ms)",
+                 prim->verts.size(), cnt, ms, refMs);
+
+        set_output2("time", ms);
+        set_output2("bruteForceTime", refMs);
+        set_output2("ok", ok);
+    }
+};
+
+ZENDEFNODE(PrimMarkCloseBenchmark, {
+    {
+    {"PrimitiveObject", "prim"},
+    {"float", "distance", "0.01"},
+    {"int", "iterations", "10"},
+    {"bool", "bruteForce", "1"},
+    },
+    {
+    {"float", "time"},
+    {"float", "bruteForceTime"},
+    {"bool", "ok"},
+    },
+    {
+    },
+    {"debug"},
+});
+
 struct PrimMarkSameIf : INode {
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
@@ -496,27 +496,21 @@ struct PrimMerge : INode {
             {
                 //for p's tris, quads...
                 //    tris("matid")[i] += matNameList.size();
-                for(int i=0; i<p->tris.size();i++)
-                {
-                    if(p->tris.attr<int>("matid")[i] != -1)
-                    {
-                        p->tris.attr<int>("matid")[i] += matNameList.size();
-                    }
-                }
-                for(int i=0; i<p->quads.size();i++)
-                {
-                    if(p->quads.attr<int>("matid")[i] != -1)
+                auto offsetMatid = [&] (auto &faces) {
+                    if (!faces.size())
+                        return;
+                    auto &matid = faces.template attr<int>("matid");
+                    for(int i=0; i<faces.size();i++)
                     {
-                        p->quads.attr<int>("matid")[i] += matNameList.size();
-                    }
-                }
-                for(int i=0; i<p->polys.size();i++)
-                {
-                    if(p->polys.attr<int>("matid")[i]!=-1)
-                    {
-                        p->polys.attr<int>("matid")[i] += matNameList.size();
-                    }
-                }
+                        if(matid[i] != -1)
+                        {
+                            matid[i] += matNameList.size();
+                        }
+                    }
+                };
+                offsetMatid(p->tris);
+                offsetMatid(p->quads);
+                offsetMatid(p->polys);
                 //for p's materials
                 //    add them to material list
                 for(int i=0;i<matNum;i++)
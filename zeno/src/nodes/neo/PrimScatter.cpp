@@ -89,6 +89,8 @@ ZENO_API std::shared_ptr<PrimitiveObject> primScatter(
     bool hasDenAttr = !denAttr.empty();
     TICK(scatter);
     
+    // looked up once, the scans below run in parallel
+    std::vector<float> const *denArr = hasDenAttr ? &std::as_const(prim->verts).attr<float>(denAttr) : nullptr;
     std::vector<float> cdf;
     if (type == "tris") {
         if (!prim->tris.size()) return retprim;
@@ -99,7 +101,7 @@ ZENO_API std::shared_ptr<PrimitiveObject> primScatter(
             auto c = prim->verts[ind[2]];
             auto area = length(cross(c - a, c - b));
             if (hasDenAttr) {
-                auto &den = prim->verts.attr<float>(denAttr);
+                auto &den = *denArr;
                 auto da = den[ind[0]];
                 auto db = den[ind[1]];
                 auto dc = den[ind[2]];
@@ -115,7 +117,7 @@ ZENO_API std::shared_ptr<PrimitiveObject> primScatter(
             auto b = prim->lines[ind[1]];
             auto area = length(a - b);
             if (hasDenAttr) {
-                auto &den = prim->verts.attr<float>(denAttr);
+                auto &den = *denArr;
                 auto da = den[ind[0]];
                 auto db = den[ind[1]];
                 area *= std::abs(da + db) / 2;
@@ -209,6 +211,8 @@ ZENO_API std::shared_ptr<PrimitiveObject> primScatter(
 namespace {
 
 struct PrimScatter : INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
         auto type = get_input2<std::string>("type");
@@ -217,6 +221,9 @@ struct PrimScatter : INode {
         auto minRadius = get_input2<float>("minRadius");
         auto interpAttrs = get_input2<bool>("interpAttrs");
         auto seed = get_input2<int>("seed");
+        // seed -1 draws a new one every time, like reading global state
+        if (seed == -1)
+            touchedGlobals = true;
         auto retprim = primScatter(prim.get(), type, denAttr, density, minRadius, interpAttrs, seed);
         set_output("parsPrim", retprim);
     }
@@ -3,80 +3,65 @@
 #include <zeno/funcs/PrimitiveUtils.h>
 #include <zeno/types/StringObject.h>
 #include <zeno/types/NumericObject.h>
-#include <unordered_map>
+#include <zeno/para/parallel_for.h>
+#include <zeno/para/parallel_scan.h>
+#include <zeno/para/parallel_radix_sort.h>
+#include <functional>
 #include <algorithm>
 
 namespace zeno {
 namespace {
 
-template <class T>
-static void revamp_vector(std::vector<T> &arr, std::vector<int> const &revamp) {
-    std::vector<T> newarr(arr.size());
-    for (int i = 0; i < revamp.size(); i++) {
-        newarr[i] = arr[revamp[i]];
-    }
-    std::swap(arr, newarr);
-}
-
 struct PrimWeld : INode {
     virtual void apply() override {
         auto prim = get_input<PrimitiveObject>("prim");
         auto tagAttr = get_input<StringObject>("tagAttr")->get();
         auto isAverage = get_input<StringObject>("method")->get() == "average";
 
-        std::unordered_multimap<int, int> lut;
-        auto &tag = prim->verts.attr<int>(tagAttr);
-        for (int i = 0; i < prim->size(); i++) {
-            lut.insert({tag[i], i});
-        }
-        std::vector<int> revamp;
-        std::vector<int> unrevamp(prim->size());
-        revamp.resize(lut.size());
-        int nrevamp = 0;
-        for (auto it = lut.begin(); it != lut.end();) {
-            auto nit = std::find_if(std::next(it), lut.end(), [val = it->first] (auto const &p) {
-                return p.first != val;
-            });
-            auto start = it->second;
-            if (isAverage) {
-                vec3f average = prim->verts[start];
-                int count = 1;
-                for (++it; it != nit; ++it) {
-                    unrevamp[it->second] = nrevamp;
-                    auto pos = prim->verts[it->second];
-                    average += pos;
-                    ++count;
-                }
-                average *= 1 / (float)count;
-                prim->verts[start] = average;
-            } else {
-                for (; it != nit; ++it) {
-                    //printf("(%d) %d -> %d\n", it->first, it->second, nrevamp);
-                    unrevamp[it->second] = nrevamp;
-                    // unrevamp[old_coor] = new_coor
-                }
-            }
-            revamp[nrevamp] = start;
-            ++nrevamp;
-        }
-        revamp.resize(nrevamp);
-        //primRevampVerts(prim.get(), revamp, &unrevamp);
+        // sort the points by tag, equal tags keep their index order
+        int n = prim->size();
+        auto const &tag = prim->verts.attr<int>(tagAttr);
+        std::vector<uint32_t> keys(n);
+        std::vector<int> order(n);
+        parallel_for(n, [&] (int i) {
+            keys[i] = (uint32_t)tag[i] ^ 0x80000000u;
+            order[i] = i;
+        });
+        parallel_radix_sort(keys, order);
 
-        revamp_vector(prim->verts.values, revamp);
-        if (isAverage) {
-            prim->verts.foreach_attr<AttrAcceptAll>([&] (auto const &key, auto &arr) {
-                using T = std::decay_t<decltype(arr[0])>;
-                std::vector<T> new_arr(nrevamp);
-                for (size_t i = 0; i < arr.size(); i++) {
-                    new_arr[unrevamp[i]] += arr[i] / (T)lut.count(i);
+        // each run of equal tags is one new point, numbered by prefix sum
+        std::vector<int> group(n);
+        int nrevamp = parallel_exclusive_scan(0, n, group.begin(), 0, std::plus<int>(), [&] (int k) {
+            return k == 0 || keys[k] != keys[k - 1] ? 1 : 0;
+        });
+        std::vector<int> groupStart(nrevamp + 1);
+        std::vector<int> unrevamp(n);
+        parallel_for(n, [&] (int k) {
+            if (k == 0 || keys[k] != keys[k - 1])
+                groupStart[group[k]] = k;
+            // unrevamp[old_coor] = new_coor
+            unrevamp[order[k]] = group[k];
+        });
+        groupStart[nrevamp] = n;
+        keys = {};
+
+        prim->verts.forall_attr<AttrAcceptAll>([&] (auto const &key, auto &arr) {
+            using T = std::decay_t<decltype(arr[0])>;
+            std::vector<T> new_arr(nrevamp);
+            parallel_for(nrevamp, [&] (int g) {
+                int b = groupStart[g], e = groupStart[g + 1];
+                if (isAverage) {
+                    T sum = arr[order[b]];
+                    for (int k = b + 1; k < e; k++)
+                        sum += arr[order[k]];
+                    new_arr[g] = sum / (T)(e - b);
+                } else {
+                    // keep the lowest indexed point of each group
+                    new_arr[g] = arr[order[b]];
                 }
-                arr = std::move(new_arr);
-            });
-        } else {
-            prim->verts.foreach_attr<AttrAcceptAll>([&] (auto const &key, auto &arr) {
-                revamp_vector(arr, revamp);
             });
-        }
+            arr = std::move(new_arr);
+        });
 
         auto repair = [&] (int &x) {
             //printf("%d -> %d\n", x, unrevamp[x]);
@@ -84,38 +69,38 @@ struct PrimWeld : INode {
                 x = unrevamp[x];
         };
 
-        for (size_t i = 0; i < prim->points.size(); i++) {
+        parallel_for(prim->points.size(), [&] (size_t i) {
             auto &ind = prim->points[i];
             repair(ind);
-        }
+        });
 
-        for (size_t i = 0; i < prim->lines.size(); i++) {
+        parallel_for(prim->lines.size(), [&] (size_t i) {
             auto &ind = prim->lines[i];
             repair(ind[0]);
             repair(ind[1]);
-        }
+        });
         prim->lines->erase(std::remove_if(prim->lines.begin(), prim->lines.end(), [&] (auto const &ind) {
             return ind[0] == ind[1];
         }), prim->lines.end());
         prim->lines.update();
 
-        for (size_t i = 0; i < prim->tris.size(); i++) {
+        parallel_for(prim->tris.size(), [&] (size_t i) {
             auto &ind = prim->tris[i];
             repair(ind[0]);
             repair(ind[1]);
             repair(ind[2]);
-        }
+        });
         prim->tris->erase(std::remove_if(prim->tris.begin(), prim->tris.end(), [&] (auto const &ind) {
             return ind[0] == ind[1] || ind[0] == ind[2] || ind[1] == ind[2];
         }), prim->tris.end());
 
-        for (size_t i = 0; i < prim->quads.size(); i++) {
+        parallel_for(prim->quads.size(), [&] (size_t i) {
             auto &ind = prim->quads[i];
             repair(ind[0]);
             repair(ind[1]);
             repair(ind[2]);
             repair(ind[3]);
-        }
+        });
         std::vector<uint8_t> ridquad(prim->quads.size());
         auto ridquadit = ridquad.begin();
         for (auto ind: prim->quads) {
@@ -134,10 +119,10 @@ struct PrimWeld : INode {
         }), prim->quads.end());
         prim->quads.update();
 
-        for (size_t i = 0; i < prim->loops.size(); i++) {
+        parallel_for(prim->loops.size(), [&] (size_t i) {
             auto &ind = prim->loops[i];
             repair(ind);
-        }
+        });
         for (auto &[base, len]: prim->polys) {
             auto bit = prim->loops.begin() + base;
             auto eit = prim->loops.begin() + (base + len);
@@ -124,6 +124,8 @@ std::shared_ptr<PrimitiveObject> parse_obj(std::vector<char> &&bin) {
 }
 
 struct ReadObjPrim : INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto path = get_input<StringObject>("path")->get();
         auto binary = file_get_binary<std::vector<char>>(path);
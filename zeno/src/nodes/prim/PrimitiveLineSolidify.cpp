@@ -103,7 +103,7 @@ struct PrimitiveLineSolidify : zeno::INode {
                     else
                         return std::false_type{};
                 }();
-prim->verts.add_attr<zeno::vec3f>("uv");
+auto &uv = prim->verts.add_attr<zeno::vec3f>("uv");
 #pragma omp parallel for
             for (intptr_t i = 0; i < n; i++) {
                 auto currpos = prim->verts[i];
@@ -114,7 +114,7 @@ prim->verts.add_attr<zeno::vec3f>("uv");
                     if constexpr (has_radius_attr.value)
                         offs *= radattr[i];
                     prim->verts[i + n * a] = currpos + offs;
-                    prim->verts.attr<zeno::vec3f>("uv")[i + n * a] = zeno::vec3f((float)a/(float)count, (float)i/(float)n, 0);
+                    uv[i + n * a] = zeno::vec3f((float)a/(float)count, (float)i/(float)n, 0);
                 }
             }
 
@@ -92,6 +92,8 @@ void read_obj_file(
 
 
 struct ReadObjPrimitive : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto path = get_input<zeno::StringObject>("path")->get();
         auto prim = std::make_shared<zeno::PrimitiveObject>();
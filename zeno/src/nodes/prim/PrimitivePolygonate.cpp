@@ -24,6 +24,7 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
     int polynum = prim->polys.size();
     if (prim->tris.size()) {
         int base = prim->loops.size();
+        auto const *tris_matid = tri_has_mat ? &prim->tris.attr<int>("matid") : nullptr;
         for (int i = 0; i < prim->tris.size(); i++) {
             auto const &ind = prim->tris[i];
             prim->loops.push_back(ind[0]);
@@ -31,7 +32,7 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
             prim->loops.push_back(ind[2]);
             prim->polys.push_back({base + i * 3, 3});
             if(tri_has_mat)
-                matid[polynum + i] = prim->tris.attr<int>("matid")[i];
+                matid[polynum + i] = (*tris_matid)[i];
         }
 
         prim->tris.foreach_attr([&](auto const &key, auto const &arr) {
@@ -44,6 +45,7 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
     polynum = prim->polys.size();
     if (prim->quads.size()) {
         int base = prim->loops.size();
+        auto const *quads_matid = quad_has_mat ? &prim->quads.attr<int>("matid") : nullptr;
         for (int i = 0; i < prim->quads.size(); i++) {
             auto const &ind = prim->quads[i];
             prim->loops.push_back(ind[0]);
@@ -52,7 +54,7 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
             prim->loops.push_back(ind[3]);
             prim->polys.push_back({base + i * 4, 4});
             if(quad_has_mat)
-                matid[polynum + i] = prim->quads.attr<int>("matid")[i];
+                matid[polynum + i] = (*quads_matid)[i];
         }
 
         prim->quads.foreach_attr([&](auto const &key, auto const &arr) {
@@ -99,14 +101,14 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
     if (!(!prim->tris.has_attr("uv0") || !prim->tris.has_attr("uv1") ||
           !prim->tris.has_attr("uv2") || !with_uv)) {
         auto old_uvs_base = prim->uvs.size();
-        prim->loops.add_attr<int>("uvs");
+        auto &loop_uvs = prim->loops.add_attr<int>("uvs");
         auto &uv0 = prim->tris.attr<vec3f>("uv0");
         auto &uv1 = prim->tris.attr<vec3f>("uv1");
         auto &uv2 = prim->tris.attr<vec3f>("uv2");
         for (int i = 0; i < prim->tris.size(); i++) {
-            prim->loops.attr<int>("uvs")[old_loop_base + i * 3 + 0] = old_uvs_base + i * 3 + 0;
-            prim->loops.attr<int>("uvs")[old_loop_base + i * 3 + 1] = old_uvs_base + i * 3 + 1;
-            prim->loops.attr<int>("uvs")[old_loop_base + i * 3 + 2] = old_uvs_base + i * 3 + 2;
+            loop_uvs[old_loop_base + i * 3 + 0] = old_uvs_base + i * 3 + 0;
+            loop_uvs[old_loop_base + i * 3 + 1] = old_uvs_base + i * 3 + 1;
+            loop_uvs[old_loop_base + i * 3 + 2] = old_uvs_base + i * 3 + 2;
             prim->uvs.emplace_back(uv0[i][0], uv0[i][1]);
             prim->uvs.emplace_back(uv1[i][0], uv1[i][1]);
             prim->uvs.emplace_back(uv2[i][0], uv2[i][1]);
@@ -124,10 +126,10 @@ ZENO_API void primPolygonate(PrimitiveObject *prim, bool with_uv) {
             }
         }
     }
-    prim->polys.add_attr<int>("matid");
+    auto &polys_matid = prim->polys.add_attr<int>("matid");
     for(int i=0;i<matid.size();i++)
     {
-        prim->polys.attr<int>("matid")[i] = matid[i];
+        polys_matid[i] = matid[i];
     }
 
     prim->tris.clear();
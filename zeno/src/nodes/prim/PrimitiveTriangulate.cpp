@@ -4,6 +4,7 @@
 #include <zeno/para/parallel_for.h>
 #include <zeno/para/parallel_scan.h>
 #include <zeno/utils/variantswitch.h>
+#include <zeno/utils/triangulate.h>
 
 namespace zeno {
 
@@ -23,18 +24,19 @@ ZENO_API void primTriangulateQuads(PrimitiveObject *prim) {
         prim->tris.add_attr<int>("matid");
     }
 
-
+    auto &tris_matid = prim->tris.attr<int>("matid");
+    auto const &quads_matid = prim->quads.attr<int>("matid");
     for (size_t i = 0; i < prim->quads.size(); i++) {
         auto quad = prim->quads[i];
         prim->tris[base+i*2+0] = vec3f(quad[0], quad[1], quad[2]);
         prim->tris[base+i*2+1] = vec3f(quad[0], quad[2], quad[3]);
         if(hasmat) {
-            prim->tris.attr<int>("matid")[base + i * 2 + 0] = prim->quads.attr<int>("matid")[i];
-            prim->tris.attr<int>("matid")[base + i * 2 + 1] = prim->quads.attr<int>("matid")[i];
+            tris_matid[base + i * 2 + 0] = quads_matid[i];
+            tris_matid[base + i * 2 + 1] = quads_matid[i];
         } else
         {
-            prim->tris.attr<int>("matid")[base + i * 2 + 0] = -1;
-            prim->tris.attr<int>("matid")[base + i * 2 + 1] = -1;
+            tris_matid[base + i * 2 + 0] = -1;
+            tris_matid[base + i * 2 + 1] = -1;
         }
     }
     prim->quads.clear();
@@ -72,93 +74,61 @@ ZENO_API void primTriangulate(PrimitiveObject *prim, bool with_uv, bool has_line
     } else {
         prim->tris.add_attr<int>("matid");
     }
+    auto &tris_matid = prim->tris.attr<int>("matid");
+    auto const &polys_matid = prim->polys.attr<int>("matid");
+
+    bool uv = with_uv && prim->loops.has_attr("uvs") && prim->uvs.size() > 0;
+    std::vector<int> *loop_uv = nullptr;
+    std::vector<vec3f> *uv0 = nullptr, *uv1 = nullptr, *uv2 = nullptr;
+    if (uv) {
+        loop_uv = &prim->loops.attr<int>("uvs");
+        uv0 = &prim->tris.add_attr<vec3f>("uv0");
+        uv1 = &prim->tris.add_attr<vec3f>("uv1");
+        uv2 = &prim->tris.add_attr<vec3f>("uv2");
+    }
+    auto const &uvs = prim->uvs;
 
-
-    if (!(prim->loops.has_attr("uvs") && prim->uvs.size() > 0) || !with_uv) {
-        parallel_for(prim->polys.size(), [&] (size_t i) {
-            auto [start, len] = prim->polys[i];
-            auto matidx = prim->polys.attr<int>("matid")[i];
-            if (len >= 3) {
-                int scanbase;
-                if constexpr (has_lines.value) {
-                    scanbase = scansum[i][0] + tribase;
-                } else {
-                    scanbase = scansum[i] + tribase;
-                }
-                prim->tris[scanbase] = vec3i(
-                        prim->loops[start],
-                        prim->loops[start + 1],
-                        prim->loops[start + 2]);
-                prim->tris.attr<int>("matid")[scanbase] = matidx;
-                scanbase++;
-                for (int j = 3; j < len; j++) {
-                    prim->tris[scanbase] = vec3i(
-                            prim->loops[start],
-                            prim->loops[start + j - 1],
-                            prim->loops[start + j]);
-                    prim->tris.attr<int>("matid")[scanbase] = matidx;
-                    scanbase++;
-                }
-            }
+    parallel_for(prim->polys.size(), [&] (size_t i) {
+        auto [start, len] = prim->polys[i];
+        auto matidx = polys_matid[i];
+        if (len >= 3) {
+            int scanbase;
             if constexpr (has_lines.value) {
-                if (len == 2) {
-                    int scanbase = scansum[i][1] + linebase;
-                    prim->lines[scanbase] = vec2i(
-                        prim->loops[start],
-                        prim->loops[start + 1]);
-                }
+                scanbase = scansum[i][0] + tribase;
+            } else {
+                scanbase = scansum[i] + tribase;
             }
-        });
-
-    } else {
-        auto &loop_uv = prim->loops.attr<int>("uvs");
-        auto &uvs = prim->uvs;
-        auto &uv0 = prim->tris.add_attr<vec3f>("uv0");
-        auto &uv1 = prim->tris.add_attr<vec3f>("uv1");
-        auto &uv2 = prim->tris.add_attr<vec3f>("uv2");
-
-        parallel_for(prim->polys.size(), [&] (size_t i) {
-            auto [start, len] = prim->polys[i];
-            auto matidx = prim->polys.attr<int>("matid")[i];
-            if (len >= 3) {
-                int scanbase;
-                if constexpr (has_lines.value) {
-                    scanbase = scansum[i][0] + tribase;
-                } else {
-                    scanbase = scansum[i] + tribase;
-                }
-                uv0[scanbase] = {uvs[loop_uv[start]][0], uvs[loop_uv[start]][1], 0};
-                uv1[scanbase] = {uvs[loop_uv[start + 1]][0], uvs[loop_uv[start + 1]][1], 0};
-                uv2[scanbase] = {uvs[loop_uv[start + 2]][0], uvs[loop_uv[start + 2]][1], 0};
-                prim->tris[scanbase] = vec3i(
-                        prim->loops[start],
-                        prim->loops[start + 1],
-                        prim->loops[start + 2]);
-                prim->tris.attr<int>("matid")[scanbase] = matidx;
-                scanbase++;
-                for (int j = 3; j < len; j++) {
-                    uv0[scanbase] = {uvs[loop_uv[start]][0], uvs[loop_uv[start]][1], 0};
-                    uv1[scanbase] = {uvs[loop_uv[start + j - 1]][0], uvs[loop_uv[start + j - 1]][1], 0};
-                    uv2[scanbase] = {uvs[loop_uv[start + j]][0], uvs[loop_uv[start + j]][1], 0};
-                    prim->tris[scanbase] = vec3i(
-                            prim->loops[start],
-                            prim->loops[start + j - 1],
-                            prim->loops[start + j]);
-                    prim->tris.attr<int>("matid")[scanbase] = matidx;
-                    scanbase++;
+            // ear clipping gives corner indices of the loop, convex ones stay a fan
+            static thread_local PolygonTriangulator triangulator;
+            triangulator.triangulate(prim->verts.data(), prim->loops.data() + start, len,
+                                     prim->tris.data() + scanbase);
+            for (int j = scanbase; j < scanbase + len - 2; j++) {
+                auto c = prim->tris[j];
+                if (uv) {
+                    auto uvOf = [&] (int k) {
+                        auto t = uvs[(*loop_uv)[start + k]];
+                        return vec3f(t[0], t[1], 0);
+                    };
+                    (*uv0)[j] = uvOf(c[0]);
+                    (*uv1)[j] = uvOf(c[1]);
+                    (*uv2)[j] = uvOf(c[2]);
                 }
+                prim->tris[j] = vec3i(
+                        prim->loops[start + c[0]],
+                        prim->loops[start + c[1]],
+                        prim->loops[start + c[2]]);
+                tris_matid[j] = matidx;
             }
-            if constexpr (has_lines.value) {
-                if (len == 2) {
-                    int scanbase = scansum[i][1] + linebase;
-                    prim->lines[scanbase] = vec2i(
-                        prim->loops[start],
-                        prim->loops[start + 1]);
-                }
+        }
+        if constexpr (has_lines.value) {
+            if (len == 2) {
+                int scanbase = scansum[i][1] + linebase;
+                prim->lines[scanbase] = vec2i(
+                    prim->loops[start],
+                    prim->loops[start + 1]);
             }
-        });
-
-    }
+        }
+    });
     prim->loops.clear();
     prim->polys.clear();
     prim->loops.erase_attr("uvs");
@@ -68,6 +68,8 @@ namespace zeno {
 namespace {
 
 struct CreateCube : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto size = get_input2<float>("size");
@@ -476,6 +478,8 @@ ZENDEFNODE(CreateCube, {
 });
 
 struct CreateDisk : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto position = get_input2<zeno::vec3f>("position");
@@ -540,6 +544,8 @@ ZENDEFNODE(CreateDisk, {
 });
 
 struct CreatePlane : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto position = get_input2<zeno::vec3f>("position");
@@ -669,10 +675,10 @@ struct CreatePlane : zeno::INode {
         }
 
         if(prim->loops.size()!= 0 && get_input2<bool>("hasVertUV")){
-            loops.add_attr<int>("uvs");
+            auto &loop_uvs = loops.add_attr<int>("uvs");
             for (auto i = 0; i < prim->loops.size(); i++) {
                 auto lo = prim->loops[i];
-                loops.attr<int>("uvs")[i] = lo;
+                loop_uvs[i] = lo;
             }
         }
 
@@ -704,6 +710,8 @@ ZENDEFNODE(CreatePlane, {
 });
 
 struct CreateTube : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto position = get_input2<zeno::vec3f>("position");
@@ -947,6 +955,8 @@ ZENDEFNODE(CreateTube, {
 });
 
 struct CreateTorus : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto majorSegment = get_input2<int>("MajorSegment");
         auto minorSegment = get_input2<int>("MinorSegment");
@@ -1056,6 +1066,8 @@ ZENDEFNODE(CreateTorus, {
 });
 
 struct CreateSphere : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto position = get_input2<zeno::vec3f>("position");
@@ -1226,12 +1238,13 @@ struct CreateSphere : zeno::INode {
         }
 
         if (get_input2<bool>("isFlipFace")){
+            auto *loop_uvs = prim->loops.has_attr("uvs") ? &prim->loops.attr<int>("uvs") : nullptr;
             for (auto i = 0; i < prim->polys.size(); i++) {
                 auto [base, cnt] = prim->polys[i];
                 for (int j = 0; j < (cnt / 2); j++) {
                     std::swap(prim->loops[base + j], prim->loops[base + cnt - 1 - j]);
-                    if (prim->loops.has_attr("uvs")) {
-                        std::swap(prim->loops.attr<int>("uvs")[base + j], prim->loops.attr<int>("uvs")[base + cnt - 1 - j]);
+                    if (loop_uvs) {
+                        std::swap((*loop_uvs)[base + j], (*loop_uvs)[base + cnt - 1 - j]);
                     }
                 }
             }
@@ -1291,6 +1304,8 @@ ZENDEFNODE(CreateSphere, {
 });
 
 struct CreateCone : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
         auto position = get_input2<zeno::vec3f>("position");
@@ -1332,6 +1347,8 @@ ZENDEFNODE(CreateCone, {
 });
 
 struct CreateCylinder : zeno::INode {
+    static constexpr bool memoizable = true;
+
     virtual void apply() override {
         auto prim = std::make_shared<zeno::PrimitiveObject>();
 
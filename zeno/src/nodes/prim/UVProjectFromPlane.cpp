@@ -64,10 +64,10 @@ struct UVProjectFromPlane : zeno::INode {
         }
 
         if(prim->loops.size()){
-            prim->loops.add_attr<int>("uvs");
+            auto &loop_uvs = prim->loops.add_attr<int>("uvs");
             for (auto i = 0; i < prim->loops.size(); i++) {
                 auto lo = prim->loops[i];
-                prim->loops.attr<int>("uvs")[i] = lo;
+                loop_uvs[i] = lo;
             }
             prim->uvs.resize(prim->size());
             for (auto i = 0; i < prim->size(); i++) {
@@ -527,11 +527,10 @@ struct WriteImageFile : INode {
         int n = 4;
         auto A = std::make_shared<PrimitiveObject>();
         A->verts.resize(image->size());
-        A->verts.add_attr<float>("alpha");
+        std::vector<float> &alpha = A->verts.add_attr<float>("alpha");
         for(int i = 0;i < w * h;i++){
-            A->verts.attr<float>("alpha")[i] = 1.0;
+            alpha[i] = 1.0;
         }
-        std::vector<float> &alpha = A->verts.attr<float>("alpha");
         if(image->verts.has_attr("alpha")){
             n = 4;
             alpha = image->verts.attr<float>("alpha");
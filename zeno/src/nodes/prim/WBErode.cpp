@@ -2341,15 +2341,16 @@ void computeGradient(std::shared_ptr<PrimitiveObject> & hf, std::vector<std::vec
     gradientX.resize(height, std::vector<float>(width));
     gradientY.resize(height, std::vector<float>(width));
 
+    auto const &heightLayer = hf->verts.attr<float>("heightLayer");
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             if (x > 0 && x < width - 1) {
-                gradientX[y][x] = (hf->verts.attr<float>("heightLayer")[y * width + x + 1] - hf->verts.attr<float>("heightLayer")[y * width + x  - 1]) / 2.0f;
+                gradientX[y][x] = (heightLayer[y * width + x + 1] - heightLayer[y * width + x  - 1]) / 2.0f;
             } else {
                 gradientX[y][x] = 0.0f;
             }
             if (y > 0 && y < height - 1) {
-                gradientY[y][x] = (hf->verts.attr<float>("heightLayer")[(y+1) * width + x] - hf->verts.attr<float>("heightLayer")[(y - 1) * width + x]) / 2.0f;
+                gradientY[y][x] = (heightLayer[(y+1) * width + x] - heightLayer[(y - 1) * width + x]) / 2.0f;
             } else {
                 gradientY[y][x] = 0.0f;
             }
@@ -177,8 +177,9 @@ struct ParameterizeLine : INode {
                 linesLen[i] = total;
             }
             auto inv_total = 1 / total;
+            auto &parameterization = prim->lines.attr<float>("parameterization");
             for (size_t i = 0; i < prim->lines.size(); i++) {
-                prim->lines.attr<float>("parameterization")[i] = linesLen[i] * inv_total;
+                parameterization[i] = linesLen[i] * inv_total;
             }
         }
         set_output("prim", std::move(prim));
@@ -216,13 +217,15 @@ struct LineResample : INode {
             for (auto &_linesLen : linesLen) {
                 _linesLen *= inv_total;
             }
+            auto &parameterization = prim->lines.attr<float>("parameterization");
             for (size_t i=0; i<prim->lines.size();i++) {
-                prim->lines.attr<float>("parameterization")[i] = linesLen[i];
+                parameterization[i] = linesLen[i];
             }
         } else {
+            auto const &parameterization = prim->lines.attr<float>("parameterization");
 #pragma omp parallel for
             for (size_t i=0; i<prim->lines.size();i++) {
-                linesLen[i] = prim->lines.attr<float>("parameterization")[i];
+                linesLen[i] = parameterization[i];
             }
         }
 
@@ -259,9 +262,11 @@ struct LineResample : INode {
                     retprim->add_attr<T>(key);
                 }, prim->attr(key));
         }
+        auto const &t_arr = retprim->attr<float>("t");
+        std::vector<std::pair<zeno::vec2i, float>> interp(retprim->size());
 #pragma omp parallel for
         for(size_t i=0; i<retprim->size();i++) {
-            float insertU = retprim->attr<float>("t")[i];
+            float insertU = t_arr[i];
             auto it = std::upper_bound(linesLen.begin(), linesLen.end(), insertU);
             size_t index = it - linesLen.begin();
             index = std::min(index, prim->lines.size() - 1);
@@ -273,16 +278,22 @@ struct LineResample : INode {
             auto b = prim->verts[ind[1]];
             auto r1 = (insertU - linesLen[index - 1]) / (linesLen[index] - linesLen[index - 1]);
             retprim->verts[i] = a + (b - a) * r1;
-            for(auto key:prim->attr_keys())
-            {
-                if(key!="pos")
-                    std::visit([&retprim, &prim, &ind, &r1, &i, key](auto &&ref) {
-                        using T = std::remove_cv_t<std::remove_reference_t<decltype(ref[0])>>;
-                        auto a = prim->attr<T>(key)[ind[0]];
-                        auto b = prim->attr<T>(key)[ind[1]];
-                        retprim->attr<T>(key)[i] = a + (b-a)*r1;
-                    }, prim->attr(key));
-            }
+            interp[i] = {ind, r1};
+        }
+        for(auto key:prim->attr_keys())
+        {
+            if(key!="pos")
+                std::visit([&](auto const &src) {
+                    using T = std::decay_t<decltype(src[0])>;
+                    auto &dst = retprim->attr<T>(key);
+#pragma omp parallel for
+                    for (size_t i = 0; i < dst.size(); i++) {
+                        auto [ind, r1] = interp[i];
+                        auto a = src[ind[0]];
+                        auto b = src[ind[1]];
+                        dst[i] = a + (b-a)*r1;
+                    }
+                }, std::as_const(*prim).attr(key));
         }
 //
 //        auto& cu = retprim->add_attr<float>("curveU");
@@ -779,13 +790,14 @@ struct HeightStarPattern : zeno::INode {
         auto sharpness = get_input2<float>("sharpness");
         auto starness = get_input2<float>("starness");
         auto sides = get_input2<int>("sides");
-        prim->verts.add_attr<float>("result");
+        auto &result_arr = prim->verts.add_attr<float>("result");
+        auto const &res_arr = prim->verts.attr<vec3f>("res");
 
         std::uniform_real_distribution<float> dist(0, 1);
 
 #pragma omp parallel for
         for (int i = 0; i < prim->verts.size(); i++) {
-            auto coord = prim->verts.attr<vec3f>("res")[i];
+            auto coord = res_arr[i];
             vec2f coord2d = vec2f(coord[0], coord[1]);
             vec2f cellcenter = vec2f(floor(coord2d[0]), floor(coord2d[1]));
             float result = 0;
@@ -817,7 +829,7 @@ struct HeightStarPattern : zeno::INode {
                     }
                 }
             }
-            prim->verts.attr<float>("result")[i] = result;
+            result_arr[i] = result;
         }
         prim->verts.erase_attr("res");
         set_output("prim", std::move(prim));
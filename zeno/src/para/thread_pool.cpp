@@ -0,0 +1,231 @@
+#include <zeno/para/thread_pool.h>
+#include <zeno/utils/envconfig.h>
+#include <zeno/utils/log.h>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <deque>
+
+namespace zeno {
+
+namespace {
+
+struct Task {
+    std::function<void()> func;
+    // the fork_join counter the task belongs to, so that a waiting thread only
+    // helps with the work it is waiting for
+    std::atomic<std::size_t> const *group = nullptr;
+};
+
+struct TaskQueue {
+    std::mutex mtx;
+    std::deque<Task> tasks;
+
+    void push(Task &&task) {
+        std::lock_guard lck(mtx);
+        tasks.push_back(std::move(task));
+    }
+
+    // the owner pops LIFO for locality, thieves steal FIFO to get the big pieces
+    bool pop(Task &task) {
+        std::lock_guard lck(mtx);
+        if (tasks.empty()) return false;
+        task = std::move(tasks.back());
+        tasks.pop_back();
+        return true;
+    }
+
+    bool steal(Task &task) {
+        std::lock_guard lck(mtx);
+        if (tasks.empty()) return false;
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        return true;
+    }
+
+    bool pop_group(Task &task, std::atomic<std::size_t> const *group) {
+        std::lock_guard lck(mtx);
+        if (!tasks.empty() && tasks.back().group == group) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    bool steal_group(Task &task, std::atomic<std::size_t> const *group) {
+        std::lock_guard lck(mtx);
+        for (auto it = tasks.begin(); it != tasks.end(); ++it) {
+            if (it->group == group) {
+                task = std::move(*it);
+                tasks.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+thread_local int tls_worker_id = -1;
+
+struct Pool {
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    TaskQueue injected;
+    std::vector<std::thread> threads;
+
+    std::atomic<std::size_t> ntasks{0};
+    std::mutex sleep_mtx;
+    std::condition_variable sleep_cv;
+
+    // signalled when a fork_join group runs out of tasks, or when a task is
+    // queued while some thread is waiting for its group
+    std::mutex done_mtx;
+    std::condition_variable done_cv;
+    std::atomic<std::size_t> pushed{0};
+    std::atomic<int> waiters{0};
+
+    explicit Pool(std::size_t nworkers) {
+        for (std::size_t i = 0; i < nworkers; i++) {
+            queues.push_back(std::make_unique<TaskQueue>());
+        }
+        for (std::size_t i = 0; i < nworkers; i++) {
+            threads.emplace_back([this, i] {
+                tls_worker_id = (int)i;
+                worker_loop((int)i);
+            });
+        }
+    }
+
+    void push(Task &&task) {
+        if (tls_worker_id >= 0)
+            queues[tls_worker_id]->push(std::move(task));
+        else
+            injected.push(std::move(task));
+        ++ntasks;
+        {
+            std::lock_guard lck(sleep_mtx);
+        }
+        sleep_cv.notify_one();
+        // after the task is queued: a waiter that missed it has registered
+        // itself before looking, so it is seen here
+        ++pushed;
+        if (waiters.load() != 0) {
+            {
+                std::lock_guard lck(done_mtx);
+            }
+            done_cv.notify_all();
+        }
+    }
+
+    void run(Task &task) {
+        --ntasks;
+        task.func();
+    }
+
+    bool try_run_one(int self) {
+        Task task;
+        bool got = self >= 0 && queues[self]->pop(task);
+        if (!got)
+            got = injected.steal(task);
+        for (std::size_t i = 1; !got && i <= queues.size(); i++) {
+            std::size_t victim = (self + i) % queues.size();
+            if ((int)victim != self)
+                got = queues[victim]->steal(task);
+        }
+        if (!got)
+            return false;
+        run(task);
+        return true;
+    }
+
+    // only tasks of the given group: a waiting thread must not pick up
+    // unrelated work (e.g. a whole graph node) while it may hold locks
+    bool try_run_group(int self, std::atomic<std::size_t> const *group) {
+        Task task;
+        bool got = self >= 0 && queues[self]->pop_group(task, group);
+        if (!got)
+            got = injected.steal_group(task, group);
+        for (std::size_t i = 1; !got && i <= queues.size(); i++) {
+            std::size_t victim = (self + i) % queues.size();
+            if ((int)victim != self)
+                got = queues[victim]->steal_group(task, group);
+        }
+        if (!got)
+            return false;
+        run(task);
+        return true;
+    }
+
+    [[noreturn]] void worker_loop(int self) {
+        while (true) {
+            if (!try_run_one(self)) {
+                std::unique_lock lck(sleep_mtx);
+                sleep_cv.wait(lck, [&] { return ntasks.load() != 0; });
+            }
+        }
+    }
+};
+
+std::size_t num_threads() {
+    static std::size_t n = [] {
+        int n = envconfig::getInt("NUM_THREADS");
+        if (n < 0) {
+            log_warn("ignoring ZENO_NUM_THREADS={}, expect a positive number", n);
+            n = 0;
+        }
+        if (!n) n = (int)std::thread::hardware_concurrency();
+        return std::max<std::size_t>(n, 1);
+    }();
+    return n;
+}
+
+Pool &get_pool() {
+    // never destroyed: workers are parked forever and die with the process,
+    // joining them from a static destructor may deadlock on DLL unload
+    static Pool *pool = new Pool(num_threads() - 1);
+    return *pool;
+}
+
+}
+
+ZENO_API std::size_t thread_pool::concurrency() {
+    return num_threads();
+}
+
+ZENO_API void thread_pool::spawn(std::function<void()> task, std::atomic<std::size_t> const *group) {
+    if (num_threads() <= 1) {
+        task();
+        return;
+    }
+    get_pool().push({std::move(task), group});
+}
+
+ZENO_API void thread_pool::finish(std::atomic<std::size_t> &counter) {
+    if (--counter == 0 && num_threads() > 1) {
+        auto &pool = get_pool();
+        {
+            std::lock_guard lck(pool.done_mtx);
+        }
+        pool.done_cv.notify_all();
+    }
+}
+
+ZENO_API void thread_pool::wait(std::atomic<std::size_t> &counter) {
+    if (counter.load() == 0)
+        return;
+    auto &pool = get_pool();
+    ++pool.waiters;
+    while (counter.load() != 0) {
+        auto pushed = pool.pushed.load();
+        if (pool.try_run_group(tls_worker_id, &counter))
+            continue;
+        // the rest of the group is running on other threads, sleep until it is
+        // done or until they fork more of it
+        std::unique_lock lck(pool.done_mtx);
+        pool.done_cv.wait(lck, [&] { return counter.load() == 0 || pool.pushed.load() != pushed; });
+    }
+    --pool.waiters;
+}
+
+}
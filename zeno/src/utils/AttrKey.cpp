@@ -0,0 +1,50 @@
+#include <zeno/utils/AttrKey.h>
+#include <zeno/utils/Error.h>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <deque>
+
+namespace zeno {
+
+namespace {
+
+struct AttrSymbolTable {
+    std::shared_mutex mtx;
+    // deque keeps the strings in place, so the views used as map keys stay valid
+    std::deque<std::string> names{"pos"};
+    std::unordered_map<std::string_view, uint32_t> ids{{names.front(), 0}};
+
+    static AttrSymbolTable &instance() {
+        static AttrSymbolTable table;
+        return table;
+    }
+};
+
+}
+
+ZENO_API uint32_t AttrKey::intern(std::string_view name) {
+    auto &table = AttrSymbolTable::instance();
+    {
+        std::shared_lock lck(table.mtx);
+        if (auto it = table.ids.find(name); it != table.ids.end())
+            return it->second;
+    }
+    std::unique_lock lck(table.mtx);
+    if (auto it = table.ids.find(name); it != table.ids.end())
+        return it->second;
+    auto id = (uint32_t)table.names.size();
+    auto const &str = table.names.emplace_back(name);
+    table.ids.emplace(str, id);
+    return id;
+}
+
+ZENO_API std::string const &AttrKey::name_of(uint32_t id) {
+    auto &table = AttrSymbolTable::instance();
+    std::shared_lock lck(table.mtx);
+    if (id >= table.names.size())
+        throw makeError<IndexError>(id, table.names.size(), "AttrKey::name_of");
+    return table.names[id];
+}
+
+}
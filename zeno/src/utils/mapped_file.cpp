@@ -0,0 +1,93 @@
+#include <zeno/utils/mapped_file.h>
+#include <zeno/utils/log.h>
+#include <filesystem>
+#ifdef _WIN32
+#include <zeno/utils/fuck_win.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace zeno {
+
+ZENO_API mapped_file::mapped_file(std::string const &path) {
+#ifdef _WIN32
+    auto wpath = std::filesystem::u8path(path).wstring();
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        log_error("cannot open file for mapping: {}", path);
+        return;
+    }
+    m_file = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        close();
+        return;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        log_error("cannot create file mapping: {}", path);
+        close();
+        return;
+    }
+    m_mapping = mapping;
+    auto ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr) {
+        log_error("cannot map view of file: {}", path);
+        close();
+        return;
+    }
+    m_data = static_cast<const char *>(ptr);
+    m_size = (std::size_t)size.QuadPart;
+#else
+    m_fd = ::open(std::filesystem::u8path(path).c_str(), O_RDONLY);
+    if (m_fd < 0) {
+        log_error("cannot open file for mapping: {}", path);
+        return;
+    }
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0 || st.st_size == 0) {
+        close();
+        return;
+    }
+    void *ptr = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (ptr == MAP_FAILED) {
+        log_error("cannot mmap file: {}", path);
+        close();
+        return;
+    }
+    ::madvise(ptr, (std::size_t)st.st_size, MADV_WILLNEED);
+    m_data = static_cast<const char *>(ptr);
+    m_size = (std::size_t)st.st_size;
+#endif
+}
+
+void mapped_file::close() {
+#ifdef _WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data)
+        ::munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+ZENO_API mapped_file::~mapped_file() {
+    close();
+}
+
+}
@@ -0,0 +1,459 @@
+#include <zeno/utils/triangulate.h>
+#include <algorithm>
+#include <cmath>
+
+namespace zeno {
+
+namespace {
+
+// twice the signed area of (a, b, c), positive when counter-clockwise
+template <class N>
+inline double orient(N const &a, N const &b, N const &c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// inclusive, for a counter-clockwise triangle
+template <class N>
+inline bool pointInTriangle(N const &a, N const &b, N const &c, N const &p) {
+    return orient(a, b, p) >= 0 && orient(b, c, p) >= 0 && orient(c, a, p) >= 0;
+}
+
+// inclusive, for either winding
+inline bool pointInTriangleAny(double ax, double ay, double bx, double by,
+                               double cx, double cy, double px, double py) {
+    double d1 = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+    double d2 = (cx - bx) * (py - by) - (cy - by) * (px - bx);
+    double d3 = (ax - cx) * (py - cy) - (ay - cy) * (px - cx);
+    return (d1 >= 0 && d2 >= 0 && d3 >= 0) || (d1 <= 0 && d2 <= 0 && d3 <= 0);
+}
+
+template <class N>
+inline bool samePoint(N const &a, N const &b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+}
+
+// pick the projection plane from the Newell normal, so that the loop winds
+// counter-clockwise in (flip ? -p[u] : p[u], p[v])
+void PolygonTriangulator::project(vec3f const *pos, int const *loop, int n, int &u, int &v, bool &flip) const {
+    double nrm[3] = {0, 0, 0};
+    for (int i = 0; i < n; i++) {
+        auto const &a = pos[loop[i]];
+        auto const &b = pos[loop[i + 1 == n ? 0 : i + 1]];
+        nrm[0] += double(a[1] - b[1]) * double(a[2] + b[2]);
+        nrm[1] += double(a[2] - b[2]) * double(a[0] + b[0]);
+        nrm[2] += double(a[0] - b[0]) * double(a[1] + b[1]);
+    }
+    int k = 2;
+    if (std::abs(nrm[0]) > std::abs(nrm[1]) && std::abs(nrm[0]) > std::abs(nrm[2]))
+        k = 0;
+    else if (std::abs(nrm[1]) > std::abs(nrm[2]))
+        k = 1;
+    u = (k + 1) % 3;
+    v = (k + 2) % 3;
+    flip = nrm[k] < 0;
+}
+
+int PolygonTriangulator::addLoop(vec3f const *pos, int const *loop, int n, int u, int v, bool flip,
+                                 bool cornerIdx, bool ccw) {
+    int first = m_nodes.size();
+    double area = 0;
+    for (int i = 0; i < n; i++) {
+        auto const &p = pos[loop[i]];
+        m_nodes.push_back({flip ? -(double)p[u] : (double)p[u], (double)p[v], cornerIdx ? i : loop[i], 0, 0});
+    }
+    for (int i = 0; i < n; i++) {
+        auto const &a = m_nodes[first + i];
+        auto const &b = m_nodes[first + (i + 1 == n ? 0 : i + 1)];
+        area += a.x * b.y - b.x * a.y;
+    }
+    bool reversed = ccw ? area < 0 : area > 0;
+    for (int i = 0; i < n; i++) {
+        int prev = first + (i == 0 ? n - 1 : i - 1);
+        int next = first + (i + 1 == n ? 0 : i + 1);
+        m_nodes[first + i].prev = reversed ? next : prev;
+        m_nodes[first + i].next = reversed ? prev : next;
+    }
+    return first;
+}
+
+// whether the diagonal a-b starts inside the polygon at a
+bool PolygonTriangulator::locallyInside(int a, int b) const {
+    auto const &A = m_nodes[a];
+    auto const &B = m_nodes[b];
+    auto const &P = m_nodes[A.prev];
+    auto const &N = m_nodes[A.next];
+    if (orient(P, A, N) > 0)
+        return orient(A, B, N) <= 0 && orient(A, P, B) <= 0;
+    else
+        return orient(A, B, P) > 0 || orient(A, N, B) > 0;
+}
+
+// David Eberly's hole bridging: cast a ray from the leftmost hole vertex to
+// the left, the nearest outer edge hit gives the candidate, reflex vertices
+// inside the swept triangle take precedence
+int PolygonTriangulator::findHoleBridge(int hole, int outer) const {
+    double hx = m_nodes[hole].x, hy = m_nodes[hole].y;
+    double qx = -INFINITY;
+    int m = -1;
+    int p = outer;
+    do {
+        auto const &P = m_nodes[p];
+        auto const &N = m_nodes[P.next];
+        if (hy <= P.y && hy >= N.y && N.y != P.y) {
+            double x = P.x + (hy - P.y) * (N.x - P.x) / (N.y - P.y);
+            if (x <= hx && x > qx) {
+                qx = x;
+                m = P.x < N.x ? p : P.next;
+                if (x == hx)
+                    return m;
+            }
+        }
+        p = P.next;
+    } while (p != outer);
+    if (m < 0)
+        return -1;
+
+    int stop = m;
+    double mx = m_nodes[m].x, my = m_nodes[m].y;
+    double tanMin = INFINITY;
+    p = m;
+    do {
+        auto const &P = m_nodes[p];
+        if (hx >= P.x && P.x >= mx && hx != P.x &&
+            pointInTriangleAny(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, P.x, P.y)) {
+            double tan = std::abs(hy - P.y) / (hx - P.x);
+            auto const &M = m_nodes[m];
+            bool better = tan < tanMin;
+            if (!better && tan == tanMin) {
+                better = P.x > M.x || (P.x == M.x &&
+                    orient(m_nodes[M.prev], M, m_nodes[P.prev]) > 0 &&
+                    orient(m_nodes[P.next], M, m_nodes[M.next]) > 0);
+            }
+            if (better && locallyInside(p, hole)) {
+                m = p;
+                tanMin = tan;
+            }
+        }
+        p = P.next;
+    } while (p != stop);
+    return m;
+}
+
+// connect a and b with a doubled diagonal, a and b are duplicated
+int PolygonTriangulator::splitPolygon(int a, int b) {
+    int a2 = m_nodes.size();
+    m_nodes.push_back(m_nodes[a]);
+    int b2 = m_nodes.size();
+    m_nodes.push_back(m_nodes[b]);
+    int an = m_nodes[a].next;
+    int bp = m_nodes[b].prev;
+    m_nodes[a].next = b;
+    m_nodes[b].prev = a;
+    m_nodes[a2].next = an;
+    m_nodes[an].prev = a2;
+    m_nodes[b2].next = a2;
+    m_nodes[a2].prev = b2;
+    m_nodes[bp].next = b2;
+    m_nodes[b2].prev = bp;
+    return b2;
+}
+
+// bin the live nodes into a grid of about one node per cell
+void PolygonTriangulator::buildGrid() {
+    double x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    int count = 0;
+    for (int i = 0; i < (int)m_nodes.size(); i++) {
+        if (m_removed[i])
+            continue;
+        auto const &P = m_nodes[i];
+        x0 = std::min(x0, P.x);
+        y0 = std::min(y0, P.y);
+        x1 = std::max(x1, P.x);
+        y1 = std::max(y1, P.y);
+        count++;
+    }
+    double w = x1 - x0, h = y1 - y0;
+    double dx = std::sqrt(w * h / count);
+    // keep the resolution bounded for flat or degenerate loops
+    dx = std::max(dx, std::max(w, h) / count);
+    if (!(dx > 0))
+        dx = 1;
+    m_gridX = x0;
+    m_gridY = y0;
+    m_gridInvDx = 1 / dx;
+    m_gridNx = std::min((int)(w * m_gridInvDx) + 1, count);
+    m_gridNy = std::min((int)(h * m_gridInvDx) + 1, count);
+
+    auto cellOf = [&] (Node const &p) {
+        int cx = std::clamp((int)((p.x - m_gridX) * m_gridInvDx), 0, m_gridNx - 1);
+        int cy = std::clamp((int)((p.y - m_gridY) * m_gridInvDx), 0, m_gridNy - 1);
+        return cy * m_gridNx + cx;
+    };
+    int cells = m_gridNx * m_gridNy;
+    m_cellStart.assign(cells + 1, 0);
+    for (int i = 0; i < (int)m_nodes.size(); i++)
+        if (!m_removed[i])
+            m_cellStart[cellOf(m_nodes[i]) + 1]++;
+    for (int c = 0; c < cells; c++)
+        m_cellStart[c + 1] += m_cellStart[c];
+    m_cellNodes.resize(count);
+    m_cellCursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (int i = 0; i < (int)m_nodes.size(); i++)
+        if (!m_removed[i])
+            m_cellNodes[m_cellCursor[cellOf(m_nodes[i])]++] = i;
+}
+
+// an ear is convex and has no reflex vertex inside; only the grid cells covered
+// by the triangle are visited
+bool PolygonTriangulator::isEar(int ear) const {
+    auto const &B = m_nodes[ear];
+    auto const &A = m_nodes[B.prev];
+    auto const &C = m_nodes[B.next];
+    if (orient(A, B, C) <= 0)
+        return false;
+    double x0 = std::min({A.x, B.x, C.x}), x1 = std::max({A.x, B.x, C.x});
+    double y0 = std::min({A.y, B.y, C.y}), y1 = std::max({A.y, B.y, C.y});
+
+    auto blocks = [&] (int p) {
+        if (m_removed[p] || p == ear || p == B.prev || p == B.next)
+            return false;
+        auto const &P = m_nodes[p];
+        if (P.x < x0 || P.x > x1 || P.y < y0 || P.y > y1)
+            return false;
+        if (samePoint(P, A) || samePoint(P, B) || samePoint(P, C))
+            return false;
+        return pointInTriangle(A, B, C, P) && orient(m_nodes[P.prev], P, m_nodes[P.next]) <= 0;
+    };
+
+    auto cellX = [&] (double x) { return std::clamp((int)((x - m_gridX) * m_gridInvDx), 0, m_gridNx - 1); };
+    auto cellY = [&] (double y) { return std::clamp((int)((y - m_gridY) * m_gridInvDx), 0, m_gridNy - 1); };
+    int cx0 = cellX(x0), cx1 = cellX(x1), cy0 = cellY(y0), cy1 = cellY(y1);
+
+    Node const *tri[3] = {&A, &B, &C};
+    for (int cy = cy0; cy <= cy1; cy++) {
+        // only visit the cells of this row that the triangle itself covers,
+        // thin diagonal ears would otherwise scan their whole bounding box
+        double ylo = std::max(y0, m_gridY + cy / m_gridInvDx);
+        double yhi = cy == m_gridNy - 1 ? y1 : std::min(y1, m_gridY + (cy + 1) / m_gridInvDx);
+        double sx0 = INFINITY, sx1 = -INFINITY;
+        for (int e = 0; e < 3; e++) {
+            auto const &P = *tri[e];
+            auto const &Q = *tri[e == 2 ? 0 : e + 1];
+            if (P.y >= ylo && P.y <= yhi) {
+                sx0 = std::min(sx0, P.x);
+                sx1 = std::max(sx1, P.x);
+            }
+            for (double y: {ylo, yhi}) {
+                if ((P.y - y) * (Q.y - y) < 0) {
+                    double x = P.x + (y - P.y) * (Q.x - P.x) / (Q.y - P.y);
+                    sx0 = std::min(sx0, x);
+                    sx1 = std::max(sx1, x);
+                }
+            }
+        }
+        if (sx0 > sx1)
+            continue;
+        // one cell of slack against rounding at the cell borders
+        int rx0 = std::max(cellX(sx0) - 1, cx0);
+        int rx1 = std::min(cellX(sx1) + 1, cx1);
+        // cells adjacent in x are adjacent in m_cellNodes
+        int row = cy * m_gridNx;
+        for (int k = m_cellStart[row + rx0]; k < m_cellStart[row + rx1 + 1]; k++)
+            if (blocks(m_cellNodes[k]))
+                return false;
+    }
+    return true;
+}
+
+// clip ears until one triangle is left. convex vertices wait in a min-heap
+// keyed by the longest edge of their triangle, so that small ears go first and
+// no long fans build up; clipping an ear only changes the triangles of its two
+// neighbours, which are re-queued. when the heap runs dry the whole ring is
+// queued again; when that finds no ear either (degenerate or self intersecting
+// input) fall back to clipping a collinear vertex, then any convex vertex, then
+// any vertex, so that exactly n - 2 triangles always come out
+template <class Emit>
+void PolygonTriangulator::earClip(int start, int remaining, Emit const &emit) {
+    auto cmp = [] (Candidate const &l, Candidate const &r) {
+        return l.key > r.key;
+    };
+    auto push = [&] (int b) {
+        auto const &B = m_nodes[b];
+        auto const &A = m_nodes[B.prev];
+        auto const &C = m_nodes[B.next];
+        if (orient(A, B, C) <= 0)
+            return;
+        auto len2 = [] (Node const &p, Node const &q) {
+            return (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+        };
+        m_heap.push_back({std::max({len2(A, B), len2(B, C), len2(C, A)}), b, m_stamp[b]});
+        std::push_heap(m_heap.begin(), m_heap.end(), cmp);
+    };
+    auto clip = [&] (int b) {
+        auto const &B = m_nodes[b];
+        int a = B.prev, c = B.next;
+        emit(m_nodes[a].idx, B.idx, m_nodes[c].idx);
+        m_nodes[a].next = c;
+        m_nodes[c].prev = a;
+        m_removed[b] = 1;
+        remaining--;
+        start = c;
+        m_stamp[a]++;
+        m_stamp[c]++;
+        push(a);
+        push(c);
+    };
+    auto requeue = [&] {
+        m_heap.clear();
+        int p = start;
+        do {
+            push(p);
+            p = m_nodes[p].next;
+        } while (p != start);
+    };
+
+    m_stamp.assign(m_nodes.size(), 0);
+    requeue();
+    bool fresh = true;
+    int gridCount = remaining;
+    while (remaining > 3) {
+        // rebin once half of the nodes are gone, so that dead nodes and
+        // cells too small for the grown ears do not dominate the queries
+        if (remaining * 2 < gridCount) {
+            buildGrid();
+            gridCount = remaining;
+        }
+        if (!m_heap.empty()) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), cmp);
+            auto cand = m_heap.back();
+            m_heap.pop_back();
+            if (!m_removed[cand.node] && cand.stamp == m_stamp[cand.node] && isEar(cand.node)) {
+                clip(cand.node);
+                fresh = false;
+            }
+        } else if (!fresh) {
+            requeue();
+            fresh = true;
+        } else {
+            int b = -1;
+            for (int pass = 0; pass < 3 && b < 0; pass++) {
+                int p = start;
+                do {
+                    auto const &P = m_nodes[p];
+                    double o = orient(m_nodes[P.prev], P, m_nodes[P.next]);
+                    if (pass == 0 ? o == 0 : pass == 1 ? o > 0 : true) {
+                        b = p;
+                        break;
+                    }
+                    p = P.next;
+                } while (p != start);
+            }
+            clip(b);
+            fresh = false;
+        }
+    }
+    m_heap.clear();
+    auto const &B = m_nodes[start];
+    emit(m_nodes[B.prev].idx, B.idx, m_nodes[B.next].idx);
+}
+
+ZENO_API void PolygonTriangulator::triangulate(vec3f const *pos, int const *loop, int n, vec3i *out) {
+    if (n < 3)
+        return;
+    if (n == 3) {
+        out[0] = vec3i(0, 1, 2);
+        return;
+    }
+    int u, v;
+    bool flip;
+    project(pos, loop, n, u, v, flip);
+    m_nodes.clear();
+    int start = addLoop(pos, loop, n, u, v, flip, true, true);
+
+    // convex loops keep the plain fan
+    bool convex = true;
+    for (int i = 0; i < n && convex; i++) {
+        auto const &P = m_nodes[i];
+        convex = orient(m_nodes[P.prev], P, m_nodes[P.next]) > 0;
+    }
+    if (convex) {
+        for (int i = 1; i < n - 1; i++)
+            out[i - 1] = vec3i(0, i, i + 1);
+        return;
+    }
+
+    m_removed.assign(m_nodes.size(), 0);
+    buildGrid();
+    earClip(start, n, [&] (int a, int b, int c) {
+        *out++ = vec3i(a, b, c);
+    });
+}
+
+ZENO_API void PolygonTriangulator::triangulate(vec3f const *pos, std::vector<int> const &outer,
+                                               std::vector<std::vector<int>> const &holes, std::vector<vec3i> &out) {
+    if (outer.size() < 3)
+        return;
+    int u, v;
+    bool flip;
+    project(pos, outer.data(), outer.size(), u, v, flip);
+    m_nodes.clear();
+    int start = addLoop(pos, outer.data(), outer.size(), u, v, flip, false, true);
+
+    std::vector<int> lefts;
+    for (auto const &hole: holes) {
+        if (hole.size() < 3)
+            continue;
+        int first = addLoop(pos, hole.data(), hole.size(), u, v, flip, false, false);
+        int left = first;
+        for (int i = first; i < (int)m_nodes.size(); i++) {
+            if (m_nodes[i].x < m_nodes[left].x || (m_nodes[i].x == m_nodes[left].x && m_nodes[i].y < m_nodes[left].y))
+                left = i;
+        }
+        lefts.push_back(left);
+    }
+    std::sort(lefts.begin(), lefts.end(), [&] (int a, int b) {
+        return m_nodes[a].x < m_nodes[b].x || (m_nodes[a].x == m_nodes[b].x && m_nodes[a].y < m_nodes[b].y);
+    });
+    std::vector<int> dropped;
+    for (int left: lefts) {
+        int bridge = findHoleBridge(left, start);
+        if (bridge < 0)
+            dropped.push_back(left);
+        else
+            splitPolygon(bridge, left);
+    }
+
+    m_removed.assign(m_nodes.size(), 0);
+    for (int left: dropped) {
+        int p = left;
+        do {
+            m_removed[p] = 1;
+            p = m_nodes[p].next;
+        } while (p != left);
+    }
+    int remaining = 0;
+    int p = start;
+    do {
+        remaining++;
+        p = m_nodes[p].next;
+    } while (p != start);
+    buildGrid();
+    out.reserve(out.size() + remaining - 2);
+    earClip(start, remaining, [&] (int a, int b, int c) {
+        out.emplace_back(a, b, c);
+    });
+}
+
+void polygonDecompose(std::vector<vec3f> &verts, std::vector<int> &poly,
+                      std::vector<vec3i> &triangles) {
+    triangles.resize(poly.size() < 3 ? 0 : poly.size() - 2);
+    if (triangles.empty())
+        return;
+    PolygonTriangulator().triangulate(verts.data(), poly.data(), poly.size(), triangles.data());
+    for (auto &tri: triangles)
+        tri = vec3i(poly[tri[0]], poly[tri[1]], poly[tri[2]]);
+}
+
+}
@@ -0,0 +1,178 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/types/AttrVector.h>
+#include <atomic>
+#include <utility>
+#include <thread>
+#include <vector>
+
+using namespace zeno;
+
+namespace {
+
+using Verts = AttrVector<vec3f>;
+
+Verts makeVerts(size_t n) {
+    Verts verts(n);
+    auto &clr = verts.add_attr<float>("clr");
+    auto &tmp = verts.add_attr<int>("tmp");
+    for (size_t i = 0; i < n; i++) {
+        verts[i] = vec3f(i, 0, 0);
+        clr[i] = i * 0.5f;
+        tmp[i] = (int)i;
+    }
+    verts.seal();
+    return verts;
+}
+
+// the array currently backing an attribute, without unsharing it
+template <class T>
+T const *arrayOf(Verts const &verts, std::string const &name) {
+    return verts.attr<T>(name).data();
+}
+
+}
+
+TEST_CASE("copies share attribute arrays but not the base array", "[AttrVector]")
+{
+    auto a = makeVerts(100);
+    Verts b = a;
+    REQUIRE(arrayOf<float>(a, "clr") == arrayOf<float>(b, "clr"));
+    REQUIRE(arrayOf<int>(a, "tmp") == arrayOf<int>(b, "tmp"));
+    // values is a plain vector, copied with the AttrVector
+    REQUIRE(a.values.data() != b.values.data());
+
+    // const iteration and peek_all only read
+    Verts const &cb = b;
+    for (auto const &[key, arr]: cb.attrs)
+        (void)arr;
+    REQUIRE(b.attrs.peek_all().size() == 2);
+    REQUIRE(arrayOf<float>(a, "clr") == arrayOf<float>(b, "clr"));
+
+    // non-const iteration hands out mutable references, so it unshares
+    for (auto &[key, arr]: b.attrs)
+        (void)arr;
+    REQUIRE(arrayOf<float>(a, "clr") != arrayOf<float>(b, "clr"));
+    REQUIRE(arrayOf<int>(a, "tmp") != arrayOf<int>(b, "tmp"));
+}
+
+TEST_CASE("a write unshares only the written array", "[AttrVector]")
+{
+    auto a = makeVerts(100);
+    auto const *shared = arrayOf<float>(a, "clr");
+    Verts b = a;
+
+    auto &clr = b.attr<float>("clr");
+    clr[3] = -1;
+    REQUIRE(clr.data() != shared);
+    REQUIRE(std::as_const(a).attr<float>("clr")[3] == 1.5f);
+    // the other arrays stay shared
+    REQUIRE(arrayOf<int>(a, "tmp") == arrayOf<int>(b, "tmp"));
+    // the original still owns the array it had
+    REQUIRE(arrayOf<float>(a, "clr") == shared);
+
+    // once the copy is gone the remaining owner writes in place
+    b = Verts();
+    a.attr<float>("clr")[3] = 2;
+    REQUIRE(arrayOf<float>(a, "clr") == shared);
+}
+
+TEST_CASE("arrays written since the last seal are not shared", "[AttrVector]")
+{
+    auto a = makeVerts(100);
+    auto &clr = a.attr<float>("clr");
+
+    // a mutable reference into a is alive, a copy must not share that array
+    Verts b = a;
+    REQUIRE(arrayOf<float>(b, "clr") != clr.data());
+    clr[0] = 42;
+    REQUIRE(b.attr<float>("clr")[0] == 0);
+    // and the reference stays valid, the array is not swapped again before seal
+    REQUIRE(&a.attr<float>("clr") == &clr);
+    REQUIRE(arrayOf<int>(a, "tmp") == arrayOf<int>(b, "tmp"));
+
+    // after seal the written array can be shared again
+    a.seal();
+    Verts c = a;
+    REQUIRE(arrayOf<float>(c, "clr") == arrayOf<float>(a, "clr"));
+    // and writing it again unshares it first
+    a.attr<float>("clr")[0] = 7;
+    REQUIRE(c.attr<float>("clr")[0] == 42);
+    REQUIRE(a.attr<float>("clr")[0] == 7);
+}
+
+TEST_CASE("resize and clear never write through a shared array", "[AttrVector]")
+{
+    auto a = makeVerts(100);
+    Verts b = a;
+    b.resize(150);
+    REQUIRE(a.attr<float>("clr").size() == 100);
+    REQUIRE(b.attr<float>("clr").size() == 150);
+    REQUIRE(b.attr<float>("clr")[99] == 49.5f);
+
+    Verts c = a;
+    c.clear();
+    REQUIRE(a.attr<int>("tmp").size() == 100);
+    REQUIRE(c.attr<int>("tmp").empty());
+}
+
+TEST_CASE("concurrent lookups unshare an array once", "[AttrVector]")
+{
+    for (int run = 0; run < 50; run++) {
+        auto a = makeVerts(1000);
+        Verts b = a;
+        auto const *shared = arrayOf<float>(a, "clr");
+
+        constexpr int kThreads = 8;
+        std::atomic<int> ready{0};
+        std::vector<float *> seen(kThreads);
+        std::vector<float> sums(kThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; t++) {
+            threads.emplace_back([&, t] {
+                ready++;
+                while (ready.load() < kThreads)
+                    std::this_thread::yield();
+                if (t % 2) {
+                    // writers race the first mutable lookup of a's array
+                    auto &clr = a.attr<float>("clr");
+                    seen[t] = clr.data();
+                    clr[t] = -t;
+                } else {
+                    // readers of both copies see the old or the new array, never
+                    // one that was freed under them
+                    Verts const &ca = a;
+                    auto const &clr = ca.attr<float>("clr");
+                    float sum = 0;
+                    // past the elements the writers change
+                    for (size_t i = kThreads; i < clr.size(); i++)
+                        sum += clr[i];
+                    for (auto x: b.attrs.peek_all())
+                        (void)x;
+                    sums[t] = sum;
+                }
+            });
+        }
+        for (auto &th: threads)
+            th.join();
+
+        // every writer got the same private array, written in place
+        for (int t = 1; t < kThreads; t += 2) {
+            REQUIRE(seen[t] == seen[1]);
+            REQUIRE(a.attr<float>("clr")[t] == -t);
+        }
+        REQUIRE(seen[1] != shared);
+        // b still has the untouched shared array
+        REQUIRE(arrayOf<float>(b, "clr") == shared);
+        for (int t = 0; t < kThreads; t++)
+            REQUIRE(b.attr<float>("clr")[t] == t * 0.5f);
+        for (int t = 0; t < kThreads; t += 2)
+            REQUIRE(sums[t] == sums[0]);
+
+        // the swapped out array is kept until seal, then released by a
+        a.seal();
+        Verts c = a;
+        REQUIRE(arrayOf<float>(c, "clr") == arrayOf<float>(a, "clr"));
+    }
+}
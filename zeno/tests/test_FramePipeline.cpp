@@ -0,0 +1,71 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/extra/FramePipeline.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace zeno;
+
+TEST_CASE("frame pipeline sends every frame in order", "[FramePipeline]")
+{
+    GlobalStatus status;
+    std::vector<int> sent;
+    {
+        FramePipeline<int> pipeline(2, status, [&] (int &&frame) {
+            sent.push_back(frame);
+        });
+        for (int frame = 0; frame < 20; frame++) {
+            pipeline.flushReady();
+            pipeline.submit(frame, [frame] {
+                std::this_thread::sleep_for(std::chrono::microseconds((frame * 37) % 200));
+                return frame;
+            });
+            // at most maxInFlight frames are held back
+            REQUIRE(pipeline.inflight.size() <= 2);
+        }
+        pipeline.flushAll();
+    }
+    REQUIRE(!status.failed());
+    REQUIRE(sent.size() == 20);
+    for (int frame = 0; frame < 20; frame++)
+        REQUIRE(sent[frame] == frame);
+}
+
+TEST_CASE("frame pipeline reports the first failed frame", "[FramePipeline]")
+{
+    GlobalStatus status;
+    std::vector<int> sent;
+    FramePipeline<int> pipeline(3, status, [&] (int &&frame) {
+        if (frame == 7)
+            throw std::runtime_error("send failed");
+        sent.push_back(frame);
+    });
+    for (int frame = 0; frame < 10; frame++) {
+        pipeline.submit(frame, [frame] {
+            if (frame == 2 || frame == 5)
+                throw std::runtime_error("encode failed");
+            return frame;
+        });
+    }
+    pipeline.flushAll();
+
+    // a failed prepare or send doesn't stop the other frames
+    REQUIRE(sent == std::vector<int>{0, 1, 3, 4, 6, 8, 9});
+    REQUIRE(status.failed());
+    REQUIRE(status.nodeName == frameOutputName(2));
+    REQUIRE(status.error);
+    // the status reaches the editor as json
+    REQUIRE(status.toJson().find("<output frame 2>") != std::string::npos);
+}
+
+TEST_CASE("synchronous frame output reports errors like the pipeline", "[FramePipeline]")
+{
+    GlobalStatus status;
+    outputFrameCatched(4, [] {}, status);
+    REQUIRE(!status.failed());
+    outputFrameCatched(4, [] { throw std::runtime_error("dump failed"); }, status);
+    outputFrameCatched(5, [] { throw std::runtime_error("dump failed"); }, status);
+    REQUIRE(status.nodeName == frameOutputName(4));
+}
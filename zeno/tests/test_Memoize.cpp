@@ -0,0 +1,171 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/zeno.h>
+#include <zeno/core/Graph.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/types/NumericObject.h>
+#include <zeno/types/StringObject.h>
+#include <cstdlib>
+#include <string>
+
+using namespace zeno;
+
+namespace {
+
+int gridApplied = 0;
+
+// a flat n*n grid of triangles, counts how often it is really applied
+struct TestMemoGrid : INode {
+    static constexpr bool memoizable = true;
+
+    void apply() override {
+        gridApplied++;
+        int n = get_input2<int>("n");
+        auto prim = std::make_shared<PrimitiveObject>();
+        prim->verts.resize((n + 1) * (n + 1));
+        for (int y = 0; y <= n; y++)
+            for (int x = 0; x <= n; x++)
+                prim->verts[y * (n + 1) + x] = vec3f(x, 0, y);
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++) {
+                int i = y * (n + 1) + x;
+                prim->tris.emplace_back(i, i + 1, i + n + 1);
+                prim->tris.emplace_back(i + 1, i + n + 2, i + n + 1);
+            }
+        }
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestMemoGrid, {
+    {{"int", "n", "4"}},
+    {"prim"},
+    {},
+    {"debug"},
+});
+
+// not memoizable, moves its input up in place
+struct TestMemoLift : INode {
+    void apply() override {
+        auto prim = get_input<PrimitiveObject>("prim");
+        for (auto &pos: prim->verts)
+            pos[1] += 1;
+        set_output("prim", std::move(prim));
+    }
+};
+
+ZENDEFNODE(TestMemoLift, {
+    {"prim"},
+    {"prim"},
+    {},
+    {"debug"},
+});
+
+bool samePositions(std::vector<vec3f> const &a, std::vector<vec3f> const &b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (a[i][0] != b[i][0] || a[i][1] != b[i][1] || a[i][2] != b[i][2])
+            return false;
+    }
+    return true;
+}
+
+struct MemoGraph {
+    std::shared_ptr<Graph> graph = getSession().createGraph();
+
+    MemoGraph(int seed) {
+        graph->addNode("TestMemoGrid", "grid");
+        graph->setNodeInput("grid", "n", std::make_shared<NumericObject>(4));
+        graph->addNode("PrimScatter", "scatter");
+        graph->bindNodeInput("scatter", "prim", "grid", "prim");
+        graph->setNodeInput("scatter", "type", std::make_shared<StringObject>("tris"));
+        graph->setNodeInput("scatter", "denAttr", std::make_shared<StringObject>(""));
+        graph->setNodeInput("scatter", "density", std::make_shared<NumericObject>(10.f));
+        graph->setNodeInput("scatter", "minRadius", std::make_shared<NumericObject>(0.f));
+        graph->setNodeInput("scatter", "interpAttrs", std::make_shared<NumericObject>(1));
+        graph->setNodeInput("scatter", "seed", std::make_shared<NumericObject>(seed));
+        graph->addNode("TestMemoLift", "lift");
+        graph->bindNodeInput("lift", "prim", "scatter", "parsPrim");
+    }
+
+    void apply() {
+        graph->applyNodes({"lift"});
+    }
+
+    INode *node(std::string const &id) const {
+        return graph->nodes.at(id).get();
+    }
+
+    std::shared_ptr<PrimitiveObject> output(std::string const &id, std::string const &sock) const {
+        return safe_dynamic_cast<PrimitiveObject>(graph->getNodeOutput(id, sock));
+    }
+};
+
+}
+
+TEST_CASE("memoized nodes are skipped while their inputs stay the same", "[memoize]")
+{
+    setenv("ZENO_MEMOIZE", "1", 1);
+    gridApplied = 0;
+    MemoGraph g(42);
+
+    g.apply();
+    REQUIRE(gridApplied == 1);
+    auto scatterVersion = g.node("scatter")->outputVersion;
+    auto scattered = g.output("scatter", "parsPrim");
+    auto firstLift = g.output("lift", "prim")->verts.values;
+    REQUIRE(scattered->verts.size() > 0);
+    REQUIRE(g.node("scatter")->memoKey != 0);
+
+    for (int frame = 0; frame < 3; frame++) {
+        g.apply();
+        // neither the grid nor the scatter ran again, their outputs are shared
+        REQUIRE(gridApplied == 1);
+        REQUIRE(g.node("scatter")->outputVersion == scatterVersion);
+        REQUIRE(g.output("scatter", "parsPrim") == scattered);
+        // the node lifting in place got a copy: the memo kept its positions
+        REQUIRE(g.output("lift", "prim") != scattered);
+        REQUIRE(samePositions(g.output("lift", "prim")->verts.values, firstLift));
+        for (std::size_t i = 0; i < scattered->verts.size(); i++)
+            REQUIRE(scattered->verts[i][1] == 0);
+    }
+
+    // a changed parameter runs the node and everything downstream again
+    g.graph->setNodeInput("scatter", "density", std::make_shared<NumericObject>(20.f));
+    g.apply();
+    REQUIRE(gridApplied == 1);
+    REQUIRE(g.node("scatter")->outputVersion != scatterVersion);
+    REQUIRE(g.output("scatter", "parsPrim") != scattered);
+    unsetenv("ZENO_MEMOIZE");
+}
+
+TEST_CASE("PrimScatter with a random seed is never memoized", "[memoize]")
+{
+    setenv("ZENO_MEMOIZE", "1", 1);
+    gridApplied = 0;
+    MemoGraph g(-1);
+
+    g.apply();
+    auto version = g.node("scatter")->outputVersion;
+    REQUIRE(g.node("scatter")->memoKey == 0);
+    for (int frame = 0; frame < 3; frame++) {
+        g.apply();
+        REQUIRE(g.node("scatter")->outputVersion != version);
+        version = g.node("scatter")->outputVersion;
+    }
+    // the grid upstream is still reused
+    REQUIRE(gridApplied == 1);
+    unsetenv("ZENO_MEMOIZE");
+}
+
+TEST_CASE("nothing is memoized without ZENO_MEMOIZE", "[memoize]")
+{
+    unsetenv("ZENO_MEMOIZE");
+    gridApplied = 0;
+    MemoGraph g(42);
+    g.apply();
+    g.apply();
+    REQUIRE(gridApplied == 2);
+}
@@ -0,0 +1,98 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/funcs/ObjectCodec.h>
+#include <zeno/types/PrimitiveObject.h>
+#include <vector>
+
+using namespace zeno;
+
+namespace {
+
+std::shared_ptr<PrimitiveObject> makePrim() {
+    auto prim = std::make_shared<PrimitiveObject>();
+    prim->verts.resize(4);
+    for (int i = 0; i < 4; i++)
+        prim->verts[i] = vec3f(i, 2 * i, 3 * i);
+    prim->tris.emplace_back(0, 1, 2);
+    prim->tris.emplace_back(0, 2, 3);
+    auto &clr = prim->verts.add_attr<vec3f>("clr");
+    for (int i = 0; i < 4; i++)
+        clr[i] = vec3f(1, 0, i);
+    auto &id = prim->tris.add_attr<int>("id");
+    id[0] = 7;
+    id[1] = 9;
+    return prim;
+}
+
+std::shared_ptr<PrimitiveObject> roundTrip(PrimitiveObject const *prim, ObjectCodecOptions const &options) {
+    std::vector<char> buf;
+    REQUIRE(encodeObject(prim, buf, options));
+    auto obj = decodeObject(buf.data(), buf.size());
+    REQUIRE(obj);
+    auto res = std::dynamic_pointer_cast<PrimitiveObject>(obj);
+    REQUIRE(res);
+    return res;
+}
+
+}
+
+TEST_CASE("primitives survive an encode / decode round trip", "[ObjectCodec]")
+{
+    auto prim = makePrim();
+    for (bool compress: {false, true}) {
+        INFO("compress " << compress);
+        ObjectCodecOptions options;
+        options.compress = compress;
+        auto res = roundTrip(prim.get(), options);
+        REQUIRE(res->verts.size() == 4);
+        REQUIRE(res->tris.size() == 2);
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(res->verts[i][1] == 2 * i);
+            REQUIRE(res->verts.attr<vec3f>("clr")[i][2] == i);
+        }
+        REQUIRE(res->tris[1][2] == 3);
+        REQUIRE(res->tris.attr<int>("id")[1] == 9);
+    }
+}
+
+TEST_CASE("attributes of another length are resized on decode", "[ObjectCodec]")
+{
+    auto prim = makePrim();
+    // left out of sync by a node writing the attribute vector directly
+    prim->verts.attr<vec3f>("clr").resize(2);
+    prim->verts.add_attr<float>("tmp").assign({1, 2, 3, 4, 5, 6});
+    for (bool compress: {false, true}) {
+        INFO("compress " << compress);
+        ObjectCodecOptions options;
+        options.compress = compress;
+        auto res = roundTrip(prim.get(), options);
+        REQUIRE(res->verts.size() == 4);
+        // short ones are padded with zeros
+        auto &clr = res->verts.attr<vec3f>("clr");
+        REQUIRE(clr.size() == 4);
+        REQUIRE(clr[1][2] == 1);
+        REQUIRE(clr[3][0] == 0);
+        REQUIRE(clr[3][2] == 0);
+        // long ones are truncated
+        auto &tmp = res->verts.attr<float>("tmp");
+        REQUIRE(tmp.size() == 4);
+        REQUIRE(tmp[3] == 4);
+    }
+}
+
+TEST_CASE("truncated primitives are rejected", "[ObjectCodec]")
+{
+    auto prim = makePrim();
+    for (bool compress: {false, true}) {
+        INFO("compress " << compress);
+        ObjectCodecOptions options;
+        options.compress = compress;
+        std::vector<char> buf;
+        REQUIRE(encodeObject(prim.get(), buf, options));
+        for (std::size_t len: {buf.size() / 4, buf.size() / 2, buf.size() - 8}) {
+            INFO("length " << len);
+            REQUIRE(!decodeObject(buf.data(), len));
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/zeno.h>
+#include <zeno/core/Graph.h>
+#include <zeno/types/StringObject.h>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zeno;
+
+namespace {
+
+// appends its tag to the log in place and passes the same object on, the
+// order of the tags is the order the nodes sharing the log were applied in
+struct TestLogAppend : INode {
+    void apply() override {
+        auto log = get_input<StringObject>("log");
+        auto tag = get_input2<std::string>("tag");
+        // give the other workers a chance to get in between
+        thread_local std::mt19937 rng{std::random_device{}()};
+        std::this_thread::sleep_for(std::chrono::microseconds(rng() % 500));
+        log->value += tag;
+        set_output("log", std::move(log));
+    }
+};
+
+ZENDEFNODE(TestLogAppend, {
+    {"log", {"string", "tag", ""}},
+    {"log"},
+    {},
+    {"debug"},
+});
+
+// never runs ahead, it is left to the serial evaluation
+struct TestLogAppendSerial : TestLogAppend {
+};
+
+ZENDEFNODE(TestLogAppendSerial, {
+    {"log", {"string", "tag", ""}},
+    {"log"},
+    {},
+    {"control"},
+});
+
+struct TestLogMake : INode {
+    void apply() override {
+        set_output("log", std::make_shared<StringObject>());
+    }
+};
+
+ZENDEFNODE(TestLogMake, {
+    {},
+    {"log"},
+    {},
+    {"debug"},
+});
+
+struct TestLogJoin : INode {
+    void apply() override {
+        auto lhs = get_input2<std::string>("lhs");
+        auto rhs = get_input2<std::string>("rhs");
+        set_output("log", std::make_shared<StringObject>(lhs + "|" + rhs));
+    }
+};
+
+ZENDEFNODE(TestLogJoin, {
+    {"lhs", "rhs"},
+    {"log"},
+    {},
+    {"debug"},
+});
+
+struct LogGraph {
+    std::shared_ptr<Graph> graph = getSession().createGraph();
+    std::set<std::string> ids;
+
+    void make(std::string const &id) {
+        graph->addNode("TestLogMake", id);
+        ids.insert(id);
+    }
+
+    void append(std::string const &id, std::string const &src, std::string const &tag, bool serial = false) {
+        graph->addNode(serial ? "TestLogAppendSerial" : "TestLogAppend", id);
+        graph->bindNodeInput(id, "log", src, "log");
+        graph->setNodeInput(id, "tag", std::make_shared<StringObject>(tag));
+        ids.insert(id);
+    }
+
+    void join(std::string const &id, std::string const &lhs, std::string const &rhs) {
+        graph->addNode("TestLogJoin", id);
+        graph->bindNodeInput(id, "lhs", lhs, "log");
+        graph->bindNodeInput(id, "rhs", rhs, "log");
+        ids.insert(id);
+    }
+
+    std::string result(std::string const &id) const {
+        return safe_dynamic_cast<StringObject>(graph->getNodeOutput(id, "log"))->get();
+    }
+};
+
+// two logs, each written in place by fan-out consumers, by chains passing the
+// log on, and by serial nodes in between; the joins read them at the end
+LogGraph buildLogGraph() {
+    LogGraph g;
+    g.make("m1");
+    g.make("m2");
+    for (int i = 0; i < 8; i++)
+        g.append("a" + std::to_string(i), "m1", std::string(1, 'a' + i));
+    g.append("b0", "a3", "B");
+    g.append("b1", "b0", "C");
+    g.append("s0", "a5", "S", true);
+    g.append("s1", "m1", "T", true);
+    g.append("s2", "s1", "U");
+    for (int i = 0; i < 6; i++)
+        g.append("c" + std::to_string(i), "m2", std::to_string(i));
+    g.append("d0", "c2", "D");
+    g.join("j0", "b1", "c5");
+    g.join("j1", "d0", "s2");
+    return g;
+}
+
+std::vector<std::string> runLogGraph(bool parallel) {
+    if (parallel)
+        setenv("ZENO_PARALLEL_GRAPH", "1", 1);
+    else
+        unsetenv("ZENO_PARALLEL_GRAPH");
+    auto g = buildLogGraph();
+    g.graph->applyNodes(g.ids);
+    return {g.result("m1"), g.result("m2"), g.result("j0"), g.result("j1")};
+}
+
+}
+
+TEST_CASE("parallel scheduler keeps the serial order of nodes sharing an object", "[Graph]")
+{
+    // more threads than cores, so that nodes really overlap
+    setenv("ZENO_NUM_THREADS", "4", 1);
+
+    auto serial = runLogGraph(false);
+    // every writer got the log, in the depth-first order of applyNodes
+    REQUIRE(serial[0].size() == 13);
+    REQUIRE(serial[1].size() == 7);
+
+    for (int run = 0; run < 50; run++) {
+        INFO("run " << run);
+        REQUIRE(runLogGraph(true) == serial);
+    }
+}
@@ -0,0 +1,94 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/types/PrimitiveObject.h>
+#include <zeno/funcs/PrimitiveUtils.h>
+#include <cstdint>
+#include <vector>
+
+using namespace zeno;
+
+// O(n^2) reference: clusters of the "closer than distance" graph, numbered in
+// the order of their lowest point index, the same as primMarkClose
+static int bruteForceMarkClose(std::vector<vec3f> const &pos, float distance, std::vector<int> &tag)
+{
+    int n = pos.size();
+    std::vector<int> parent(n);
+    for (int i = 0; i < n; i++)
+        parent[i] = i;
+    auto find = [&] (int i) {
+        while (i != parent[i])
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            if (lengthSquared(pos[i] - pos[j]) <= distance * distance) {
+                int a = find(i), b = find(j);
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+    tag.assign(n, 0);
+    int cnt = 0;
+    for (int i = 0; i < n; i++)
+        tag[i] = find(i) == i ? cnt++ : tag[find(i)];
+    return cnt;
+}
+
+static void checkAgainstBruteForce(std::vector<vec3f> const &pos, float distance)
+{
+    auto prim = std::make_shared<PrimitiveObject>();
+    prim->verts.values = pos;
+    int cnt = primMarkClose(prim.get(), "weld", distance);
+
+    std::vector<int> refTag;
+    int refCnt = bruteForceMarkClose(pos, distance, refTag);
+    REQUIRE(cnt == refCnt);
+    REQUIRE(prim->verts.attr<int>("weld") == refTag);
+}
+
+// fixed pseudo random points, the same on every platform
+static std::vector<vec3f> randomPoints(int n, vec3f scale, uint32_t seed)
+{
+    auto next = [&] {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) * (1.f / (1 << 24));
+    };
+    std::vector<vec3f> pos(n);
+    for (auto &p: pos)
+        p = vec3f(next(), next(), next()) * scale;
+    return pos;
+}
+
+TEST_CASE("test_PrimMarkClose_empty", "[primMarkClose]")
+{
+    auto prim = std::make_shared<PrimitiveObject>();
+    REQUIRE(primMarkClose(prim.get(), "weld", 0.1f) == 0);
+    REQUIRE(prim->verts.has_attr("weld"));
+}
+
+TEST_CASE("test_PrimMarkClose_duplicates", "[primMarkClose]")
+{
+    std::vector<vec3f> pos(100, vec3f(1, 2, 3));
+    checkAgainstBruteForce(pos, 0.f);
+    checkAgainstBruteForce(pos, 0.5f);
+}
+
+TEST_CASE("test_PrimMarkClose_chain", "[primMarkClose]")
+{
+    // a chain spans many cells, so clusters must be joined across them
+    std::vector<vec3f> pos;
+    for (int i = 0; i < 200; i++)
+        pos.push_back(vec3f(i * 0.9f, 0, 0));
+    checkAgainstBruteForce(pos, 1.f);
+    checkAgainstBruteForce(pos, 0.8f);
+    // exactly at the distance is close
+    checkAgainstBruteForce(pos, 0.9f);
+}
+
+TEST_CASE("test_PrimMarkClose_random", "[primMarkClose]")
+{
+    checkAgainstBruteForce(randomPoints(2000, vec3f(1, 1, 1), 1), 0.03f);
+    checkAgainstBruteForce(randomPoints(2000, vec3f(1, 1, 1), 2), 0.08f);
+    // flat cloud with a large extent against the distance
+    checkAgainstBruteForce(randomPoints(3000, vec3f(100, 0.01f, 100), 3), 1.5f);
+}
@@ -0,0 +1,74 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/para/thread_pool.h>
+#include <zeno/para/parallel_for.h>
+#include <zeno/para/parallel_reduce.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+using namespace zeno;
+
+namespace {
+
+// more threads than cores, must be set before the pool is first used
+const bool threadsSet = [] {
+    setenv("ZENO_NUM_THREADS", "4", 1);
+    return true;
+}();
+
+// every level waits for its own forks while other threads fork more of them
+long forkSum(int depth) {
+    if (!depth)
+        return 1;
+    std::atomic<long> sum{0};
+    fork_join fj;
+    fj.run_and_join([&] {
+        for (int i = 0; i < 3; i++)
+            fj.fork([&] { sum += forkSum(depth - 1); });
+    });
+    return sum;
+}
+
+}
+
+TEST_CASE("nested fork_join waits for every fork", "[para]")
+{
+    REQUIRE(thread_pool::concurrency() == 4);
+    for (int run = 0; run < 20; run++) {
+        REQUIRE(forkSum(6) == 729);
+    }
+}
+
+TEST_CASE("fork_join rethrows the first exception", "[para]")
+{
+    fork_join fj;
+    std::atomic<int> ran{0};
+    REQUIRE_THROWS_AS(fj.run_and_join([&] {
+        for (int i = 0; i < 16; i++)
+            fj.fork([&, i] {
+                ++ran;
+                if (i == 5)
+                    throw std::runtime_error("fork failed");
+            });
+    }), std::runtime_error);
+    REQUIRE(ran == 16);
+}
+
+TEST_CASE("parallel_for and parallel_reduce cover the range once", "[para]")
+{
+    std::vector<int> hits(100000);
+    parallel_for((std::size_t)0, hits.size(), [&] (std::size_t i) {
+        hits[i]++;
+    });
+    REQUIRE(std::count(hits.begin(), hits.end(), 1) == (long)hits.size());
+
+    auto sum = parallel_reduce((std::size_t)0, hits.size(), 0L, [] (long a, long b) {
+        return a + b;
+    }, [&] (std::size_t i) {
+        return (long)i;
+    });
+    REQUIRE(sum == (long)hits.size() * ((long)hits.size() - 1) / 2);
+}
@@ -0,0 +1,209 @@
+#define CATCH_CONFIG_MAIN
+#include "Catch2.hpp"
+
+#include <zeno/utils/triangulate.h>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <vector>
+
+using namespace zeno;
+
+namespace {
+
+// twice the signed area in the xy plane
+double area2(vec3f const &a, vec3f const &b, vec3f const &c) {
+    return (double)(b[0] - a[0]) * (c[1] - a[1]) - (double)(b[1] - a[1]) * (c[0] - a[0]);
+}
+
+double loopArea2(std::vector<vec3f> const &pos, std::vector<int> const &loop) {
+    double sum = 0;
+    for (size_t i = 0; i < loop.size(); i++) {
+        auto const &p = pos[loop[i]];
+        auto const &q = pos[loop[(i + 1) % loop.size()]];
+        sum += (double)p[0] * q[1] - (double)q[0] * p[1];
+    }
+    return sum;
+}
+
+bool insideLoop(std::vector<vec3f> const &pos, std::vector<int> const &loop, double x, double y) {
+    bool in = false;
+    for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++) {
+        auto const &a = pos[loop[i]];
+        auto const &b = pos[loop[j]];
+        if ((a[1] > y) != (b[1] > y) && x < (b[0] - a[0]) * (y - a[1]) / (b[1] - a[1]) + a[0])
+            in = !in;
+    }
+    return in;
+}
+
+std::vector<int> iota(int n, int first = 0) {
+    std::vector<int> loop(n);
+    std::iota(loop.begin(), loop.end(), first);
+    return loop;
+}
+
+std::vector<vec3i> triangulate(std::vector<vec3f> &pos, std::vector<int> &loop) {
+    std::vector<vec3i> tris;
+    polygonDecompose(pos, loop, tris);
+    REQUIRE(tris.size() == loop.size() - 2);
+    std::set<int> corners(loop.begin(), loop.end());
+    for (auto const &tri: tris) {
+        for (int k = 0; k < 3; k++)
+            REQUIRE(corners.count(tri[k]));
+    }
+    return tris;
+}
+
+// for simple loops: the triangles tile the loop, all wound like it and inside it
+void requireTiles(std::vector<vec3f> &pos, std::vector<int> &loop) {
+    auto tris = triangulate(pos, loop);
+    double total = loopArea2(pos, loop);
+    double sum = 0;
+    for (auto const &tri: tris) {
+        double a = area2(pos[tri[0]], pos[tri[1]], pos[tri[2]]);
+        REQUIRE(a * total >= 0);
+        sum += a;
+        double cx = (pos[tri[0]][0] + pos[tri[1]][0] + pos[tri[2]][0]) / 3.0;
+        double cy = (pos[tri[0]][1] + pos[tri[1]][1] + pos[tri[2]][1]) / 3.0;
+        if (a != 0)
+            REQUIRE(insideLoop(pos, loop, cx, cy));
+    }
+    REQUIRE(std::abs(sum - total) <= 1e-4 * std::abs(total));
+}
+
+}
+
+TEST_CASE("convex loops are fanned", "[triangulate]")
+{
+    std::vector<vec3f> pos;
+    for (int i = 0; i < 6; i++)
+        pos.emplace_back(std::cos(i * 1.0472f), std::sin(i * 1.0472f), 0);
+    auto loop = iota(6);
+    requireTiles(pos, loop);
+    // indices are the vertex indices, not loop corners
+    std::vector<vec3f> shifted(10);
+    shifted.insert(shifted.end(), pos.begin(), pos.end());
+    auto shiftedLoop = iota(6, 10);
+    requireTiles(shifted, shiftedLoop);
+}
+
+TEST_CASE("concave loops stay inside", "[triangulate]")
+{
+    SECTION("L shape") {
+        std::vector<vec3f> pos{{0, 0, 0}, {2, 0, 0}, {2, 1, 0}, {1, 1, 0}, {1, 2, 0}, {0, 2, 0}};
+        auto loop = iota(6);
+        requireTiles(pos, loop);
+    }
+    SECTION("star, clockwise") {
+        std::vector<vec3f> pos;
+        for (int i = 0; i < 10; i++) {
+            float r = i % 2 ? 0.4f : 1.0f;
+            float t = -i * 0.6283185f;
+            pos.emplace_back(r * std::cos(t), r * std::sin(t), 0);
+        }
+        auto loop = iota(10);
+        requireTiles(pos, loop);
+    }
+    SECTION("comb with many reflex vertices") {
+        std::vector<vec3f> pos;
+        int teeth = 50;
+        for (int i = 0; i < teeth; i++) {
+            pos.emplace_back(i * 2, 0, 0);
+            pos.emplace_back(i * 2 + 1, 5, 0);
+        }
+        pos.emplace_back(teeth * 2, 0, 0);
+        pos.emplace_back(teeth * 2, -1, 0);
+        pos.emplace_back(0, -1, 0);
+        std::vector<int> loop(pos.size());
+        // wound clockwise, and stored in reverse
+        for (size_t i = 0; i < pos.size(); i++)
+            loop[i] = pos.size() - 1 - i;
+        requireTiles(pos, loop);
+    }
+    SECTION("not in the xy plane") {
+        std::vector<vec3f> flat{{0, 0, 0}, {2, 0, 0}, {2, 1, 0}, {1, 1, 0}, {1, 2, 0}, {0, 2, 0}};
+        std::vector<vec3f> pos;
+        for (auto const &p: flat)
+            pos.emplace_back(p[0], 3, p[1]);
+        auto loop = iota(6);
+        auto tris = triangulate(pos, loop);
+        // same triangles as the loop in the xy plane, up to winding
+        auto ref = triangulate(flat, loop);
+        double sum = 0;
+        for (auto const &tri: tris)
+            sum += std::abs(area2(flat[tri[0]], flat[tri[1]], flat[tri[2]]));
+        REQUIRE(std::abs(sum - std::abs(loopArea2(flat, loop))) < 1e-4);
+        REQUIRE(ref.size() == tris.size());
+    }
+}
+
+TEST_CASE("collinear corners give n - 2 triangles", "[triangulate]")
+{
+    SECTION("points along the edges") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0}, {3, 1, 0},
+                               {3, 2, 0}, {2, 2, 0}, {1, 2, 0}, {0, 2, 0}, {0, 1, 0}};
+        auto loop = iota(10);
+        requireTiles(pos, loop);
+    }
+    SECTION("all on one line") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 1, 0}, {2, 2, 0}, {3, 3, 0}, {1.5f, 1.5f, 0}};
+        auto loop = iota(5);
+        auto tris = triangulate(pos, loop);
+        for (auto const &tri: tris)
+            REQUIRE(area2(pos[tri[0]], pos[tri[1]], pos[tri[2]]) == 0);
+    }
+}
+
+TEST_CASE("degenerate loops give n - 2 triangles", "[triangulate]")
+{
+    SECTION("fewer than three corners") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 0, 0}};
+        std::vector<vec3i> tris{{0, 1, 0}};
+        auto loop = iota(2);
+        polygonDecompose(pos, loop, tris);
+        REQUIRE(tris.empty());
+    }
+    SECTION("repeated points") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 0}};
+        auto loop = iota(7);
+        requireTiles(pos, loop);
+    }
+    SECTION("the same vertex twice") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+        std::vector<int> loop{0, 1, 2, 2, 3};
+        triangulate(pos, loop);
+    }
+    SECTION("all points equal") {
+        std::vector<vec3f> pos(6, vec3f(1, 2, 3));
+        auto loop = iota(6);
+        triangulate(pos, loop);
+    }
+    SECTION("self intersecting bow tie") {
+        std::vector<vec3f> pos{{0, 0, 0}, {1, 1, 0}, {1, 0, 0}, {0, 1, 0}};
+        auto loop = iota(4);
+        triangulate(pos, loop);
+    }
+}
+
+TEST_CASE("holes are bridged into the outer loop", "[triangulate]")
+{
+    std::vector<vec3f> pos{{0, 0, 0}, {4, 0, 0}, {4, 4, 0}, {0, 4, 0},
+                           {1, 1, 0}, {1, 3, 0}, {3, 3, 0}, {3, 1, 0}};
+    std::vector<int> outer{0, 1, 2, 3};
+    std::vector<std::vector<int>> holes{{4, 5, 6, 7}};
+    std::vector<vec3i> tris;
+    PolygonTriangulator().triangulate(pos.data(), outer, holes, tris);
+    // 8 corners and 2 bridge edges: 8 triangles covering 16 - 4
+    REQUIRE(tris.size() == 8);
+    double sum = 0;
+    for (auto const &tri: tris) {
+        double a = area2(pos[tri[0]], pos[tri[1]], pos[tri[2]]);
+        REQUIRE(a >= 0);
+        sum += a;
+        double cx = (pos[tri[0]][0] + pos[tri[1]][0] + pos[tri[2]][0]) / 3.0;
+        double cy = (pos[tri[0]][1] + pos[tri[1]][1] + pos[tri[2]][1]) / 3.0;
+        REQUIRE(!(cx > 1 && cx < 3 && cy > 1 && cy < 3));
+    }
+    REQUIRE(std::abs(sum - 24) < 1e-4);
+}